@@ -0,0 +1,808 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/math.h>
+#include <turboq/detail/memory.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+namespace detail {
+
+/// Delayed queue detail
+/// Layout: MemoryHeader, WheelHeader, arrivals ring, message slots (same as MPSC queue).
+/// Producers take a free slot, write the message and publish slot index to the
+/// arrivals ring. Consumer links arrived slots into a hierarchical timer wheel
+/// and returns the slots to the free list once delivered.
+template <typename Traits>
+struct BoundedDelayedRawQueueDetail {
+  /// Queue tag
+  static constexpr std::string_view kTag = Traits::kTag;
+  /// Segment size
+  static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
+  /// Alignment
+  static constexpr std::size_t kAlign = Traits::kAlign;
+
+  /// Timer wheel levels
+  static constexpr std::size_t kLevels = 4;
+  /// Bits of tick per level
+  static constexpr std::size_t kLevelBits = 6;
+  /// Buckets per level
+  static constexpr std::size_t kBuckets = std::size_t(1) << kLevelBits;
+
+  /// Null slot index
+  static constexpr std::uint32_t kNil = 0;
+
+  /// Control struct for queue buffer
+  struct MemoryHeader {
+    /// Placeholder for queue tag
+    char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
+    /// Max message size
+    std::size_t maxMessageSize;
+    /// Queue length (slots count)
+    std::size_t length;
+    /// Timer wheel tick in nanoseconds
+    std::uint64_t tick;
+    /// Free slots stack head: ABA tag in high half, slot index + 1 in low half
+    alignas(kAlign) std::uint64_t freeHead;
+    /// Arrivals producer position
+    alignas(kAlign) std::size_t arrivalsProducerPos;
+
+    static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Intrusive FIFO list of slots
+  struct List {
+    std::uint32_t head;
+    std::uint32_t tail;
+  };
+
+  /// Timer wheel, owned by consumer
+  struct WheelHeader {
+    /// Next tick to expire
+    alignas(kAlign) std::uint64_t currentTick;
+    /// Arrivals consumer position
+    std::size_t arrivalsConsumerPos;
+    /// Non empty buckets bitmap per level
+    std::array<std::uint64_t, kLevels> occupied;
+    /// Buckets
+    std::array<std::array<List, kBuckets>, kLevels> buckets;
+    /// Messages beyond the last level
+    List overflow;
+    /// Expired messages
+    List ready;
+  };
+  static_assert(std::is_trivially_copyable_v<WheelHeader>);
+
+  /// Control struct for message
+  struct MessageHeader {
+    /// Deliver time (steady clock, nanoseconds)
+    std::int64_t deliverAt;
+    /// Payload size
+    std::size_t payloadSize;
+    /// Next slot in free stack or wheel list
+    std::uint32_t next;
+  };
+  static_assert(std::is_trivially_copyable_v<MessageHeader>);
+
+  /// Align message buffer size
+  static constexpr std::size_t alignBufferSize(std::size_t value) noexcept {
+    return detail::align_up(value, kSegmentSize);
+  }
+
+  /// Offset for the wheel from memory buffer start
+  static constexpr std::size_t kWheelStartPos = alignBufferSize(sizeof(MemoryHeader));
+  /// Offset for the arrivals ring from memory buffer start
+  static constexpr std::size_t kArrivalsStartPos = kWheelStartPos + alignBufferSize(sizeof(WheelHeader));
+
+  /// Offset for the first message slot from memory buffer start
+  static constexpr std::size_t dataStartPos(std::size_t length) noexcept {
+    return kArrivalsStartPos + alignBufferSize(sizeof(std::uint64_t) * length);
+  }
+
+  /// Size of memory buffer required for the queue
+  static constexpr std::size_t bufferSize(std::size_t maxMessageSize, std::size_t length) noexcept {
+    return dataStartPos(length) + maxMessageSize * length;
+  }
+
+  /// Check buffer points to valid delayed queue region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept {
+    if (buffer.size() < kArrivalsStartPos) {
+      return false;
+    }
+    auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+    if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+      return false;
+    }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
+    if (header->maxMessageSize == 0 || !std::has_single_bit(header->length) || header->tick == 0) {
+      return false;
+    }
+    return bufferSize(header->maxMessageSize, header->length) <= buffer.size();
+  }
+
+  /// Init queue memory, all slots are free
+  static void init(
+      std::span<std::byte> buffer, std::size_t maxMessageSize, std::size_t length, std::uint64_t tick) noexcept {
+    auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+    std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
+    header->maxMessageSize = maxMessageSize;
+    header->length = length;
+    header->tick = tick;
+    header->arrivalsProducerPos = 0;
+
+    auto wheel = std::bit_cast<WheelHeader*>(buffer.data() + kWheelStartPos);
+    *wheel = WheelHeader{};
+    wheel->currentTick = now() / tick;
+
+    std::fill_n(std::bit_cast<std::uint64_t*>(buffer.data() + kArrivalsStartPos), length, 0);
+
+    for (std::uint32_t index = 1; index <= length; ++index) {
+      message(buffer.data() + dataStartPos(length), maxMessageSize, index)->next =
+          (index < length) ? index + 1 : kNil;
+    }
+    header->freeHead = 1;
+  }
+
+  /// Return message header for slot index
+  [[nodiscard]] static TURBOQ_FORCE_INLINE MessageHeader* message(
+      std::byte* data, std::size_t maxMessageSize, std::uint32_t index) noexcept {
+    assert(index != kNil);
+    return std::bit_cast<MessageHeader*>(data + (index - 1) * maxMessageSize);
+  }
+
+  /// Return steady clock time in nanoseconds
+  [[nodiscard]] static TURBOQ_FORCE_INLINE std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// Push slot to free stack (any process)
+  static TURBOQ_FORCE_INLINE void pushFree(
+      MemoryHeader* header, std::byte* data, std::uint32_t index) noexcept {
+    auto const slot = message(data, header->maxMessageSize, index);
+    std::uint64_t head = std::atomic_ref(header->freeHead).load(std::memory_order_relaxed);
+    do {
+      std::atomic_ref(slot->next).store(std::uint32_t(head), std::memory_order_relaxed);
+    } while (!std::atomic_ref(header->freeHead)
+                  .compare_exchange_weak(head, ((head >> 32) + 1) << 32 | index, std::memory_order_release,
+                      std::memory_order_relaxed));
+  }
+
+  /// Pop slot from free stack. Return kNil in case of no free slots.
+  [[nodiscard]] static TURBOQ_FORCE_INLINE std::uint32_t popFree(MemoryHeader* header, std::byte* data) noexcept {
+    std::uint64_t head = std::atomic_ref(header->freeHead).load(std::memory_order_acquire);
+    for (;;) {
+      auto const index = std::uint32_t(head);
+      if (index == kNil) {
+        return kNil;
+      }
+      // next could be stale in case of the slot was taken meanwhile, tag makes CAS fail then
+      auto const next = std::atomic_ref(message(data, header->maxMessageSize, index)->next)
+                            .load(std::memory_order_relaxed);
+      if (std::atomic_ref(header->freeHead)
+              .compare_exchange_weak(
+                  head, ((head >> 32) + 1) << 32 | next, std::memory_order_acquire, std::memory_order_acquire)) {
+        return index;
+      }
+    }
+  }
+};
+
+/// Delayed queue producer
+template <typename Traits>
+class BoundedDelayedRawQueueProducer {
+private:
+  using QueueDetail = BoundedDelayedRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  std::uint64_t* arrivals_ = nullptr;
+  std::byte* data_ = nullptr;
+  std::uint32_t lastIndex_ = QueueDetail::kNil;
+  MessageHeader* lastMessageHeader_ = nullptr;
+
+public:
+  BoundedDelayedRawQueueProducer() = default;
+  ~BoundedDelayedRawQueueProducer() = default;
+
+  BoundedDelayedRawQueueProducer(BoundedDelayedRawQueueProducer&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedDelayedRawQueueProducer& operator=(BoundedDelayedRawQueueProducer&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedDelayedRawQueueProducer(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    arrivals_ = std::bit_cast<std::uint64_t*>(storage_.data() + QueueDetail::kArrivalsStartPos);
+    data_ = storage_.data() + QueueDetail::dataStartPos(header_->length);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Reserve message slot for writing. Return empty buffer in case of no free slots.
+  /// \throw std::system_error in case of requested size greater max message size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::size_t size) {
+    return valueOrThrow(tryPrepare(size));
+  }
+
+  /// \see prepare. Return Error::MessageTooLarge in case of requested size greater
+  /// max message size.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<std::span<std::byte>> tryPrepare(std::size_t size) noexcept {
+    if (size + sizeof(MessageHeader) > header_->maxMessageSize) [[unlikely]] {
+      return makeErrorCode(Error::MessageTooLarge);
+    }
+
+    lastIndex_ = QueueDetail::popFree(header_, data_);
+    if (lastIndex_ == QueueDetail::kNil) [[unlikely]] {
+      return std::span<std::byte>();
+    }
+
+    lastMessageHeader_ = QueueDetail::message(data_, header_->maxMessageSize, lastIndex_);
+    lastMessageHeader_->payloadSize = size;
+
+    return std::span<std::byte>(std::bit_cast<std::byte*>(lastMessageHeader_ + 1), size);
+  }
+
+  /// Schedule reserved message for delivery at deliverAt
+  TURBOQ_FORCE_INLINE void commit(std::chrono::steady_clock::time_point deliverAt) noexcept {
+    lastMessageHeader_->deliverAt =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deliverAt.time_since_epoch()).count();
+
+    // arrivals ring never overflows: it has a position for every slot, entry
+    // keeps the low 32 bits of the lap
+    std::size_t const length = header_->length;
+    std::size_t const pos = std::atomic_ref(header_->arrivalsProducerPos).fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t const lap = std::uint32_t(pos / length + 1);
+    std::atomic_ref(arrivals_[pos & (length - 1)]).store(lap << 32 | lastIndex_, std::memory_order_release);
+  }
+
+  /// \overload
+  TURBOQ_FORCE_INLINE void commit(std::chrono::steady_clock::time_point deliverAt, std::size_t size) noexcept {
+    if (size <= lastMessageHeader_->payloadSize) [[likely]] {
+      lastMessageHeader_->payloadSize = size;
+    } else {
+      assert(false);
+    }
+    commit(deliverAt);
+  }
+
+  /// Schedule reserved message for immediate delivery
+  TURBOQ_FORCE_INLINE void commit() noexcept {
+    commit(std::chrono::steady_clock::time_point());
+  }
+
+  /// \overload
+  TURBOQ_FORCE_INLINE void commit(std::size_t size) noexcept {
+    commit(std::chrono::steady_clock::time_point(), size);
+  }
+
+  /// Release reserved slot
+  /// pre: prepare() -> non empty buffer, not committed
+  TURBOQ_FORCE_INLINE void abort() noexcept {
+    QueueDetail::pushFree(header_, data_, lastIndex_);
+  }
+
+  /// Swap resources with other producer
+  void swap(BoundedDelayedRawQueueProducer& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(arrivals_, that.arrivals_);
+    swap(data_, that.data_);
+    swap(lastIndex_, that.lastIndex_);
+    swap(lastMessageHeader_, that.lastMessageHeader_);
+  }
+
+  /// \see BoundedDelayedRawQueueProducer::swap
+  friend void swap(BoundedDelayedRawQueueProducer& a, BoundedDelayedRawQueueProducer& b) noexcept {
+    a.swap(b);
+  }
+};
+
+/// Delayed queue consumer
+template <typename Traits>
+class BoundedDelayedRawQueueConsumer {
+private:
+  using QueueDetail = BoundedDelayedRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using WheelHeader = typename QueueDetail::WheelHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+  using List = typename QueueDetail::List;
+
+  static constexpr std::size_t kLevels = QueueDetail::kLevels;
+  static constexpr std::size_t kLevelBits = QueueDetail::kLevelBits;
+  static constexpr std::uint64_t kBucketMask = QueueDetail::kBuckets - 1;
+  static constexpr std::uint32_t kNil = QueueDetail::kNil;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  WheelHeader* wheel_ = nullptr;
+  std::uint64_t* arrivals_ = nullptr;
+  std::byte* data_ = nullptr;
+
+public:
+  BoundedDelayedRawQueueConsumer() = default;
+  ~BoundedDelayedRawQueueConsumer() = default;
+
+  BoundedDelayedRawQueueConsumer(BoundedDelayedRawQueueConsumer&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedDelayedRawQueueConsumer& operator=(BoundedDelayedRawQueueConsumer&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedDelayedRawQueueConsumer(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    wheel_ = std::bit_cast<WheelHeader*>(storage_.data() + QueueDetail::kWheelStartPos);
+    arrivals_ = std::bit_cast<std::uint64_t*>(storage_.data() + QueueDetail::kArrivalsStartPos);
+    data_ = storage_.data() + QueueDetail::dataStartPos(header_->length);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Get next message which deliver time has arrived. Return empty buffer in case of no data.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
+    return fetch(std::chrono::steady_clock::now());
+  }
+
+  /// \overload
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch(
+      std::chrono::steady_clock::time_point now) noexcept {
+    if (wheel_->ready.head == kNil) {
+      collectArrivals();
+      advance(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()) /
+              header_->tick);
+      if (wheel_->ready.head == kNil) {
+        return {};
+      }
+    }
+    auto const message = slot(wheel_->ready.head);
+    return {std::bit_cast<std::byte const*>(message + 1), message->payloadSize};
+  }
+
+  /// Consume front buffer and return its slot to producers
+  /// pre: fetch() -> non empty buffer
+  TURBOQ_FORCE_INLINE void consume() noexcept {
+    std::uint32_t const index = popFront(wheel_->ready);
+    QueueDetail::pushFree(header_, data_, index);
+  }
+
+  /// Drop all ready and pending messages
+  void reset() noexcept {
+    collectArrivals();
+    auto release = [this](List& list) {
+      while (list.head != kNil) {
+        QueueDetail::pushFree(header_, data_, popFront(list));
+      }
+    };
+    for (std::size_t level = 0; level < kLevels; ++level) {
+      for (auto& bucket : wheel_->buckets[level]) {
+        release(bucket);
+      }
+      wheel_->occupied[level] = 0;
+    }
+    release(wheel_->overflow);
+    release(wheel_->ready);
+  }
+
+  /// Swap resources with other object
+  void swap(BoundedDelayedRawQueueConsumer& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(wheel_, that.wheel_);
+    swap(arrivals_, that.arrivals_);
+    swap(data_, that.data_);
+  }
+
+  /// \see BoundedDelayedRawQueueConsumer::swap
+  friend void swap(BoundedDelayedRawQueueConsumer& a, BoundedDelayedRawQueueConsumer& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  [[nodiscard]] TURBOQ_FORCE_INLINE MessageHeader* slot(std::uint32_t index) noexcept {
+    return QueueDetail::message(data_, header_->maxMessageSize, index);
+  }
+
+  /// Link slot after prev, stale free stack readers could race on the field
+  TURBOQ_FORCE_INLINE void link(std::uint32_t prev, std::uint32_t index) noexcept {
+    std::atomic_ref(slot(prev)->next).store(index, std::memory_order_relaxed);
+  }
+
+  TURBOQ_FORCE_INLINE void pushBack(List& list, std::uint32_t index) noexcept {
+    link(index, kNil);
+    if (list.tail == kNil) {
+      list.head = index;
+    } else {
+      link(list.tail, index);
+    }
+    list.tail = index;
+  }
+
+  TURBOQ_FORCE_INLINE std::uint32_t popFront(List& list) noexcept {
+    std::uint32_t const index = list.head;
+    list.head = slot(index)->next;
+    if (list.head == kNil) {
+      list.tail = kNil;
+    }
+    return index;
+  }
+
+  /// Append all messages of the list to the ready list
+  TURBOQ_FORCE_INLINE void splice(List& list) noexcept {
+    if (wheel_->ready.tail == kNil) {
+      wheel_->ready.head = list.head;
+    } else {
+      link(wheel_->ready.tail, list.head);
+    }
+    wheel_->ready.tail = list.tail;
+    list = List{};
+  }
+
+  /// Link message into the wheel: level is the highest 6-bit tick group
+  /// differing from the current tick
+  TURBOQ_FORCE_INLINE void schedule(std::uint32_t index) noexcept {
+    auto const deliverAt = slot(index)->deliverAt;
+    std::uint64_t const tick = deliverAt > 0 ? std::uint64_t(deliverAt) / header_->tick : 0;
+    if (tick < wheel_->currentTick) {
+      pushBack(wheel_->ready, index);
+      return;
+    }
+    std::uint64_t const diff = tick ^ wheel_->currentTick;
+    std::size_t const level = diff == 0 ? 0 : (63 - std::countl_zero(diff)) / kLevelBits;
+    if (level >= kLevels) {
+      pushBack(wheel_->overflow, index);
+      return;
+    }
+    std::size_t const bucket = (tick >> (level * kLevelBits)) & kBucketMask;
+    pushBack(wheel_->buckets[level][bucket], index);
+    wheel_->occupied[level] |= std::uint64_t(1) << bucket;
+  }
+
+  /// Move messages published by producers into the wheel
+  TURBOQ_FORCE_INLINE void collectArrivals() noexcept {
+    std::size_t const length = header_->length;
+    for (;;) {
+      std::size_t const pos = wheel_->arrivalsConsumerPos;
+      std::uint64_t const entry = std::atomic_ref(arrivals_[pos & (length - 1)]).load(std::memory_order_acquire);
+      // lap is truncated to 32 bits by the producer
+      if (std::uint32_t(entry >> 32) != std::uint32_t(pos / length + 1)) {
+        return;
+      }
+      wheel_->arrivalsConsumerPos = pos + 1;
+      schedule(std::uint32_t(entry));
+    }
+  }
+
+  /// Re-link messages of higher level buckets reached by the current tick
+  void cascade() noexcept {
+    for (std::size_t level = 1; level < kLevels; ++level) {
+      std::size_t const bucket = (wheel_->currentTick >> (level * kLevelBits)) & kBucketMask;
+      List list = std::exchange(wheel_->buckets[level][bucket], List{});
+      wheel_->occupied[level] &= ~(std::uint64_t(1) << bucket);
+      while (list.head != kNil) {
+        schedule(popFront(list));
+      }
+      if (bucket != 0) {
+        return;
+      }
+    }
+    List list = std::exchange(wheel_->overflow, List{});
+    while (list.head != kNil) {
+      schedule(popFront(list));
+    }
+  }
+
+  /// Return the next tick at which a bucket expires or cascades
+  [[nodiscard]] std::uint64_t nextEvent(std::uint64_t tick) const noexcept {
+    for (std::size_t level = 0; level < kLevels; ++level) {
+      std::size_t const shift = level * kLevelBits;
+      std::size_t const bucket = (tick >> shift) & kBucketMask;
+      // occupied buckets of a level are always ahead of the current one
+      std::uint64_t const rest =
+          (bucket == kBucketMask) ? 0 : wheel_->occupied[level] & (~std::uint64_t(0) << (bucket + 1));
+      if (rest) {
+        return (tick >> (shift + kLevelBits) << (shift + kLevelBits)) | std::uint64_t(std::countr_zero(rest)) << shift;
+      }
+    }
+    // overflow list is re-linked when the last level wraps
+    return ((tick >> (kLevels * kLevelBits)) + 1) << (kLevels * kLevelBits);
+  }
+
+  /// Expire ticks up to nowTick inclusive
+  void advance(std::uint64_t nowTick) noexcept {
+    auto& currentTick = wheel_->currentTick;
+    while (currentTick <= nowTick) {
+      bool const empty = wheel_->overflow.head == kNil &&
+                         std::all_of(wheel_->occupied.begin(), wheel_->occupied.end(), [](auto bits) {
+                           return bits == 0;
+                         });
+      if (empty) {
+        currentTick = nowTick + 1;
+        return;
+      }
+
+      std::size_t const bucket = currentTick & kBucketMask;
+      if (wheel_->occupied[0] & (std::uint64_t(1) << bucket)) {
+        splice(wheel_->buckets[0][bucket]);
+        wheel_->occupied[0] &= ~(std::uint64_t(1) << bucket);
+      }
+
+      // skip empty ticks and rotations
+      currentTick = std::min(nextEvent(currentTick), nowTick + 1);
+      if ((currentTick & kBucketMask) == 0) {
+        cascade();
+      }
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename Traits>
+class BoundedDelayedRawQueueImpl;
+
+struct BoundedDelayedRawQueueDefaultTraits {
+  static constexpr std::string_view kTag = "turboq/Delayed";
+  static constexpr std::size_t kSegmentSize = kHardwareDestructiveInterferenceSize;
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+};
+
+/// Delayed-delivery queue: producers commit messages with deliver time, consumer
+/// fetches only messages which time has arrived.
+using BoundedDelayedRawQueue = BoundedDelayedRawQueueImpl<BoundedDelayedRawQueueDefaultTraits>;
+
+template <typename Traits>
+class BoundedDelayedRawQueueImpl {
+private:
+  using QueueDetail = detail::BoundedDelayedRawQueueDetail<Traits>;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  File file_;
+
+public:
+  using Producer = detail::BoundedDelayedRawQueueProducer<Traits>;
+  using Consumer = detail::BoundedDelayedRawQueueConsumer<Traits>;
+
+  struct CreationOptions {
+    std::size_t maxMessageSizeHint;
+    std::size_t lengthHint;
+    /// Timer wheel tick, deliver time is rounded down to it
+    std::chrono::nanoseconds tick = std::chrono::microseconds(1);
+  };
+
+  BoundedDelayedRawQueueImpl(BoundedDelayedRawQueueImpl const&) = delete;
+  BoundedDelayedRawQueueImpl& operator=(BoundedDelayedRawQueueImpl const&) = delete;
+  BoundedDelayedRawQueueImpl() = default;
+
+  BoundedDelayedRawQueueImpl(BoundedDelayedRawQueueImpl&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedDelayedRawQueueImpl& operator=(BoundedDelayedRawQueueImpl&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only queue. Throws on error.
+  BoundedDelayedRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedDelayedRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedDelayedRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedDelayedRawQueueImpl(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedDelayedRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    auto result = memorySource.open(name, MemorySource::OpenOnly);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedDelayedRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return queue;
+  }
+
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedDelayedRawQueueImpl> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (invalidOption(options)) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
+    }
+    auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedDelayedRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto const maxMessageSize = QueueDetail::alignBufferSize(options.maxMessageSizeHint + sizeof(MessageHeader));
+    auto const length = detail::upper_pow_2(options.lengthHint);
+    // round-up requested size to page size
+    auto const capacity = detail::align_up(QueueDetail::bufferSize(maxMessageSize, length), pageSize);
+
+    // init queue or check queue's options is the same as requested
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+    } else {
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content(), maxMessageSize, length, std::uint64_t(options.tick.count()));
+    }
+    return queue;
+  }
+
+  /// Return true on queue intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create producer for the queue. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Producer(std::move(storage).value());
+  }
+
+  /// Create consumer for the queue. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer() {
+    return valueOrThrow(tryCreateConsumer());
+  }
+
+  /// Create consumer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer() noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto const locked = file_.tryLockNoThrow();
+    if (!locked) {
+      return failure(locked.error());
+    }
+    if (!locked.value()) {
+      return makeErrorCode(Error::ConsumerExists);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Consumer(std::move(storage).value());
+  }
+
+  /// Swap resources with other queue.
+  void swap(BoundedDelayedRawQueueImpl& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+  }
+
+  /// \see BoundedDelayedRawQueueImpl::swap
+  friend void swap(BoundedDelayedRawQueueImpl& a, BoundedDelayedRawQueueImpl& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.maxMessageSizeHint == 0) {
+      return "max message size";
+    }
+    if (options.lengthHint == 0 || options.lengthHint > std::numeric_limits<std::uint32_t>::max() / 2) {
+      return "length";
+    }
+    if (options.tick.count() <= 0) {
+      return "tick";
+    }
+    return nullptr;
+  }
+};
+
+} // namespace turboq
@@ -0,0 +1,201 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "BoundedDelayedRawQueue.h"
+
+namespace turboq::testing {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool enqueue(BoundedDelayedRawQueue::Producer& producer, std::uint64_t value, Clock::time_point deliverAt) {
+  auto buffer = producer.prepare(sizeof(value));
+  if (buffer.empty()) {
+    return false;
+  }
+  std::memcpy(buffer.data(), &value, sizeof(value));
+  producer.commit(deliverAt);
+  return true;
+}
+
+bool dequeue(BoundedDelayedRawQueue::Consumer& consumer, std::uint64_t& value, Clock::time_point now) {
+  auto buffer = consumer.fetch(now);
+  if (buffer.empty()) {
+    return false;
+  }
+  REQUIRE(buffer.size() == sizeof(value));
+  std::memcpy(&value, buffer.data(), sizeof(value));
+  consumer.consume();
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("BoundedDelayedRawQueue: deliver time") {
+  BoundedDelayedRawQueue queue(
+      "test", {sizeof(std::uint64_t), 64, std::chrono::microseconds(1)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  auto const start = Clock::now();
+  REQUIRE(enqueue(producer, 3, start + std::chrono::milliseconds(30)));
+  REQUIRE(enqueue(producer, 1, start + std::chrono::microseconds(10)));
+  REQUIRE(enqueue(producer, 2, start + std::chrono::milliseconds(2)));
+  REQUIRE(enqueue(producer, 0, Clock::time_point()));
+
+  std::uint64_t value = 0;
+  REQUIRE(dequeue(consumer, value, start));
+  REQUIRE(value == 0);
+  REQUIRE_FALSE(dequeue(consumer, value, start));
+
+  REQUIRE(dequeue(consumer, value, start + std::chrono::microseconds(10)));
+  REQUIRE(value == 1);
+  REQUIRE_FALSE(dequeue(consumer, value, start + std::chrono::microseconds(1999)));
+
+  REQUIRE(dequeue(consumer, value, start + std::chrono::milliseconds(2)));
+  REQUIRE(value == 2);
+  REQUIRE_FALSE(dequeue(consumer, value, start + std::chrono::milliseconds(29)));
+
+  REQUIRE(dequeue(consumer, value, start + std::chrono::seconds(1)));
+  REQUIRE(value == 3);
+  REQUIRE_FALSE(dequeue(consumer, value, start + std::chrono::seconds(2)));
+}
+
+TEST_CASE("BoundedDelayedRawQueue: order") {
+  constexpr std::size_t kCount = 1024;
+
+  BoundedDelayedRawQueue queue(
+      "test", {sizeof(std::uint64_t), kCount, std::chrono::microseconds(1)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  // delays cover every wheel level and the overflow list
+  std::mt19937_64 random(42);
+  std::vector<std::uint64_t> delays;
+  for (std::size_t i = 0; i < kCount; ++i) {
+    delays.push_back(random() % (std::uint64_t(1) << (random() % 30)));
+  }
+
+  auto const start = Clock::now();
+  for (std::size_t i = 0; i < kCount; ++i) {
+    REQUIRE(enqueue(producer, i, start + std::chrono::microseconds(delays[i])));
+  }
+  // queue is full
+  REQUIRE(producer.prepare(sizeof(std::uint64_t)).empty());
+
+  // advance time in growing steps, every message delivered at the first step past its deadline
+  std::size_t received = 0;
+  std::int64_t last = -1;
+  for (std::int64_t now = 0; received < kCount; now = now * 2 + 1) {
+    std::uint64_t value = 0;
+    while (dequeue(consumer, value, start + std::chrono::microseconds(now))) {
+      REQUIRE(std::int64_t(delays[value]) <= now);
+      REQUIRE(std::int64_t(delays[value]) > last);
+      received++;
+    }
+    last = now;
+  }
+
+  REQUIRE(!producer.prepare(sizeof(std::uint64_t)).empty());
+}
+
+TEST_CASE("BoundedDelayedRawQueue: abort and reset") {
+  BoundedDelayedRawQueue queue("test", {sizeof(std::uint64_t), 4}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    REQUIRE(!producer.prepare(sizeof(std::uint64_t)).empty());
+    producer.abort();
+  }
+
+  auto const start = Clock::now();
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    REQUIRE(enqueue(producer, i, start + std::chrono::hours(i)));
+  }
+  REQUIRE(producer.prepare(sizeof(std::uint64_t)).empty());
+
+  std::uint64_t value = 0;
+  REQUIRE(dequeue(consumer, value, start));
+  REQUIRE(value == 0);
+
+  consumer.reset();
+  REQUIRE_FALSE(dequeue(consumer, value, start + std::chrono::hours(10)));
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    REQUIRE(enqueue(producer, i, Clock::time_point()));
+  }
+}
+
+TEST_CASE("BoundedDelayedRawQueue: arrivals lap wrap") {
+  using QueueDetail = detail::BoundedDelayedRawQueueDetail<BoundedDelayedRawQueueDefaultTraits>;
+  constexpr std::size_t kLength = 4;
+
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-delayed-test");
+  };
+
+  BoundedDelayedRawQueue queue("turboq-delayed-test", {sizeof(std::uint64_t), kLength}, memorySource);
+
+  // start one lap before the lap number exceeds 32 bits
+  auto [file, pageSize] = memorySource.open("turboq-delayed-test", MemorySource::OpenOnly).value();
+  auto storage = detail::mapFile(file);
+  std::size_t const pos = kLength * ((std::size_t(1) << 32) - 2);
+  std::bit_cast<QueueDetail::MemoryHeader*>(storage.data())->arrivalsProducerPos = pos;
+  std::bit_cast<QueueDetail::WheelHeader*>(storage.data() + QueueDetail::kWheelStartPos)->arrivalsConsumerPos = pos;
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::uint64_t value = 0;
+  for (std::uint64_t i = 0; i < 3 * kLength; ++i) {
+    REQUIRE(enqueue(producer, i, Clock::time_point()));
+    REQUIRE(dequeue(consumer, value, Clock::now()));
+    REQUIRE(value == i);
+  }
+}
+
+TEST_CASE("BoundedDelayedRawQueue: threads") {
+  constexpr std::uint64_t kCount = 20000;
+
+  BoundedDelayedRawQueue queue("test", {sizeof(std::uint64_t), 256}, AnonymousMemorySource());
+
+  auto produce = [&](std::uint64_t first) {
+    auto producer = queue.createProducer();
+    for (std::uint64_t i = first; i < kCount; i += 2) {
+      while (!enqueue(producer, i, Clock::now() + std::chrono::microseconds(i % 100))) {}
+    }
+  };
+
+  std::thread thread0(produce, 0);
+  std::thread thread1(produce, 1);
+
+  auto consumer = queue.createConsumer();
+  std::vector<bool> seen(kCount, false);
+  std::uint64_t received = 0;
+  while (received < kCount) {
+    std::uint64_t value = 0;
+    if (dequeue(consumer, value, Clock::now())) {
+      REQUIRE(!seen[value]);
+      seen[value] = true;
+      received++;
+    }
+  }
+
+  thread0.join();
+  thread1.join();
+}
+
+} // namespace turboq::testing
@@ -7,14 +7,21 @@
 #include <atomic>
 #include <bit>
 #include <cassert>
+#include <chrono>
+#include <climits>
 #include <cstddef>
-#include <format>
+#include <cstdint>
 #include <span>
+#include <string>
 #include <string_view>
 #include <type_traits>
 
 #include <turboq/MappedRegion.h>
 #include <turboq/MemorySource.h>
+#include <turboq/ReadinessBitmap.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/futex.h>
 #include <turboq/detail/math.h>
 #include <turboq/detail/memory.h>
 #include <turboq/platform.h>
@@ -31,21 +38,38 @@ struct BoundedMPSCRawQueueDetail {
   static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
   /// Alignment
   static constexpr std::size_t kAlign = Traits::kAlign;
+  /// Producers could sleep on full queue until consumer frees slots
+  static constexpr bool kProducerWait = [] {
+    if constexpr (requires { Traits::kProducerWait; }) {
+      return bool(Traits::kProducerWait);
+    } else {
+      return false;
+    }
+  }();
 
   /// Control struct for queue buffer
   struct MemoryHeader {
     /// Placeholder for queue tag
     char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
     /// Max message size
     std::size_t maxMessageSize;
     /// Queue length
     std::size_t length;
     /// Consumer position
     alignas(kAlign) std::size_t consumerPos;
+    /// Free slots sleeping producers wait for (wait mode only)
+    std::size_t producerWakeThreshold;
+    /// Producers sleep on this word (wait mode only)
+    std::uint32_t producerWaiting;
     /// Producer position
     alignas(kAlign) std::size_t producerPos;
 
     static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+    static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
   };
   static_assert(std::is_trivially_copyable_v<MemoryHeader>);
 
@@ -55,6 +79,9 @@ struct BoundedMPSCRawQueueDetail {
   };
   static_assert(std::is_trivially_copyable_v<MessageHeader>);
 
+  /// Payload size of aborted message, consumers pass over it
+  static constexpr std::size_t kSkipMarker = std::size_t(-1);
+
   /// Control struct for commit state
   struct StateHeader {
     alignas(kAlign) bool commited;
@@ -81,6 +108,10 @@ struct BoundedMPSCRawQueueDetail {
     if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
       return false;
     }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
     return true;
   }
 
@@ -88,8 +119,12 @@ struct BoundedMPSCRawQueueDetail {
   static void init(std::span<std::byte> buffer, std::size_t maxMessageSize, std::size_t length) noexcept {
     auto header = std::bit_cast<MemoryHeader*>(buffer.data());
     std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
     header->maxMessageSize = maxMessageSize;
     header->length = length;
+    header->producerWakeThreshold = 0;
+    header->producerWaiting = 0;
   }
 };
 
@@ -108,6 +143,8 @@ private:
   std::span<StateHeader> commitStates_;
   std::size_t producerPosCache_ = 0;
   std::size_t consumerPosCache_ = 0;
+  std::size_t reservedPos_ = 0;
+  ReadinessBitmapNotifier* notifier_ = nullptr;
 
 public:
   BoundedMPSCRawQueueProducer() = default;
@@ -126,7 +163,7 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(storage_.data());
@@ -161,19 +198,27 @@ public:
   }
 
   /// Reserve contiguous space for writing without making it visible to the consumers
-  /// \throw std::runtime_error in case of requested size greater max message size
+  /// \throw std::system_error in case of requested size greater max message size
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::size_t size) {
-    std::size_t const totalSize = size + sizeof(MessageHeader);
-    if (totalSize > header_->maxMessageSize) [[unlikely]] {
-      throw std::runtime_error(
-          std::format("buffer exceed max message size ({} > {})", totalSize, header_->maxMessageSize));
+    auto buffer = tryPrepare(size);
+    if (!buffer) [[unlikely]] {
+      throwMessageTooLarge(size);
+    }
+    return buffer.value();
+  }
+
+  /// Reserve space like prepare(). Return Error::MessageTooLarge in case of
+  /// requested size greater max message size and empty buffer on full queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<std::span<std::byte>> tryPrepare(std::size_t size) noexcept {
+    if (size + sizeof(MessageHeader) > header_->maxMessageSize) [[unlikely]] {
+      return makeErrorCode(Error::MessageTooLarge);
     }
 
     std::size_t currentProducerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
     if (currentProducerPos - consumerPosCache_ >= header_->length) [[unlikely]] {
       consumerPosCache_ = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
       if (currentProducerPos - consumerPosCache_ >= header_->length) [[unlikely]] {
-        return {};
+        return std::span<std::byte>();
       }
     }
 
@@ -181,20 +226,39 @@ public:
                 .compare_exchange_weak(currentProducerPos, currentProducerPos + 1, std::memory_order_release,
                     std::memory_order_relaxed)) [[unlikely]] {
       if (currentProducerPos - consumerPosCache_ >= header_->length) [[unlikely]] {
-        return {};
+        return std::span<std::byte>();
       }
     }
 
+    reservedPos_ = currentProducerPos;
     producerPosCache_ = currentProducerPos & (header_->length - 1);
     std::byte* content = data_.data() + producerPosCache_ * header_->maxMessageSize;
     std::bit_cast<MessageHeader*>(content)->payloadSize = size;
 
-    return {content + sizeof(MessageHeader), size};
+    return std::span<std::byte>(content + sizeof(MessageHeader), size);
+  }
+
+  /// Reserve space like prepare(), sleeping while the queue is full.
+  /// Consumer wakes producers once max(1, wakeThreshold) slots are free.
+  /// Return empty buffer on timeout.
+  /// \throw std::system_error in case of requested size greater max message size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepareWait(std::size_t size,
+      std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max(), std::size_t wakeThreshold = 0)
+    requires QueueDetail::kProducerWait
+  {
+    if (auto buffer = prepare(size); !buffer.empty()) [[likely]] {
+      return buffer;
+    }
+    return prepareWaitSlow(size, timeout, wakeThreshold);
   }
 
   /// Make reserved buffer visible for consumers
   TURBOQ_FORCE_INLINE void commit() noexcept {
     std::atomic_ref(commitStates_[producerPosCache_].commited).store(true, std::memory_order_release);
+
+    if (notifier_) [[unlikely]] {
+      notifyReadiness();
+    }
   }
 
   /// \overload
@@ -208,6 +272,21 @@ public:
     commit();
   }
 
+  /// Release reserved buffer. Slot is already claimed, so it's published as
+  /// skip marker the consumer passes over.
+  /// pre: prepare() -> non empty buffer, not committed
+  TURBOQ_FORCE_INLINE void abort() noexcept {
+    auto header = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_ * header_->maxMessageSize);
+    header->payloadSize = QueueDetail::kSkipMarker;
+    commit();
+  }
+
+  /// Flag queue in readiness bitmap on commits to the slot consumer waits on,
+  /// nullptr disables flagging. Notifier must outlive the producer.
+  TURBOQ_FORCE_INLINE void setReadinessNotifier(ReadinessBitmapNotifier* notifier) noexcept {
+    notifier_ = notifier;
+  }
+
   /// Swap resources with other producer
   void swap(BoundedMPSCRawQueueProducer& that) noexcept {
     using std::swap;
@@ -217,12 +296,65 @@ public:
     swap(commitStates_, that.commitStates_);
     swap(producerPosCache_, that.producerPosCache_);
     swap(consumerPosCache_, that.consumerPosCache_);
+    swap(reservedPos_, that.reservedPos_);
+    swap(notifier_, that.notifier_);
   }
 
   /// \see BoundedMPSCRawQueueProducer::swap
   friend void swap(BoundedMPSCRawQueueProducer& a, BoundedMPSCRawQueueProducer& b) noexcept {
     a.swap(b);
   }
+
+private:
+  /// Throw Error::MessageTooLarge describing the requested size
+  [[noreturn]] TURBOQ_COLD void throwMessageTooLarge(std::size_t size) const {
+    auto const what = "message size " + std::to_string(size + sizeof(MessageHeader)) + " > " +
+                      std::to_string(header_->maxMessageSize);
+    throwError(Error::MessageTooLarge, what.c_str());
+  }
+
+  /// Flag queue as ready in case of consumer has consumed all slots before the
+  /// committed one (consumer stops on the first not committed slot)
+  TURBOQ_NO_INLINE void notifyReadiness() noexcept {
+    if (std::atomic_ref(header_->consumerPos).load(std::memory_order_relaxed) == reservedPos_) {
+      notifier_->notify();
+    }
+  }
+
+  /// Sleep until consumer frees slots
+  TURBOQ_NO_INLINE std::span<std::byte> prepareWaitSlow(
+      std::size_t size, std::chrono::nanoseconds timeout, std::size_t wakeThreshold) {
+    using Clock = std::chrono::steady_clock;
+
+    // saturate deadline, large timeouts overflow the clock
+    auto const now = Clock::now();
+    auto const deadline = (timeout >= Clock::time_point::max() - now) ? Clock::time_point::max() : now + timeout;
+    std::size_t const threshold = std::clamp<std::size_t>(wakeThreshold, 1, header_->length);
+
+    for (;;) {
+      // several producers could wait with different thresholds, keep the smallest one
+      auto current = std::atomic_ref(header_->producerWakeThreshold).load(std::memory_order_relaxed);
+      if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) == 0 || threshold < current) {
+        std::atomic_ref(header_->producerWakeThreshold).store(threshold, std::memory_order_relaxed);
+      }
+      std::atomic_ref(header_->producerWaiting).store(1, std::memory_order_relaxed);
+      // Order the flag before re-reading consumer position, pairs with fence in consumer
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (auto buffer = prepare(size); !buffer.empty()) {
+        return buffer;
+      }
+
+      std::chrono::nanoseconds remaining = std::chrono::nanoseconds::max();
+      if (deadline != Clock::time_point::max()) {
+        remaining = deadline - Clock::now();
+        if (remaining.count() <= 0) {
+          return {};
+        }
+      }
+      detail::futexWait(&header_->producerWaiting, 1, remaining);
+    }
+  }
 };
 
 /// Implements a MPSC queue consumer
@@ -242,6 +374,10 @@ private:
   std::size_t consumerPosCache_ = 0;
   MessageHeader* lastMessageHeader_ = nullptr;
   StateHeader* lastCommitState_ = nullptr;
+  std::size_t wakeCheckPos_ = 0;
+
+  /// Number of fenced producer wake checks per ring lap (wait mode only)
+  static constexpr std::size_t kWakeChecksPerLap = 8;
 
 public:
   BoundedMPSCRawQueueConsumer() = default;
@@ -260,7 +396,7 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(storage_.data());
@@ -296,23 +432,48 @@ public:
     return 0;
   }
 
+  /// Return shared producer position word. It changes whenever new messages
+  /// could be fetched, so it could be polled before calling fetch().
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t const* producerPosition() const noexcept {
+    return &header_->producerPos;
+  }
+
+  /// Return shared consumer position word
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t const* consumerPosition() const noexcept {
+    return &header_->consumerPos;
+  }
+
   /// Get next buffer for reading. Return empty buffer in case of no data.
+  /// Passes over messages aborted by producers.
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
-    if ((consumerPosCache_ == producerPosCache_ &&
-            (producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) ==
-                consumerPosCache_)) [[unlikely]] {
-      return {};
-    }
+    for (;;) {
+      if ((consumerPosCache_ == producerPosCache_ &&
+              (producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) ==
+                  consumerPosCache_)) [[unlikely]] {
+        if constexpr (QueueDetail::kProducerWait) {
+          // Order consumer position before reading the flag, pairs with fence in producer
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) [[unlikely]] {
+            wakeProducers();
+          }
+        }
+        return {};
+      }
 
-    std::size_t const consumerPos = consumerPosCache_ & (header_->length - 1);
+      std::size_t const consumerPos = consumerPosCache_ & (header_->length - 1);
 
-    lastCommitState_ = &commitStates_[consumerPos];
-    if (!std::atomic_ref(lastCommitState_->commited).load(std::memory_order_acquire)) [[unlikely]] {
-      return {};
-    }
+      lastCommitState_ = &commitStates_[consumerPos];
+      if (!std::atomic_ref(lastCommitState_->commited).load(std::memory_order_acquire)) [[unlikely]] {
+        return {};
+      }
 
-    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + consumerPos * header_->maxMessageSize);
-    return {std::bit_cast<std::byte*>(lastMessageHeader_ + 1), lastMessageHeader_->payloadSize};
+      lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + consumerPos * header_->maxMessageSize);
+      if (lastMessageHeader_->payloadSize == QueueDetail::kSkipMarker) [[unlikely]] {
+        consume();
+        continue;
+      }
+      return {std::bit_cast<std::byte*>(lastMessageHeader_ + 1), lastMessageHeader_->payloadSize};
+    }
   }
 
   /// Consume front buffer and make buffer available for producer
@@ -321,6 +482,10 @@ public:
     consumerPosCache_++;
     std::atomic_ref(lastCommitState_->commited).store(false, std::memory_order_release);
     std::atomic_ref(header_->consumerPos).store(consumerPosCache_, std::memory_order_release);
+
+    if constexpr (QueueDetail::kProducerWait) {
+      notifyProducers();
+    }
   }
 
   /// Reset queue
@@ -333,6 +498,13 @@ public:
       consumerPosCache_++;
     }
     std::atomic_ref(header_->consumerPos).store(consumerPosCache_, std::memory_order_release);
+
+    if constexpr (QueueDetail::kProducerWait) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) {
+        wakeProducers();
+      }
+    }
   }
 
   /// Swap resources with other object
@@ -346,12 +518,181 @@ public:
     swap(consumerPosCache_, that.consumerPosCache_);
     swap(lastMessageHeader_, that.lastMessageHeader_);
     swap(lastCommitState_, that.lastCommitState_);
+    swap(wakeCheckPos_, that.wakeCheckPos_);
   }
 
   /// \see BoundedMPSCRawQueueConsumer::swap
   friend void swap(BoundedMPSCRawQueueConsumer& a, BoundedMPSCRawQueueConsumer& b) noexcept {
     a.swap(b);
   }
+
+private:
+  /// Wake all producers sleeping on full queue
+  TURBOQ_COLD void wakeProducers() noexcept {
+    if (std::atomic_ref(header_->producerWaiting).exchange(0, std::memory_order_acq_rel) != 0) {
+      detail::futexWake(&header_->producerWaiting, INT_MAX);
+    }
+  }
+
+  /// Wake producers sleeping on full queue in case of enough slots are free.
+  /// Flag is read without fence, so it could miss producer going to sleep
+  /// right after consumer position was stored. Flag is re-checked after fence
+  /// each time consumer position crosses the next 1/kWakeChecksPerLap of the ring.
+  TURBOQ_FORCE_INLINE void notifyProducers() noexcept {
+    if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0 ||
+        consumerPosCache_ >= wakeCheckPos_) [[unlikely]] {
+      notifyProducersSlow();
+    }
+  }
+
+  /// \see BoundedMPSCRawQueueConsumer::notifyProducers
+  TURBOQ_COLD void notifyProducersSlow() noexcept {
+    // Order consumer position before reading the flag, pairs with fence in producer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeCheckPos_ = consumerPosCache_ + std::max<std::size_t>(header_->length / kWakeChecksPerLap, 1);
+    if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) {
+      wakeProducersOnThreshold();
+    }
+  }
+
+  /// Wake producers in case of free slots reached producers' threshold
+  TURBOQ_COLD void wakeProducersOnThreshold() noexcept {
+    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    std::size_t const free = header_->length - (producerPosCache_ - consumerPosCache_);
+    if (free >= std::atomic_ref(header_->producerWakeThreshold).load(std::memory_order_relaxed)) {
+      wakeProducers();
+    }
+  }
+};
+
+/// Implements a MPSC queue tap: read-only observer following the producers.
+/// Tap never stores to the queue memory (mapped read-only) and is invisible to
+/// the producers and the consumer. Tap sees only messages the consumer hasn't
+/// released yet and skips (counts as dropped) the released ones.
+template <typename Traits>
+class BoundedMPSCRawQueueTap {
+private:
+  using QueueDetail = BoundedMPSCRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+  using StateHeader = typename QueueDetail::StateHeader;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  std::span<std::byte const> data_;
+  std::span<StateHeader> commitStates_;
+  std::size_t tapPos_ = 0;
+  std::size_t dropped_ = 0;
+
+public:
+  BoundedMPSCRawQueueTap() = default;
+  ~BoundedMPSCRawQueueTap() = default;
+
+  BoundedMPSCRawQueueTap(BoundedMPSCRawQueueTap&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedMPSCRawQueueTap& operator=(BoundedMPSCRawQueueTap&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedMPSCRawQueueTap(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+
+    std::size_t offset = QueueDetail::kDataStartPos;
+    data_ = content.subspan(offset, header_->maxMessageSize * header_->length);
+
+    offset += header_->maxMessageSize * header_->length;
+    commitStates_ = std::span<StateHeader>(std::bit_cast<StateHeader*>(storage_.data() + offset), header_->length);
+
+    // start from the messages claimed after tap creation
+    tapPos_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return number of messages released by consumer before tap fetched them
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t dropped() const noexcept {
+    return dropped_;
+  }
+
+  /// Get next buffer for reading. Return empty buffer in case of no data.
+  /// Buffer could be released by consumer and overwritten at any moment, call
+  /// verify() after reading it.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
+    auto const consumerPos = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
+    if (tapPos_ < consumerPos) [[unlikely]] {
+      dropped_ += consumerPos - tapPos_;
+      tapPos_ = consumerPos;
+    }
+
+    for (;;) {
+      if (tapPos_ == std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) {
+        return {};
+      }
+
+      std::size_t const slot = tapPos_ & (header_->length - 1);
+      if (!std::atomic_ref(commitStates_[slot].commited).load(std::memory_order_acquire)) {
+        return {};
+      }
+
+      auto const message = std::bit_cast<MessageHeader const*>(data_.data() + slot * header_->maxMessageSize);
+      std::size_t const payloadSize = message->payloadSize;
+      if (payloadSize == QueueDetail::kSkipMarker) [[unlikely]] {
+        // aborted by producer
+        tapPos_++;
+        continue;
+      }
+      if (payloadSize > header_->maxMessageSize - sizeof(MessageHeader)) [[unlikely]] {
+        return {};
+      }
+      return {std::bit_cast<std::byte const*>(message + 1), payloadSize};
+    }
+  }
+
+  /// Return true in case of the buffer returned by the last fetch() was not
+  /// released by consumer. Call after reading the buffer and before consume().
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool verify() const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::atomic_ref(header_->consumerPos).load(std::memory_order_relaxed) <= tapPos_;
+  }
+
+  /// Move to the next message
+  /// pre: fetch() -> non empty buffer
+  TURBOQ_FORCE_INLINE void consume() noexcept {
+    tapPos_++;
+  }
+
+  /// Skip all messages
+  TURBOQ_FORCE_INLINE void reset() noexcept {
+    tapPos_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+  }
+
+  /// Swap resources with other object
+  void swap(BoundedMPSCRawQueueTap& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(data_, that.data_);
+    swap(commitStates_, that.commitStates_);
+    swap(tapPos_, that.tapPos_);
+    swap(dropped_, that.dropped_);
+  }
+
+  /// \see BoundedMPSCRawQueueTap::swap
+  friend void swap(BoundedMPSCRawQueueTap& a, BoundedMPSCRawQueueTap& b) noexcept {
+    a.swap(b);
+  }
 };
 
 } // namespace detail
@@ -380,6 +721,7 @@ private:
 public:
   using Producer = detail::BoundedMPSCRawQueueProducer<Traits>;
   using Consumer = detail::BoundedMPSCRawQueueConsumer<Traits>;
+  using Tap = detail::BoundedMPSCRawQueueTap<Traits>;
 
   struct CreationOptions {
     std::size_t maxMessageSizeHint;
@@ -400,36 +742,53 @@ public:
   }
 
   /// Open only queue. Throws on error.
-  BoundedMPSCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) {
+  BoundedMPSCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedMPSCRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedMPSCRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedMPSCRawQueueImpl(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedMPSCRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
     auto result = memorySource.open(name, MemorySource::OpenOnly);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
 
+    BoundedMPSCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
-    if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-      throw std::runtime_error("failed to open queue (invalid)");
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
     }
+    return queue;
   }
 
-  /// Open or create queue. Throws on error.
-  BoundedMPSCRawQueueImpl(
-      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource()) {
-    if (options.maxMessageSizeHint == 0) {
-      throw std::runtime_error("invalid argument (max message size)");
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedMPSCRawQueueImpl> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (invalidOption(options)) {
+      return makeErrorCode(Error::InvalidArgument);
     }
-    if (options.lengthHint == 0) {
-      throw std::runtime_error("invalid argument (length)");
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
     }
     auto result = memorySource.open(name, MemorySource::OpenOrCreate);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
 
+    BoundedMPSCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
     auto const maxMessageSize = QueueDetail::alignBufferSize(options.maxMessageSizeHint + sizeof(MessageHeader));
     auto const length = detail::upper_pow_2(options.lengthHint);
@@ -439,17 +798,32 @@ public:
     auto const capacity = detail::align_up(capacityHint, pageSize);
 
     // init queue or check queue's options is the same as requested
-    if (auto const fileSize = file_.getFileSize(); fileSize != 0) {
-      if (fileSize != capacity) {
-        throw std::runtime_error("size mismatch");
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
       }
-      if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-        throw std::runtime_error("failed to open queue (invalid)");
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
       }
     } else {
-      file_.truncate(capacity);
-      QueueDetail::init(detail::mapFile(file_, capacity).content(), maxMessageSize, length);
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content(), maxMessageSize, length);
     }
+    return queue;
   }
 
   /// Return true on queue intialized.
@@ -459,21 +833,70 @@ public:
 
   /// Create producer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue in not initialized");
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
     }
-    return Producer(detail::mapFile(file_));
+    return Producer(std::move(storage).value());
   }
 
   /// Create consumer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer() {
+    return valueOrThrow(tryCreateConsumer());
+  }
+
+  /// Create consumer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue in not initialized");
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto const locked = file_.tryLockNoThrow();
+    if (!locked) {
+      return failure(locked.error());
     }
-    if (!file_.tryLock()) {
-      throw std::runtime_error("can't create consumer (already exists?)");
+    if (!locked.value()) {
+      return makeErrorCode(Error::ConsumerExists);
     }
-    return Consumer(detail::mapFile(file_));
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Consumer(std::move(storage).value());
+  }
+
+  /// Create read-only tap for the queue. Doesn't affect producers and consumer.
+  /// Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Tap createTap() {
+    return valueOrThrow(tryCreateTap());
+  }
+
+  /// Create read-only tap for the queue. Doesn't affect producers and consumer.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Tap> tryCreateTap() noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFileReadOnly(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Tap(std::move(storage).value());
   }
 
   /// Swap resources with other queue.
@@ -486,6 +909,18 @@ public:
   friend void swap(BoundedMPSCRawQueueImpl& a, BoundedMPSCRawQueueImpl& b) noexcept {
     a.swap(b);
   }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.maxMessageSizeHint == 0) {
+      return "max message size";
+    }
+    if (options.lengthHint == 0) {
+      return "length";
+    }
+    return nullptr;
+  }
 };
 
 } // namespace turboq
@@ -2,8 +2,13 @@
 // SPDX-License-Identifier: AGPL-3.0
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include <doctest/doctest.h>
 
@@ -59,4 +64,147 @@ TEST_CASE("BoundedMPSCRawQueue: basic") {
   REQUIRE(value == std::uint64_t(-1));
 }
 
+TEST_CASE("BoundedMPSCRawQueue: tap") {
+  BoundedMPSCRawQueue queue(
+      "test", BoundedMPSCRawQueue::CreationOptions(sizeof(std::uint64_t), 16), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  auto tap0 = queue.createTap();
+  auto tap1 = queue.createTap();
+  REQUIRE(tap0);
+  REQUIRE(tap1);
+
+  std::uint64_t value = std::uint64_t(-1);
+  REQUIRE(!dequeue(tap0, value));
+
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+
+  // taps don't take messages from the consumer
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(dequeue(tap0, value));
+    REQUIRE(value == i);
+  }
+  REQUIRE(!dequeue(tap0, value));
+  for (std::uint64_t i = 0; i < 2; ++i) {
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == i);
+  }
+
+  // messages released by consumer are skipped by the lagging tap
+  REQUIRE(dequeue(tap1, value));
+  REQUIRE(value == 2);
+  REQUIRE(tap1.dropped() == 2);
+  REQUIRE(tap0.dropped() == 0);
+}
+
+TEST_CASE("BoundedMPSCRawQueue: abort") {
+  BoundedMPSCRawQueue queue(
+      "test", BoundedMPSCRawQueue::CreationOptions(sizeof(std::uint64_t), 16), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  auto tap = queue.createTap();
+
+  std::uint64_t value = std::uint64_t(-1);
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    auto buffer = producer.prepare(sizeof(i));
+    REQUIRE(!buffer.empty());
+    std::memcpy(buffer.data(), &i, sizeof(i));
+    if (i % 3 == 0) {
+      producer.abort();
+      continue;
+    }
+    producer.commit();
+
+    // aborted slots are passed over by consumer and tap
+    REQUIRE(dequeue(tap, value));
+    REQUIRE(value == i);
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == i);
+    REQUIRE(!dequeue(consumer, value));
+  }
+  REQUIRE(tap.dropped() == 0);
+}
+
+struct BoundedMPSCRawQueueWaitTraits : BoundedMPSCRawQueueDefaultTraits {
+  static constexpr bool kProducerWait = true;
+};
+
+TEST_CASE("BoundedMPSCRawQueue: producer wait") {
+  using Queue = BoundedMPSCRawQueueImpl<BoundedMPSCRawQueueWaitTraits>;
+
+  Queue queue("test", Queue::CreationOptions(sizeof(std::uint64_t), 16), AnonymousMemorySource());
+
+  auto consumer = queue.createConsumer();
+
+  SUBCASE("timeout") {
+    auto producer = queue.createProducer();
+    while (!producer.prepare(sizeof(std::uint64_t)).empty()) {
+      producer.commit();
+    }
+    REQUIRE(producer.prepareWait(sizeof(std::uint64_t), std::chrono::milliseconds(1)).empty());
+  }
+
+  SUBCASE("threads") {
+    constexpr std::uint64_t kProducers = 4;
+    constexpr std::uint64_t kCount = 50000;
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t p = 0; p < kProducers; ++p) {
+      threads.emplace_back([&queue, p] {
+        auto producer = queue.createProducer();
+        for (std::uint64_t i = 0; i < kCount; ++i) {
+          std::uint64_t const value = p * kCount + i;
+          auto buffer = producer.prepareWait(sizeof(value), std::chrono::nanoseconds::max(), 4);
+          std::memcpy(buffer.data(), &value, sizeof(value));
+          producer.commit();
+        }
+      });
+    }
+
+    std::vector<std::uint64_t> next(kProducers, 0);
+    bool ordered = true;
+    for (std::uint64_t i = 0; i < kProducers * kCount; ++i) {
+      std::uint64_t value = std::uint64_t(-1);
+      while (!dequeue(consumer, value)) {}
+      ordered = ordered && (value % kCount == next[value / kCount]++);
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(ordered);
+  }
+}
+
+TEST_CASE("BoundedMPSCRawQueue: result") {
+  REQUIRE(!BoundedMPSCRawQueue::create("test", {0, 16}, AnonymousMemorySource()));
+
+  auto queue = BoundedMPSCRawQueue::create("test", {sizeof(std::uint64_t), 16}, AnonymousMemorySource());
+  REQUIRE(queue);
+
+  auto producer = queue.value().tryCreateProducer();
+  auto consumer = queue.value().tryCreateConsumer();
+  REQUIRE(producer);
+  REQUIRE(consumer);
+
+  // no exception and no allocation on too large message
+  auto const tooLarge = producer.value().tryPrepare(producer.value().maxMessageSize());
+  REQUIRE(!tooLarge);
+  REQUIRE(tooLarge.error() == std::error_code(int(Error::MessageTooLarge), getErrorCategory()));
+  REQUIRE_THROWS_WITH((void)producer.value().prepare(producer.value().maxMessageSize()),
+      doctest::Contains("message size"));
+  REQUIRE_THROWS_WITH(BoundedMPSCRawQueue("test", {sizeof(std::uint64_t), 0}, AnonymousMemorySource()),
+      doctest::Contains("length"));
+
+  auto buffer = producer.value().tryPrepare(sizeof(std::uint64_t));
+  REQUIRE(buffer);
+  REQUIRE(buffer.value().size() == sizeof(std::uint64_t));
+  producer.value().commit();
+  REQUIRE(consumer.value().fetch().size() == sizeof(std::uint64_t));
+}
+
 } // namespace turboq::testing
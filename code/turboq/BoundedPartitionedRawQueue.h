@@ -0,0 +1,667 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/math.h>
+#include <turboq/detail/memory.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+namespace detail {
+
+/// Partitioned queue detail
+/// Layout: MemoryHeader, PartitionHeader[partitions], then for each partition
+/// message slots followed by commit states (same ring as MPSC queue).
+template <typename Traits>
+struct BoundedPartitionedRawQueueDetail {
+  /// Queue tag
+  static constexpr std::string_view kTag = Traits::kTag;
+  /// Segment size
+  static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
+  /// Alignment
+  static constexpr std::size_t kAlign = Traits::kAlign;
+
+  /// Control struct for queue buffer
+  struct MemoryHeader {
+    /// Placeholder for queue tag
+    char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
+    /// Partitions count
+    std::size_t partitions;
+    /// Max message size
+    std::size_t maxMessageSize;
+    /// Partition length
+    std::size_t length;
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Control struct for partition ring
+  struct PartitionHeader {
+    /// Consumer position
+    alignas(kAlign) std::size_t consumerPos;
+    /// Producer position
+    alignas(kAlign) std::size_t producerPos;
+
+    static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<PartitionHeader>);
+
+  /// Control struct for message
+  struct MessageHeader {
+    std::size_t payloadSize;
+  };
+  static_assert(std::is_trivially_copyable_v<MessageHeader>);
+
+  /// Payload size of aborted message, consumers pass over it
+  static constexpr std::size_t kSkipMarker = std::size_t(-1);
+
+  /// Control struct for commit state
+  struct StateHeader {
+    alignas(kAlign) bool commited;
+
+    static_assert(std::atomic_ref<bool>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<StateHeader>);
+
+  /// Partition ring
+  struct Ring {
+    PartitionHeader* header = nullptr;
+    std::byte* data = nullptr;
+    StateHeader* states = nullptr;
+  };
+
+  /// Align message buffer size
+  static constexpr std::size_t alignBufferSize(std::size_t value) noexcept {
+    return detail::align_up(value, kSegmentSize);
+  }
+
+  /// Offset for the first partition header from memory buffer start
+  static constexpr std::size_t kPartitionsStartPos = alignBufferSize(sizeof(MemoryHeader));
+
+  /// Offset for the first partition ring from memory buffer start
+  static constexpr std::size_t dataStartPos(std::size_t partitions) noexcept {
+    return kPartitionsStartPos + sizeof(PartitionHeader) * partitions;
+  }
+
+  /// Size of one partition ring
+  static constexpr std::size_t ringSize(std::size_t maxMessageSize, std::size_t length) noexcept {
+    return maxMessageSize * length + sizeof(StateHeader) * length;
+  }
+
+  /// Size of memory buffer required for the queue
+  static constexpr std::size_t bufferSize(std::size_t partitions, std::size_t maxMessageSize, std::size_t length) {
+    return dataStartPos(partitions) + ringSize(maxMessageSize, length) * partitions;
+  }
+
+  /// Check buffer points to valid partitioned queue region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept {
+    if (buffer.size() < kPartitionsStartPos) {
+      return false;
+    }
+    auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+    if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+      return false;
+    }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
+    if (header->partitions == 0 || header->maxMessageSize == 0 || !std::has_single_bit(header->length)) {
+      return false;
+    }
+    return bufferSize(header->partitions, header->maxMessageSize, header->length) <= buffer.size();
+  }
+
+  /// Init queue memory header
+  static void init(
+      std::span<std::byte> buffer, std::size_t partitions, std::size_t maxMessageSize, std::size_t length) noexcept {
+    auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+    std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
+    header->partitions = partitions;
+    header->maxMessageSize = maxMessageSize;
+    header->length = length;
+  }
+
+  /// Return partition ring
+  [[nodiscard]] static Ring ring(std::span<std::byte> buffer, std::size_t partition) noexcept {
+    auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+    assert(partition < header->partitions);
+    std::byte* data = buffer.data() + dataStartPos(header->partitions) +
+                      ringSize(header->maxMessageSize, header->length) * partition;
+    return {
+        std::bit_cast<PartitionHeader*>(buffer.data() + kPartitionsStartPos) + partition,
+        data,
+        std::bit_cast<StateHeader*>(data + header->maxMessageSize * header->length),
+    };
+  }
+
+  /// Map key to partition: mix key bits, then multiply-shift range reduction
+  [[nodiscard]] static TURBOQ_FORCE_INLINE std::size_t partitionOf(
+      std::uint64_t key, std::size_t partitions) noexcept {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    __extension__ typedef unsigned __int128 UInt128;
+    return static_cast<std::size_t>((static_cast<UInt128>(key) * partitions) >> 64);
+  }
+};
+
+/// Partitioned queue producer
+template <typename Traits>
+class BoundedPartitionedRawQueueProducer {
+private:
+  using QueueDetail = BoundedPartitionedRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+  using StateHeader = typename QueueDetail::StateHeader;
+  using Ring = typename QueueDetail::Ring;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  std::vector<Ring> rings_;
+  std::vector<std::size_t> consumerPosCache_;
+  MessageHeader* lastMessageHeader_ = nullptr;
+  StateHeader* lastCommitState_ = nullptr;
+
+public:
+  BoundedPartitionedRawQueueProducer() = default;
+  ~BoundedPartitionedRawQueueProducer() = default;
+
+  BoundedPartitionedRawQueueProducer(BoundedPartitionedRawQueueProducer&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPartitionedRawQueueProducer& operator=(BoundedPartitionedRawQueueProducer&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedPartitionedRawQueueProducer(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    for (std::size_t partition = 0; partition < header_->partitions; ++partition) {
+      auto const& ring = rings_.emplace_back(QueueDetail::ring(content, partition));
+      consumerPosCache_.push_back(std::atomic_ref(ring.header->consumerPos).load(std::memory_order_acquire));
+    }
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return partitions count
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t partitions() const noexcept {
+    return rings_.size();
+  }
+
+  /// Return partition for the key
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t partitionOf(std::uint64_t key) const noexcept {
+    return QueueDetail::partitionOf(key, rings_.size());
+  }
+
+  /// Reserve space in the key's partition without making it visible to the consumer.
+  /// Return empty buffer in case of the partition is full.
+  /// \throw std::system_error in case of requested size greater max message size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::uint64_t key, std::size_t size) {
+    return preparePartition(partitionOf(key), size);
+  }
+
+  /// \see prepare. Return Error::MessageTooLarge in case of requested size greater
+  /// max message size.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<std::span<std::byte>> tryPrepare(
+      std::uint64_t key, std::size_t size) noexcept {
+    return tryPreparePartition(partitionOf(key), size);
+  }
+
+  /// Reserve space in the partition without making it visible to the consumer.
+  /// Return empty buffer in case of the partition is full.
+  /// \throw std::system_error in case of requested size greater max message size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> preparePartition(std::size_t partition, std::size_t size) {
+    return valueOrThrow(tryPreparePartition(partition, size));
+  }
+
+  /// \see preparePartition. Return Error::MessageTooLarge in case of requested size greater
+  /// max message size.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<std::span<std::byte>> tryPreparePartition(
+      std::size_t partition, std::size_t size) noexcept {
+    if (size + sizeof(MessageHeader) > header_->maxMessageSize) [[unlikely]] {
+      return makeErrorCode(Error::MessageTooLarge);
+    }
+
+    auto const& ring = rings_[partition];
+    auto& consumerPosCache = consumerPosCache_[partition];
+
+    std::size_t currentProducerPos = std::atomic_ref(ring.header->producerPos).load(std::memory_order_acquire);
+    if (currentProducerPos - consumerPosCache >= header_->length) [[unlikely]] {
+      consumerPosCache = std::atomic_ref(ring.header->consumerPos).load(std::memory_order_acquire);
+      if (currentProducerPos - consumerPosCache >= header_->length) [[unlikely]] {
+        return std::span<std::byte>();
+      }
+    }
+
+    while (!std::atomic_ref(ring.header->producerPos)
+                .compare_exchange_weak(currentProducerPos, currentProducerPos + 1, std::memory_order_release,
+                    std::memory_order_relaxed)) [[unlikely]] {
+      if (currentProducerPos - consumerPosCache >= header_->length) [[unlikely]] {
+        return std::span<std::byte>();
+      }
+    }
+
+    std::size_t const slot = currentProducerPos & (header_->length - 1);
+    lastCommitState_ = &ring.states[slot];
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(ring.data + slot * header_->maxMessageSize);
+    lastMessageHeader_->payloadSize = size;
+
+    return std::span<std::byte>(std::bit_cast<std::byte*>(lastMessageHeader_ + 1), size);
+  }
+
+  /// Make reserved buffer visible for the partition consumer
+  TURBOQ_FORCE_INLINE void commit() noexcept {
+    std::atomic_ref(lastCommitState_->commited).store(true, std::memory_order_release);
+  }
+
+  /// \overload
+  TURBOQ_FORCE_INLINE void commit(std::size_t size) noexcept {
+    if (size <= lastMessageHeader_->payloadSize) [[likely]] {
+      lastMessageHeader_->payloadSize = size;
+    } else {
+      assert(false);
+    }
+    commit();
+  }
+
+  /// Release reserved buffer. Slot is already claimed, so it's published as
+  /// skip marker the consumer passes over.
+  /// pre: prepare() -> non empty buffer, not committed
+  TURBOQ_FORCE_INLINE void abort() noexcept {
+    lastMessageHeader_->payloadSize = QueueDetail::kSkipMarker;
+    commit();
+  }
+
+  /// Swap resources with other producer
+  void swap(BoundedPartitionedRawQueueProducer& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(rings_, that.rings_);
+    swap(consumerPosCache_, that.consumerPosCache_);
+    swap(lastMessageHeader_, that.lastMessageHeader_);
+    swap(lastCommitState_, that.lastCommitState_);
+  }
+
+  /// \see BoundedPartitionedRawQueueProducer::swap
+  friend void swap(BoundedPartitionedRawQueueProducer& a, BoundedPartitionedRawQueueProducer& b) noexcept {
+    a.swap(b);
+  }
+};
+
+/// Partitioned queue consumer, owns one partition
+template <typename Traits>
+class BoundedPartitionedRawQueueConsumer {
+private:
+  using QueueDetail = BoundedPartitionedRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+  using StateHeader = typename QueueDetail::StateHeader;
+  using Ring = typename QueueDetail::Ring;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  Ring ring_;
+  std::size_t partition_ = 0;
+  std::size_t producerPosCache_ = 0;
+  std::size_t consumerPosCache_ = 0;
+  MessageHeader* lastMessageHeader_ = nullptr;
+  StateHeader* lastCommitState_ = nullptr;
+
+public:
+  BoundedPartitionedRawQueueConsumer() = default;
+  ~BoundedPartitionedRawQueueConsumer() = default;
+
+  BoundedPartitionedRawQueueConsumer(BoundedPartitionedRawQueueConsumer&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPartitionedRawQueueConsumer& operator=(BoundedPartitionedRawQueueConsumer&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedPartitionedRawQueueConsumer(MappedRegion&& storage, std::size_t partition)
+      : storage_(std::move(storage)), partition_(partition) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    if (partition_ >= header_->partitions) {
+      throwError(Error::InvalidArgument, "partition");
+    }
+
+    ring_ = QueueDetail::ring(content, partition_);
+    producerPosCache_ = std::atomic_ref(ring_.header->producerPos).load(std::memory_order_acquire);
+    consumerPosCache_ = std::atomic_ref(ring_.header->consumerPos).load(std::memory_order_acquire);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return consumer's partition
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t partition() const noexcept {
+    return partition_;
+  }
+
+  /// Get next buffer for reading. Return empty buffer in case of no data.
+  /// Passes over messages aborted by producers.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
+    for (;;) {
+      if ((consumerPosCache_ == producerPosCache_ &&
+              (producerPosCache_ = std::atomic_ref(ring_.header->producerPos).load(std::memory_order_acquire)) ==
+                  consumerPosCache_)) [[unlikely]] {
+        return {};
+      }
+
+      std::size_t const slot = consumerPosCache_ & (header_->length - 1);
+
+      lastCommitState_ = &ring_.states[slot];
+      if (!std::atomic_ref(lastCommitState_->commited).load(std::memory_order_acquire)) [[unlikely]] {
+        return {};
+      }
+
+      lastMessageHeader_ = std::bit_cast<MessageHeader*>(ring_.data + slot * header_->maxMessageSize);
+      if (lastMessageHeader_->payloadSize == QueueDetail::kSkipMarker) [[unlikely]] {
+        consume();
+        continue;
+      }
+      return {std::bit_cast<std::byte*>(lastMessageHeader_ + 1), lastMessageHeader_->payloadSize};
+    }
+  }
+
+  /// Consume front buffer and make buffer available for producers
+  /// pre: fetch() -> non empty buffer
+  TURBOQ_FORCE_INLINE void consume() noexcept {
+    consumerPosCache_++;
+    std::atomic_ref(lastCommitState_->commited).store(false, std::memory_order_release);
+    std::atomic_ref(ring_.header->consumerPos).store(consumerPosCache_, std::memory_order_release);
+  }
+
+  /// Reset partition
+  TURBOQ_FORCE_INLINE void reset() noexcept {
+    while (consumerPosCache_ != producerPosCache_) {
+      // Drop message.
+      std::size_t const slot = consumerPosCache_ & (header_->length - 1);
+      lastCommitState_ = &ring_.states[slot];
+      std::atomic_ref(lastCommitState_->commited).store(false, std::memory_order_release);
+      consumerPosCache_++;
+    }
+    std::atomic_ref(ring_.header->consumerPos).store(consumerPosCache_, std::memory_order_release);
+  }
+
+  /// Swap resources with other object
+  void swap(BoundedPartitionedRawQueueConsumer& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(ring_, that.ring_);
+    swap(partition_, that.partition_);
+    swap(producerPosCache_, that.producerPosCache_);
+    swap(consumerPosCache_, that.consumerPosCache_);
+    swap(lastMessageHeader_, that.lastMessageHeader_);
+    swap(lastCommitState_, that.lastCommitState_);
+  }
+
+  /// \see BoundedPartitionedRawQueueConsumer::swap
+  friend void swap(BoundedPartitionedRawQueueConsumer& a, BoundedPartitionedRawQueueConsumer& b) noexcept {
+    a.swap(b);
+  }
+};
+
+} // namespace detail
+
+template <typename Traits>
+class BoundedPartitionedRawQueueImpl;
+
+struct BoundedPartitionedRawQueueDefaultTraits {
+  static constexpr std::string_view kTag = "turboq/Partitioned";
+  static constexpr std::size_t kSegmentSize = kHardwareDestructiveInterferenceSize;
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+};
+
+/// Key-partitioned fan-out queue: producers hash key to one of N MPSC rings in
+/// one shared region, each consumer owns one ring. Messages with the same key
+/// are delivered to the same consumer in order.
+using BoundedPartitionedRawQueue = BoundedPartitionedRawQueueImpl<BoundedPartitionedRawQueueDefaultTraits>;
+
+template <typename Traits>
+class BoundedPartitionedRawQueueImpl {
+private:
+  using QueueDetail = detail::BoundedPartitionedRawQueueDetail<Traits>;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  File file_;
+
+public:
+  using Producer = detail::BoundedPartitionedRawQueueProducer<Traits>;
+  using Consumer = detail::BoundedPartitionedRawQueueConsumer<Traits>;
+
+  struct CreationOptions {
+    std::size_t partitions;
+    std::size_t maxMessageSizeHint;
+    std::size_t lengthHint;
+  };
+
+  BoundedPartitionedRawQueueImpl(BoundedPartitionedRawQueueImpl const&) = delete;
+  BoundedPartitionedRawQueueImpl& operator=(BoundedPartitionedRawQueueImpl const&) = delete;
+  BoundedPartitionedRawQueueImpl() = default;
+
+  BoundedPartitionedRawQueueImpl(BoundedPartitionedRawQueueImpl&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPartitionedRawQueueImpl& operator=(BoundedPartitionedRawQueueImpl&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only queue. Throws on error.
+  BoundedPartitionedRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedPartitionedRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedPartitionedRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedPartitionedRawQueueImpl(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedPartitionedRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    auto result = memorySource.open(name, MemorySource::OpenOnly);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedPartitionedRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return queue;
+  }
+
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedPartitionedRawQueueImpl> create(std::string_view name,
+      CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (invalidOption(options)) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
+    }
+    auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedPartitionedRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto const maxMessageSize = QueueDetail::alignBufferSize(options.maxMessageSizeHint + sizeof(MessageHeader));
+    auto const length = detail::upper_pow_2(options.lengthHint);
+    // round-up requested size to page size
+    auto const capacity =
+        detail::align_up(QueueDetail::bufferSize(options.partitions, maxMessageSize, length), pageSize);
+
+    // init queue or check queue's options is the same as requested
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+    } else {
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content(), options.partitions, maxMessageSize, length);
+    }
+    return queue;
+  }
+
+  /// Return true on queue intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create producer for the queue. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Producer(std::move(storage).value());
+  }
+
+  /// Create consumer for the partition. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer(std::size_t partition) {
+    return valueOrThrow(tryCreateConsumer(partition), "partition");
+  }
+
+  /// Create consumer for the partition.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer(std::size_t partition) noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    if (partition >= std::bit_cast<typename QueueDetail::MemoryHeader const*>(storage.value().data())->partitions) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    // one byte lock per partition, consumers of different partitions don't contend
+    auto const locked = file_.tryLockRangeNoThrow(partition, 1);
+    if (!locked) {
+      return failure(locked.error());
+    }
+    if (!locked.value()) {
+      return makeErrorCode(Error::ConsumerExists);
+    }
+    return Consumer(std::move(storage).value(), partition);
+  }
+
+  /// Swap resources with other queue.
+  void swap(BoundedPartitionedRawQueueImpl& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+  }
+
+  /// \see BoundedPartitionedRawQueueImpl::swap
+  friend void swap(BoundedPartitionedRawQueueImpl& a, BoundedPartitionedRawQueueImpl& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.partitions == 0) {
+      return "partitions";
+    }
+    if (options.maxMessageSizeHint == 0) {
+      return "max message size";
+    }
+    if (options.lengthHint == 0) {
+      return "length";
+    }
+    return nullptr;
+  }
+};
+
+} // namespace turboq
@@ -0,0 +1,187 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "BoundedPartitionedRawQueue.h"
+#include "utils.h"
+
+namespace turboq::testing {
+namespace {
+
+/// Message payload: key and sequence number within the key
+struct Message {
+  std::uint64_t key;
+  std::uint64_t sequence;
+};
+
+bool enqueue(BoundedPartitionedRawQueue::Producer& producer, Message const& message) {
+  auto buffer = producer.prepare(message.key, sizeof(message));
+  if (buffer.empty()) {
+    return false;
+  }
+  std::memcpy(buffer.data(), &message, sizeof(message));
+  producer.commit();
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("BoundedPartitionedRawQueue: basic") {
+  constexpr std::size_t kPartitions = 4;
+  constexpr std::uint64_t kKeys = 64;
+
+  BoundedPartitionedRawQueue queue(
+      "test", BoundedPartitionedRawQueue::CreationOptions(kPartitions, sizeof(Message), 1024), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  REQUIRE(producer);
+  REQUIRE(producer.partitions() == kPartitions);
+
+  std::vector<BoundedPartitionedRawQueue::Consumer> consumers;
+  for (std::size_t partition = 0; partition < kPartitions; ++partition) {
+    consumers.push_back(queue.createConsumer(partition));
+  }
+
+  for (std::uint64_t sequence = 0; sequence < 10; ++sequence) {
+    for (std::uint64_t key = 0; key < kKeys; ++key) {
+      REQUIRE(enqueue(producer, {key, sequence}));
+    }
+  }
+
+  // every key lands in its own partition, in order
+  std::vector<std::uint64_t> next(kKeys, 0);
+  std::vector<std::size_t> perPartition(kPartitions, 0);
+  for (auto& consumer : consumers) {
+    for (auto buffer = consumer.fetch(); !buffer.empty(); buffer = consumer.fetch()) {
+      Message message;
+      std::memcpy(&message, buffer.data(), sizeof(message));
+      REQUIRE(producer.partitionOf(message.key) == consumer.partition());
+      REQUIRE(message.sequence == next[message.key]++);
+      perPartition[consumer.partition()]++;
+      consumer.consume();
+    }
+  }
+  for (std::uint64_t key = 0; key < kKeys; ++key) {
+    REQUIRE(next[key] == 10);
+  }
+  for (auto count : perPartition) {
+    REQUIRE(count > 0);
+  }
+}
+
+TEST_CASE("BoundedPartitionedRawQueue: abort") {
+  BoundedPartitionedRawQueue queue(
+      "test", BoundedPartitionedRawQueue::CreationOptions(2, sizeof(Message), 16), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer(producer.partitionOf(42));
+
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    auto buffer = producer.prepare(42, sizeof(Message));
+    REQUIRE(!buffer.empty());
+    if (i % 2 == 0) {
+      producer.abort();
+      continue;
+    }
+    Message const message{42, i};
+    std::memcpy(buffer.data(), &message, sizeof(message));
+    producer.commit();
+
+    auto received = consumer.fetch();
+    REQUIRE(received.size() == sizeof(Message));
+    REQUIRE(std::memcmp(received.data(), &message, sizeof(message)) == 0);
+    consumer.consume();
+    REQUIRE(consumer.fetch().empty());
+  }
+}
+
+TEST_CASE("BoundedPartitionedRawQueue: consumer per partition") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-partitioned-test");
+  };
+
+  BoundedPartitionedRawQueue queue0(
+      "turboq-partitioned-test", BoundedPartitionedRawQueue::CreationOptions(2, sizeof(Message), 16), memorySource);
+  BoundedPartitionedRawQueue queue1("turboq-partitioned-test", memorySource);
+
+  auto consumer = queue0.createConsumer(0);
+  REQUIRE_THROWS(queue1.createConsumer(0));
+  REQUIRE_NOTHROW(queue1.createConsumer(1));
+  REQUIRE_THROWS(queue1.createConsumer(2));
+}
+
+TEST_CASE("BoundedPartitionedRawQueue: threads") {
+  constexpr std::size_t kPartitions = 2;
+  constexpr std::uint64_t kKeys = 16;
+  constexpr std::uint64_t kCount = 20000;
+
+  BoundedPartitionedRawQueue queue("test",
+      BoundedPartitionedRawQueue::CreationOptions(kPartitions, sizeof(Message), 1 << 14), AnonymousMemorySource());
+
+  // two producers with disjoint key sets
+  auto produce = [&](std::uint64_t firstKey) {
+    auto producer = queue.createProducer();
+    std::vector<std::uint64_t> sequence(kKeys, 0);
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      auto const key = firstKey + i % kKeys;
+      while (!enqueue(producer, {key, sequence[key - firstKey]})) {}
+      sequence[key - firstKey]++;
+    }
+  };
+
+  std::thread thread0(produce, 0);
+  std::thread thread1(produce, kKeys);
+
+  std::vector<BoundedPartitionedRawQueue::Consumer> consumers;
+  for (std::size_t partition = 0; partition < kPartitions; ++partition) {
+    consumers.push_back(queue.createConsumer(partition));
+  }
+
+  std::vector<std::uint64_t> next(2 * kKeys, 0);
+  std::uint64_t received = 0;
+  while (received < 2 * kCount) {
+    for (auto& consumer : consumers) {
+      auto buffer = consumer.fetch();
+      if (buffer.empty()) {
+        continue;
+      }
+      Message message;
+      std::memcpy(&message, buffer.data(), sizeof(message));
+      REQUIRE(message.sequence == next[message.key]++);
+      consumer.consume();
+      received++;
+    }
+  }
+
+  thread0.join();
+  thread1.join();
+}
+
+TEST_CASE("BoundedPartitionedRawQueue: result") {
+  auto queue = BoundedPartitionedRawQueue::create("test", {2, sizeof(std::uint64_t), 16}, AnonymousMemorySource());
+  REQUIRE(queue);
+
+  auto const outOfRange = queue.value().tryCreateConsumer(2);
+  REQUIRE(!outOfRange);
+  REQUIRE(outOfRange.error() == std::error_code(int(Error::InvalidArgument), getErrorCategory()));
+  REQUIRE(queue.value().tryCreateConsumer(1));
+  REQUIRE_THROWS_WITH(queue.value().createConsumer(2), doctest::Contains("partition"));
+
+  auto producer = queue.value().tryCreateProducer();
+  REQUIRE(producer);
+  REQUIRE(!producer.value().tryPrepare(1, 1024));
+  REQUIRE(producer.value().tryPrepare(1, sizeof(std::uint64_t)));
+}
+
+} // namespace turboq::testing
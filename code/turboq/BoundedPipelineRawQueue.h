@@ -0,0 +1,591 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/math.h>
+#include <turboq/detail/memory.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+namespace detail {
+
+/// Pipeline queue detail
+/// Layout: MemoryHeader, StageHeader[stages], message slots.
+/// Producer publishes slot i by moving producerPos, stage k processes slot i in place
+/// once stage k-1 has moved its cursor past it. Producer reuses slot once the last
+/// stage has released it.
+template <typename Traits>
+struct BoundedPipelineRawQueueDetail {
+  /// Queue tag
+  static constexpr std::string_view kTag = Traits::kTag;
+  /// Segment size
+  static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
+  /// Alignment
+  static constexpr std::size_t kAlign = Traits::kAlign;
+
+  /// Control struct for queue buffer
+  struct MemoryHeader {
+    /// Placeholder for queue tag
+    char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
+    /// Stages count
+    std::size_t stages;
+    /// Max message size
+    std::size_t maxMessageSize;
+    /// Queue length (slots count)
+    std::size_t length;
+    /// Producer position
+    alignas(kAlign) std::size_t producerPos;
+
+    static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Control struct for stage
+  struct StageHeader {
+    /// Stage cursor: slots before it are released to the next stage
+    alignas(kAlign) std::size_t pos;
+  };
+  static_assert(std::is_trivially_copyable_v<StageHeader>);
+
+  /// Control struct for message
+  struct MessageHeader {
+    std::size_t payloadSize;
+  };
+  static_assert(std::is_trivially_copyable_v<MessageHeader>);
+
+  /// Align message buffer size
+  static constexpr std::size_t alignBufferSize(std::size_t value) noexcept {
+    return detail::align_up(value, kSegmentSize);
+  }
+
+  /// Offset for the first stage header from memory buffer start
+  static constexpr std::size_t kStagesStartPos = alignBufferSize(sizeof(MemoryHeader));
+
+  /// Offset for the first message slot from memory buffer start
+  static constexpr std::size_t dataStartPos(std::size_t stages) noexcept {
+    return kStagesStartPos + alignBufferSize(sizeof(StageHeader) * stages);
+  }
+
+  /// Size of memory buffer required for the queue
+  static constexpr std::size_t bufferSize(std::size_t stages, std::size_t maxMessageSize, std::size_t length) {
+    return dataStartPos(stages) + maxMessageSize * length;
+  }
+
+  /// Check buffer points to valid pipeline queue region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept {
+    if (buffer.size() < kStagesStartPos) {
+      return false;
+    }
+    auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+    if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+      return false;
+    }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
+    if (header->stages == 0 || header->maxMessageSize == 0 || !std::has_single_bit(header->length)) {
+      return false;
+    }
+    return bufferSize(header->stages, header->maxMessageSize, header->length) <= buffer.size();
+  }
+
+  /// Init queue memory header
+  static void init(
+      std::span<std::byte> buffer, std::size_t stages, std::size_t maxMessageSize, std::size_t length) noexcept {
+    auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+    std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
+    header->stages = stages;
+    header->maxMessageSize = maxMessageSize;
+    header->length = length;
+    header->producerPos = 0;
+    std::fill_n(stage(buffer.data(), 0), stages, StageHeader{});
+  }
+
+  /// Return stage header
+  [[nodiscard]] static TURBOQ_FORCE_INLINE StageHeader* stage(std::byte* buffer, std::size_t index) noexcept {
+    return std::bit_cast<StageHeader*>(buffer + kStagesStartPos) + index;
+  }
+};
+
+/// Pipeline queue producer
+template <typename Traits>
+class BoundedPipelineRawQueueProducer {
+private:
+  using QueueDetail = BoundedPipelineRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using StageHeader = typename QueueDetail::StageHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  StageHeader* lastStage_ = nullptr;
+  std::byte* data_ = nullptr;
+  std::size_t producerPos_ = 0;
+  std::size_t lastStagePosCache_ = 0;
+  MessageHeader* lastMessageHeader_ = nullptr;
+
+public:
+  BoundedPipelineRawQueueProducer() = default;
+  ~BoundedPipelineRawQueueProducer() = default;
+
+  BoundedPipelineRawQueueProducer(BoundedPipelineRawQueueProducer&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPipelineRawQueueProducer& operator=(BoundedPipelineRawQueueProducer&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedPipelineRawQueueProducer(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    lastStage_ = QueueDetail::stage(storage_.data(), header_->stages - 1);
+    data_ = storage_.data() + QueueDetail::dataStartPos(header_->stages);
+    producerPos_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    lastStagePosCache_ = std::atomic_ref(lastStage_->pos).load(std::memory_order_acquire);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Reserve next slot for writing. Return empty buffer in case of the last stage
+  /// hasn't released the slot yet.
+  /// \throw std::system_error in case of requested size greater max message size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::size_t size) {
+    return valueOrThrow(tryPrepare(size));
+  }
+
+  /// \see prepare. Return Error::MessageTooLarge in case of requested size greater
+  /// max message size.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<std::span<std::byte>> tryPrepare(std::size_t size) noexcept {
+    if (size + sizeof(MessageHeader) > header_->maxMessageSize) [[unlikely]] {
+      return makeErrorCode(Error::MessageTooLarge);
+    }
+
+    if (producerPos_ - lastStagePosCache_ >= header_->length) [[unlikely]] {
+      lastStagePosCache_ = std::atomic_ref(lastStage_->pos).load(std::memory_order_acquire);
+      if (producerPos_ - lastStagePosCache_ >= header_->length) {
+        return std::span<std::byte>();
+      }
+    }
+
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(
+        data_ + (producerPos_ & (header_->length - 1)) * header_->maxMessageSize);
+    lastMessageHeader_->payloadSize = size;
+
+    return std::span<std::byte>(std::bit_cast<std::byte*>(lastMessageHeader_ + 1), size);
+  }
+
+  /// Publish reserved slot to the first stage
+  TURBOQ_FORCE_INLINE void commit() noexcept {
+    std::atomic_ref(header_->producerPos).store(++producerPos_, std::memory_order_release);
+  }
+
+  /// \overload
+  TURBOQ_FORCE_INLINE void commit(std::size_t size) noexcept {
+    if (size <= lastMessageHeader_->payloadSize) [[likely]] {
+      lastMessageHeader_->payloadSize = size;
+    } else {
+      assert(false);
+    }
+    commit();
+  }
+
+  /// Release reserved slot: nothing was published, next prepare() returns it again
+  TURBOQ_FORCE_INLINE void abort() noexcept {}
+
+  /// Swap resources with other producer
+  void swap(BoundedPipelineRawQueueProducer& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(lastStage_, that.lastStage_);
+    swap(data_, that.data_);
+    swap(producerPos_, that.producerPos_);
+    swap(lastStagePosCache_, that.lastStagePosCache_);
+    swap(lastMessageHeader_, that.lastMessageHeader_);
+  }
+
+  /// \see BoundedPipelineRawQueueProducer::swap
+  friend void swap(BoundedPipelineRawQueueProducer& a, BoundedPipelineRawQueueProducer& b) noexcept {
+    a.swap(b);
+  }
+};
+
+/// Pipeline queue stage: processes messages in place and releases them to the next stage
+template <typename Traits>
+class BoundedPipelineRawQueueStage {
+private:
+  using QueueDetail = BoundedPipelineRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using StageHeader = typename QueueDetail::StageHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  StageHeader* stage_ = nullptr;
+  std::size_t* upstreamPos_ = nullptr;
+  std::byte* data_ = nullptr;
+  std::size_t index_ = 0;
+  std::size_t pos_ = 0;
+  std::size_t upstreamPosCache_ = 0;
+
+public:
+  BoundedPipelineRawQueueStage() = default;
+  ~BoundedPipelineRawQueueStage() = default;
+
+  BoundedPipelineRawQueueStage(BoundedPipelineRawQueueStage&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPipelineRawQueueStage& operator=(BoundedPipelineRawQueueStage&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedPipelineRawQueueStage(MappedRegion&& storage, std::size_t index)
+      : storage_(std::move(storage)), index_(index) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    if (index_ >= header_->stages) {
+      throwError(Error::InvalidArgument, "stage");
+    }
+    stage_ = QueueDetail::stage(storage_.data(), index_);
+    upstreamPos_ = (index_ == 0) ? &header_->producerPos : &QueueDetail::stage(storage_.data(), index_ - 1)->pos;
+    data_ = storage_.data() + QueueDetail::dataStartPos(header_->stages);
+    pos_ = std::atomic_ref(stage_->pos).load(std::memory_order_acquire);
+    upstreamPosCache_ = std::atomic_ref(*upstreamPos_).load(std::memory_order_acquire);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return stage index
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t index() const noexcept {
+    return index_;
+  }
+
+  /// Return count of messages released by the previous stage and not yet processed
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t available() noexcept {
+    upstreamPosCache_ = std::atomic_ref(*upstreamPos_).load(std::memory_order_acquire);
+    return upstreamPosCache_ - pos_;
+  }
+
+  /// Get next message for in place processing. Return empty buffer in case of no data.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> fetch() noexcept {
+    if (pos_ == upstreamPosCache_) {
+      upstreamPosCache_ = std::atomic_ref(*upstreamPos_).load(std::memory_order_acquire);
+      if (pos_ == upstreamPosCache_) {
+        return {};
+      }
+    }
+    auto const message = messageHeader();
+    return {std::bit_cast<std::byte*>(message + 1), message->payloadSize};
+  }
+
+  /// Release front message to the next stage
+  /// pre: fetch() -> non empty buffer
+  TURBOQ_FORCE_INLINE void consume() noexcept {
+    std::atomic_ref(stage_->pos).store(++pos_, std::memory_order_release);
+  }
+
+  /// Release front message to the next stage with new payload size
+  /// \throw std::system_error in case of size greater max message size
+  TURBOQ_FORCE_INLINE void consume(std::size_t size) {
+    valueOrThrow(tryConsume(size));
+  }
+
+  /// \see consume(std::size_t). Return Error::MessageTooLarge in case of size
+  /// greater max message size (message isn't released).
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<> tryConsume(std::size_t size) noexcept {
+    if (size + sizeof(MessageHeader) > header_->maxMessageSize) [[unlikely]] {
+      return makeErrorCode(Error::MessageTooLarge);
+    }
+    messageHeader()->payloadSize = size;
+    consume();
+    return success();
+  }
+
+  /// Release all messages available to the stage without processing
+  TURBOQ_FORCE_INLINE void reset() noexcept {
+    upstreamPosCache_ = std::atomic_ref(*upstreamPos_).load(std::memory_order_acquire);
+    pos_ = upstreamPosCache_;
+    std::atomic_ref(stage_->pos).store(pos_, std::memory_order_release);
+  }
+
+  /// Swap resources with other stage
+  void swap(BoundedPipelineRawQueueStage& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(stage_, that.stage_);
+    swap(upstreamPos_, that.upstreamPos_);
+    swap(data_, that.data_);
+    swap(index_, that.index_);
+    swap(pos_, that.pos_);
+    swap(upstreamPosCache_, that.upstreamPosCache_);
+  }
+
+  /// \see BoundedPipelineRawQueueStage::swap
+  friend void swap(BoundedPipelineRawQueueStage& a, BoundedPipelineRawQueueStage& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  [[nodiscard]] TURBOQ_FORCE_INLINE MessageHeader* messageHeader() noexcept {
+    return std::bit_cast<MessageHeader*>(data_ + (pos_ & (header_->length - 1)) * header_->maxMessageSize);
+  }
+};
+
+} // namespace detail
+
+template <typename Traits>
+class BoundedPipelineRawQueueImpl;
+
+struct BoundedPipelineRawQueueDefaultTraits {
+  static constexpr std::string_view kTag = "turboq/Pipeline";
+  static constexpr std::size_t kSegmentSize = kHardwareDestructiveInterferenceSize;
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+};
+
+/// Multi-stage pipeline over one ring: every message is written once and processed in
+/// place by each stage in order.
+using BoundedPipelineRawQueue = BoundedPipelineRawQueueImpl<BoundedPipelineRawQueueDefaultTraits>;
+
+template <typename Traits>
+class BoundedPipelineRawQueueImpl {
+private:
+  using QueueDetail = detail::BoundedPipelineRawQueueDetail<Traits>;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  File file_;
+
+public:
+  using Producer = detail::BoundedPipelineRawQueueProducer<Traits>;
+  using Stage = detail::BoundedPipelineRawQueueStage<Traits>;
+
+  struct CreationOptions {
+    std::size_t stages;
+    std::size_t maxMessageSizeHint;
+    std::size_t lengthHint;
+  };
+
+  BoundedPipelineRawQueueImpl(BoundedPipelineRawQueueImpl const&) = delete;
+  BoundedPipelineRawQueueImpl& operator=(BoundedPipelineRawQueueImpl const&) = delete;
+  BoundedPipelineRawQueueImpl() = default;
+
+  BoundedPipelineRawQueueImpl(BoundedPipelineRawQueueImpl&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedPipelineRawQueueImpl& operator=(BoundedPipelineRawQueueImpl&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only queue. Throws on error.
+  BoundedPipelineRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedPipelineRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedPipelineRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedPipelineRawQueueImpl(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedPipelineRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    auto result = memorySource.open(name, MemorySource::OpenOnly);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedPipelineRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return queue;
+  }
+
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedPipelineRawQueueImpl> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (invalidOption(options)) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
+    }
+    auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+    if (!result) {
+      return makeErrorCode(Error::MemorySourceOpen);
+    }
+
+    BoundedPipelineRawQueueImpl queue;
+    std::size_t pageSize;
+    std::tie(queue.file_, pageSize) = std::move(result).value();
+
+    auto const maxMessageSize = QueueDetail::alignBufferSize(options.maxMessageSizeHint + sizeof(MessageHeader));
+    auto const length = detail::upper_pow_2(options.lengthHint);
+    // round-up requested size to page size
+    auto const capacity = detail::align_up(QueueDetail::bufferSize(options.stages, maxMessageSize, length), pageSize);
+
+    // init queue or check queue's options is the same as requested
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+    } else {
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content(), options.stages, maxMessageSize, length);
+    }
+    return queue;
+  }
+
+  /// Return true on queue intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create producer for the queue. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Producer(std::move(storage).value());
+  }
+
+  /// Create processor for the stage. Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Stage createStage(std::size_t index) {
+    return valueOrThrow(tryCreateStage(index), "stage");
+  }
+
+  /// Create processor for the stage.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Stage> tryCreateStage(std::size_t index) noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    if (index >= std::bit_cast<typename QueueDetail::MemoryHeader const*>(storage.value().data())->stages) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    // one byte lock per stage
+    auto const locked = file_.tryLockRangeNoThrow(index, 1);
+    if (!locked) {
+      return failure(locked.error());
+    }
+    if (!locked.value()) {
+      return makeErrorCode(Error::StageExists);
+    }
+    return Stage(std::move(storage).value(), index);
+  }
+
+  /// Swap resources with other queue.
+  void swap(BoundedPipelineRawQueueImpl& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+  }
+
+  /// \see BoundedPipelineRawQueueImpl::swap
+  friend void swap(BoundedPipelineRawQueueImpl& a, BoundedPipelineRawQueueImpl& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.stages == 0) {
+      return "stages";
+    }
+    if (options.maxMessageSizeHint == 0) {
+      return "max message size";
+    }
+    if (options.lengthHint == 0) {
+      return "length";
+    }
+    return nullptr;
+  }
+};
+
+} // namespace turboq
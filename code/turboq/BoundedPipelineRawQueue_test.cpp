@@ -0,0 +1,171 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "BoundedPipelineRawQueue.h"
+
+namespace turboq::testing {
+namespace {
+
+/// Message payload: sequence number and stages visited
+struct Message {
+  std::uint64_t sequence;
+  std::uint64_t stages;
+};
+
+bool enqueue(BoundedPipelineRawQueue::Producer& producer, std::uint64_t sequence) {
+  auto buffer = producer.prepare(sizeof(Message));
+  if (buffer.empty()) {
+    return false;
+  }
+  Message const message{sequence, 0};
+  std::memcpy(buffer.data(), &message, sizeof(message));
+  producer.commit();
+  return true;
+}
+
+/// Process front message in place, return its sequence number or -1 on no data
+std::int64_t process(BoundedPipelineRawQueue::Stage& stage) {
+  auto buffer = stage.fetch();
+  if (buffer.empty()) {
+    return -1;
+  }
+  REQUIRE(buffer.size() == sizeof(Message));
+  Message message;
+  std::memcpy(&message, buffer.data(), sizeof(message));
+  REQUIRE(message.stages == stage.index());
+  message.stages++;
+  std::memcpy(buffer.data(), &message, sizeof(message));
+  stage.consume();
+  return std::int64_t(message.sequence);
+}
+
+} // namespace
+
+TEST_CASE("BoundedPipelineRawQueue: stages order") {
+  BoundedPipelineRawQueue queue("test", {3, sizeof(Message), 4}, AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  std::vector<BoundedPipelineRawQueue::Stage> stages;
+  for (std::size_t index = 0; index < 3; ++index) {
+    stages.push_back(queue.createStage(index));
+  }
+
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+  // ring is full until the last stage releases a slot
+  REQUIRE_FALSE(enqueue(producer, 4));
+
+  // downstream stages see nothing before upstream stage releases
+  REQUIRE(process(stages[1]) == -1);
+  REQUIRE(process(stages[2]) == -1);
+
+  REQUIRE(stages[0].available() == 4);
+  REQUIRE(process(stages[0]) == 0);
+  REQUIRE(process(stages[0]) == 1);
+  REQUIRE(stages[1].available() == 2);
+  REQUIRE(process(stages[1]) == 0);
+  REQUIRE(process(stages[2]) == 0);
+  REQUIRE(process(stages[2]) == -1);
+
+  // the last stage released slot 0
+  REQUIRE(enqueue(producer, 4));
+  REQUIRE_FALSE(enqueue(producer, 5));
+
+  for (auto& stage : stages) {
+    while (process(stage) != -1) {}
+  }
+  REQUIRE(stages[2].available() == 0);
+  for (std::uint64_t i = 5; i < 9; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+}
+
+TEST_CASE("BoundedPipelineRawQueue: resize in place") {
+  BoundedPipelineRawQueue queue("test", {2, 64, 4}, AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto decode = queue.createStage(0);
+  auto send = queue.createStage(1);
+
+  auto buffer = producer.prepare(64);
+  REQUIRE(buffer.size() == 64);
+  std::memcpy(buffer.data(), "abc", 3);
+  producer.commit(3);
+
+  // first stage appends data for the next one
+  auto message = decode.fetch();
+  REQUIRE(message.size() == 3);
+  std::memcpy(message.data() + 3, "def", 3);
+  decode.consume(6);
+
+  message = send.fetch();
+  REQUIRE(message.size() == 6);
+  REQUIRE(std::memcmp(message.data(), "abcdef", 6) == 0);
+  send.consume();
+
+  REQUIRE_THROWS(producer.prepare(1024));
+}
+
+TEST_CASE("BoundedPipelineRawQueue: stage per process") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-pipeline-test");
+  };
+
+  BoundedPipelineRawQueue queue0("turboq-pipeline-test", {2, sizeof(Message), 16}, memorySource);
+  BoundedPipelineRawQueue queue1("turboq-pipeline-test", memorySource);
+
+  auto stage = queue0.createStage(0);
+  REQUIRE_THROWS(queue1.createStage(0));
+  REQUIRE_NOTHROW(queue1.createStage(1));
+  REQUIRE_THROWS(queue1.createStage(2));
+}
+
+TEST_CASE("BoundedPipelineRawQueue: threads") {
+  constexpr std::size_t kStages = 3;
+  constexpr std::int64_t kCount = 20000;
+
+  BoundedPipelineRawQueue queue("test", {kStages, sizeof(Message), 64}, AnonymousMemorySource());
+
+  std::vector<std::thread> threads;
+  for (std::size_t index = 0; index + 1 < kStages; ++index) {
+    threads.emplace_back([&queue, index] {
+      auto stage = queue.createStage(index);
+      for (std::int64_t expected = 0; expected < kCount;) {
+        if (auto const sequence = process(stage); sequence != -1) {
+          REQUIRE(sequence == expected++);
+        }
+      }
+    });
+  }
+  threads.emplace_back([&queue] {
+    auto producer = queue.createProducer();
+    for (std::int64_t i = 0; i < kCount; ++i) {
+      while (!enqueue(producer, i)) {}
+    }
+  });
+
+  auto last = queue.createStage(kStages - 1);
+  for (std::int64_t expected = 0; expected < kCount;) {
+    if (auto const sequence = process(last); sequence != -1) {
+      REQUIRE(sequence == expected++);
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace turboq::testing
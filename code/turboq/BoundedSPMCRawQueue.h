@@ -4,16 +4,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <bit>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <span>
 #include <string_view>
 #include <type_traits>
 
 #include <turboq/MappedRegion.h>
 #include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
 #include <turboq/detail/math.h>
 #include <turboq/detail/memory.h>
 #include <turboq/platform.h>
@@ -30,13 +35,57 @@ struct BoundedSPMCRawQueueDetail {
   static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
   /// Alignment
   static constexpr std::size_t kAlign = Traits::kAlign;
+  /// Named consumer cursor slots count
+  static constexpr std::size_t kCursorSlots = [] {
+    if constexpr (requires { Traits::kCursorSlots; }) {
+      return std::size_t(Traits::kCursorSlots);
+    } else {
+      return std::size_t(8);
+    }
+  }();
+  /// Max cursor name size including terminating zero
+  static constexpr std::size_t kCursorNameSize = 48;
+
+  /// Cursor slot states, any other state value is the claim time of the slot
+  /// being initialized (steady clock, nanoseconds)
+  static constexpr std::int64_t kCursorFree = 0;
+  static constexpr std::int64_t kCursorReady = -1;
+
+  /// Claim older than this is left by a crashed consumer and could be reclaimed
+  static constexpr std::int64_t kCursorClaimTimeout = std::chrono::nanoseconds(std::chrono::seconds(1)).count();
+
+  /// Named consumer cursor, written only by its consumer
+  struct CursorSlot {
+    /// Slot state
+    alignas(kAlign) std::int64_t state;
+    /// Zero terminated cursor name
+    char name[kCursorNameSize];
+    /// Checkpointed consumer position
+    std::size_t pos;
+
+    static_assert(std::atomic_ref<std::int64_t>::is_always_lock_free);
+  };
 
   /// Control struct for queue buffer
+  /// Positions are monotonic (lap * data size + offset), so consumer lag is
+  /// a difference of positions.
   struct MemoryHeader {
     /// Placeholder for queue tag
     char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
+    /// Cursor slots count the queue was created with
+    std::size_t cursorSlots;
     /// Producer position
     alignas(kAlign) std::size_t producerPos;
+    /// End of the region the producer is writing to
+    std::size_t producerReservedPos;
+    /// Number of committed messages
+    std::size_t producerCount;
+    /// Named consumer cursors
+    std::array<CursorSlot, kCursorSlots> cursors;
 
     static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
   };
@@ -47,6 +96,8 @@ struct BoundedSPMCRawQueueDetail {
     std::size_t size;
     std::size_t payloadOffset;
     std::size_t payloadSize;
+    /// Message sequence number (used to count messages behind)
+    std::size_t sequence;
   };
   static_assert(std::is_trivially_copyable_v<MessageHeader>);
 
@@ -71,6 +122,14 @@ struct BoundedSPMCRawQueueDetail {
     if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
       return false;
     }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
+    // refuse to attach to queue with different header layout
+    if (header->cursorSlots != kCursorSlots) {
+      return false;
+    }
     return true;
   }
 
@@ -78,6 +137,29 @@ struct BoundedSPMCRawQueueDetail {
   static void init(std::span<std::byte> buffer) noexcept {
     auto header = std::bit_cast<MemoryHeader*>(buffer.data());
     std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
+    header->cursorSlots = kCursorSlots;
+    std::atomic_ref(header->producerPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerReservedPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerCount).store(0, std::memory_order_relaxed);
+    for (auto& cursor : header->cursors) {
+      std::atomic_ref(cursor.state).store(kCursorFree, std::memory_order_relaxed);
+    }
+  }
+
+  /// Return true in case of data from pos wasn't overwritten by producer yet
+  [[nodiscard]] static TURBOQ_FORCE_INLINE bool available(
+      MemoryHeader* header, std::size_t dataSize, std::size_t pos) noexcept {
+    auto const producerPos = std::atomic_ref(header->producerPos).load(std::memory_order_acquire);
+    auto const reservedPos = std::atomic_ref(header->producerReservedPos).load(std::memory_order_relaxed);
+    return pos <= producerPos && reservedPos <= pos + dataSize;
+  }
+
+  /// Return steady clock time for cursor claims
+  [[nodiscard]] static TURBOQ_FORCE_INLINE std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
   }
 };
 
@@ -93,6 +175,8 @@ private:
   std::span<std::byte> data_;
   MemoryHeader* header_ = nullptr;
   std::size_t producerPosCache_ = 0;
+  std::size_t lapBase_ = 0;
+  std::size_t sequence_ = 0;
   MessageHeader* lastMessageHeader_ = nullptr;
 
 public:
@@ -112,12 +196,15 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(storage_.data());
     data_ = content.subspan(QueueDetail::kDataStartPos);
-    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    auto const producerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    lapBase_ = producerPos - producerPos % data_.size();
+    producerPosCache_ = producerPos - lapBase_;
+    sequence_ = std::atomic_ref(header_->producerCount).load(std::memory_order_relaxed);
   }
 
   /// Return true on initialized
@@ -134,28 +221,42 @@ public:
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::size_t size) noexcept {
     std::size_t const alignedSize = QueueDetail::alignBufferSize(size + sizeof(MessageHeader));
 
-    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
-    lastMessageHeader_->size = alignedSize - sizeof(MessageHeader);
-    lastMessageHeader_->payloadSize = size;
+    std::size_t messageSize = alignedSize - sizeof(MessageHeader);
+    std::size_t payloadOffset = producerPosCache_ + sizeof(MessageHeader);
+    std::size_t lapBase = lapBase_;
 
     if (producerPosCache_ + alignedSize + sizeof(MessageHeader) > data_.size()) [[unlikely]] {
-      lastMessageHeader_->size = QueueDetail::alignBufferSize(size);
-      producerPosCache_ = 0;
+      messageSize = QueueDetail::alignBufferSize(size);
+      payloadOffset = 0;
+      lapBase += data_.size();
       // TODO[???]:
       // lastMessageHeader_->size = detail::ceil(size, kHardwareDestructiveInterferenceSize)
-    } else {
-      producerPosCache_ += sizeof(MessageHeader);
     }
 
-    lastMessageHeader_->payloadOffset = producerPosCache_;
-    producerPosCache_ += lastMessageHeader_->size;
+    // Publish reserved region before overwriting it, pairs with QueueDetail::available.
+    // Never move it back: aborted reservation could have overwritten bytes up to it.
+    auto const reservedPos = std::max(std::atomic_ref(header_->producerReservedPos).load(std::memory_order_relaxed),
+        lapBase + payloadOffset + messageSize);
+    std::atomic_ref(header_->producerReservedPos).store(reservedPos, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
+    lastMessageHeader_->size = messageSize;
+    lastMessageHeader_->payloadSize = size;
+    lastMessageHeader_->payloadOffset = payloadOffset;
+    lastMessageHeader_->sequence = sequence_;
+
+    lapBase_ = lapBase;
+    producerPosCache_ = payloadOffset + messageSize;
 
     return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
   }
 
   /// Make reserved buffer visible for consumers
   TURBOQ_FORCE_INLINE void commit() noexcept {
-    std::atomic_ref(header_->producerPos).store(producerPosCache_, std::memory_order_release);
+    // count is stored first so it is never behind the position consumer acquires
+    std::atomic_ref(header_->producerCount).store(++sequence_, std::memory_order_relaxed);
+    std::atomic_ref(header_->producerPos).store(lapBase_ + producerPosCache_, std::memory_order_release);
   }
 
   /// \overload
@@ -169,6 +270,17 @@ public:
     commit();
   }
 
+  /// Release reservation made by the last prepare()
+  /// pre: prepare() -> non empty buffer, not committed
+  TURBOQ_FORCE_INLINE void abort() noexcept {
+    auto const offset = std::size_t(std::bit_cast<std::byte*>(lastMessageHeader_) - data_.data());
+    // payload of the message wrapped to the data start doesn't follow its header
+    if (lastMessageHeader_->payloadOffset != offset + sizeof(MessageHeader)) {
+      lapBase_ -= data_.size();
+    }
+    producerPosCache_ = offset;
+  }
+
   /// Swap resources with other producer
   void swap(BoundedSPMCRawQueueProducer& that) noexcept {
     using std::swap;
@@ -176,6 +288,8 @@ public:
     swap(data_, that.data_);
     swap(header_, that.header_);
     swap(producerPosCache_, that.producerPosCache_);
+    swap(lapBase_, that.lapBase_);
+    swap(sequence_, that.sequence_);
     swap(lastMessageHeader_, that.lastMessageHeader_);
   }
 
@@ -192,13 +306,19 @@ private:
   using QueueDetail = BoundedSPMCRawQueueDetail<Traits>;
   using MemoryHeader = typename QueueDetail::MemoryHeader;
   using MessageHeader = typename QueueDetail::MessageHeader;
+  using CursorSlot = typename QueueDetail::CursorSlot;
 
   MappedRegion storage_;
   std::span<std::byte> data_;
   MemoryHeader* header_ = nullptr;
   std::size_t consumerPosCache_ = 0;
   std::size_t producerPosCache_ = 0;
+  std::size_t lapBase_ = 0;
   MessageHeader* lastMessageHeader_ = nullptr;
+  CursorSlot* cursor_ = nullptr;
+  std::size_t sequence_ = 0;
+  bool synchronized_ = false;
+  bool resumed_ = false;
 
 public:
   BoundedSPMCRawQueueConsumer() = default;
@@ -217,13 +337,57 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(content.data());
     data_ = content.subspan(QueueDetail::kDataStartPos);
-    consumerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed);
-    producerPosCache_ = consumerPosCache_;
+    reset();
+  }
+
+  /// Construct consumer bound to named cursor. Throws on error.
+  /// \see bindCursor
+  BoundedSPMCRawQueueConsumer(MappedRegion&& storage, std::string_view cursorName)
+      : BoundedSPMCRawQueueConsumer(std::move(storage)) {
+    valueOrThrow(bindCursor(cursorName));
+  }
+
+  /// Bind consumer to named cursor. Resume from the cursor checkpoint in case of
+  /// the data wasn't overwritten yet, start from producer position otherwise.
+  [[nodiscard]] Result<> bindCursor(std::string_view cursorName) noexcept {
+    if (cursorName.empty() || cursorName.size() >= QueueDetail::kCursorNameSize) {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+
+    if (cursor_ = findCursor(header_, cursorName); cursor_) {
+      auto const pos = std::atomic_ref(cursor_->pos).load(std::memory_order_relaxed);
+      if (QueueDetail::available(header_, data_.size(), pos)) {
+        setPosition(pos);
+        resumed_ = true;
+      } else {
+        checkpoint();
+      }
+      return success();
+    }
+
+    auto const now = QueueDetail::now();
+    for (auto& cursor : header_->cursors) {
+      auto state = std::atomic_ref(cursor.state).load(std::memory_order_relaxed);
+      // slot claimed long ago was left half initialized by a crashed consumer
+      bool const vacant = state == QueueDetail::kCursorFree ||
+                          (state != QueueDetail::kCursorReady && now - state >= QueueDetail::kCursorClaimTimeout);
+      if (!vacant || !std::atomic_ref(cursor.state).compare_exchange_strong(state, now, std::memory_order_acquire)) {
+        continue;
+      }
+      std::fill(std::begin(cursor.name), std::end(cursor.name), '\0');
+      std::copy(cursorName.begin(), cursorName.end(), cursor.name);
+      cursor_ = &cursor;
+      checkpoint();
+      std::atomic_ref(cursor.state).store(QueueDetail::kCursorReady, std::memory_order_release);
+      return success();
+    }
+
+    return makeErrorCode(Error::NoFreeCursor);
   }
 
   /// Return true on initialized
@@ -236,6 +400,51 @@ public:
     return storage_.size();
   }
 
+  /// Return true in case of consumer resumed from its named cursor checkpoint
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool resumed() const noexcept {
+    return resumed_;
+  }
+
+  /// Return number of bytes the consumer is behind the producer, zero for empty queue
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t lag() const noexcept {
+    return std::atomic_ref(header_->producerPos).load(std::memory_order_acquire) - consumerPosCache_;
+  }
+
+  /// Return true in case of producer overwrote messages the consumer hasn't read yet
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool lapped() const noexcept {
+    return !QueueDetail::available(header_, data_.size(), consumerPosCache_);
+  }
+
+  /// Return number of committed messages not consumed yet, including overwritten
+  /// ones. Exact after the first consume() following construction or reset(),
+  /// number of all committed messages before that in case of lapped.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t messagesBehind() const noexcept {
+    auto const producerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    auto const count = std::atomic_ref(header_->producerCount).load(std::memory_order_relaxed);
+    if (synchronized_) [[likely]] {
+      // sequence of a lapped message could be ahead of the count
+      return count - std::min(count, sequence_);
+    }
+    if (consumerPosCache_ == producerPos) {
+      return 0;
+    }
+    // header could be overwritten at any moment, validate the copy against the
+    // producer reservation (pairs with the fence in prepare())
+    MessageHeader const message = *std::bit_cast<MessageHeader const*>(data_.data() + (consumerPosCache_ - lapBase_));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!QueueDetail::available(header_, data_.size(), consumerPosCache_)) [[unlikely]] {
+      // lapped, all committed messages is the upper bound
+      return count;
+    }
+    return count - std::min(count, message.sequence);
+  }
+
+  /// Return shared producer position word. It changes whenever new messages
+  /// could be fetched, so it could be polled before calling fetch().
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t const* producerPosition() const noexcept {
+    return &header_->producerPos;
+  }
+
   /// Get next buffer for reading. Return empty buffer in case of no data.
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
     if (producerPosCache_ == consumerPosCache_ &&
@@ -244,20 +453,33 @@ public:
       return {};
     }
 
-    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + consumerPosCache_);
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + (consumerPosCache_ - lapBase_));
     return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
   }
 
   /// Consume buffer and make buffer space available for producer
   /// pre: fetch() -> non empty buffer
   TURBOQ_FORCE_INLINE void consume() noexcept {
-    consumerPosCache_ = lastMessageHeader_->payloadOffset + lastMessageHeader_->size;
+    // payload of the message wrapped to the data start doesn't follow its header
+    if (lastMessageHeader_->payloadOffset != consumerPosCache_ - lapBase_ + sizeof(MessageHeader)) [[unlikely]] {
+      lapBase_ += data_.size();
+    }
+    consumerPosCache_ = lapBase_ + lastMessageHeader_->payloadOffset + lastMessageHeader_->size;
+    sequence_ = lastMessageHeader_->sequence + 1;
+    synchronized_ = true;
   }
 
   /// Reset queue
   TURBOQ_FORCE_INLINE void reset() noexcept {
-    consumerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed);
-    producerPosCache_ = consumerPosCache_;
+    setPosition(std::atomic_ref(header_->producerPos).load(std::memory_order_acquire));
+  }
+
+  /// Store current position to the named cursor. Relaxed store to the cursor's
+  /// own cache line, call after the consumed messages were processed.
+  /// pre: consumer bound to named cursor
+  TURBOQ_FORCE_INLINE void checkpoint() noexcept {
+    assert(cursor_);
+    std::atomic_ref(cursor_->pos).store(consumerPosCache_, std::memory_order_relaxed);
   }
 
   /// Swap resources with other object
@@ -268,13 +490,37 @@ public:
     swap(header_, that.header_);
     swap(consumerPosCache_, that.consumerPosCache_);
     swap(producerPosCache_, that.producerPosCache_);
+    swap(lapBase_, that.lapBase_);
     swap(lastMessageHeader_, that.lastMessageHeader_);
+    swap(cursor_, that.cursor_);
+    swap(sequence_, that.sequence_);
+    swap(synchronized_, that.synchronized_);
+    swap(resumed_, that.resumed_);
   }
 
   /// \see BoundedSPMCRawQueueConsumer::swap
   friend void swap(BoundedSPMCRawQueueConsumer& a, BoundedSPMCRawQueueConsumer& b) noexcept {
     a.swap(b);
   }
+
+  /// Return cursor slot with name or nullptr
+  [[nodiscard]] static CursorSlot* findCursor(MemoryHeader* header, std::string_view name) noexcept {
+    for (auto& cursor : header->cursors) {
+      if (std::atomic_ref(cursor.state).load(std::memory_order_acquire) == QueueDetail::kCursorReady &&
+          name == std::string_view(cursor.name)) {
+        return &cursor;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  TURBOQ_FORCE_INLINE void setPosition(std::size_t pos) noexcept {
+    consumerPosCache_ = pos;
+    producerPosCache_ = pos;
+    lapBase_ = pos - pos % data_.size();
+    synchronized_ = false;
+  }
 };
 
 } // namespace detail
@@ -330,46 +576,81 @@ public:
   }
 
   /// Open only queue. Throws on error.
-  BoundedSPMCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) {
+  BoundedSPMCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedSPMCRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedSPMCRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedSPMCRawQueueImpl(valueOrThrow(create(name, options, memorySource))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedSPMCRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
     auto result = memorySource.open(name, MemorySource::OpenOnly);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
 
+    BoundedSPMCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
-    if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-      throw std::runtime_error("failed to open queue (invalid)");
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
     }
+    return queue;
   }
 
-  /// Open or create queue. Throws on error.
-  BoundedSPMCRawQueueImpl(
-      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource()) {
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedSPMCRawQueueImpl> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
+    }
     auto result = memorySource.open(name, MemorySource::OpenOrCreate);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
 
+    BoundedSPMCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
     // round-up requested size to page size
     std::size_t const capacity = detail::align_up(options.capacityHint, pageSize);
 
     // init queue or check queue's options is the same as requested
-    if (auto const fileSize = file_.getFileSize(); fileSize != 0) {
-      if (fileSize != capacity) {
-        throw std::runtime_error("size mismatch");
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
       }
-      if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-        throw std::runtime_error("failed to open queue (invalid)");
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
       }
     } else {
-      file_.truncate(capacity);
-      QueueDetail::init(detail::mapFile(file_, capacity).content());
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content());
     }
+    return queue;
   }
 
   /// Return true on queue intialized.
@@ -379,21 +660,95 @@ public:
 
   /// Create producer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue not initialized");
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto const locked = file_.tryLockNoThrow();
+    if (!locked) {
+      return failure(locked.error());
     }
-    if (!file_.tryLock()) {
-      throw std::runtime_error("can't create producer (already exists?)");
+    if (!locked.value()) {
+      return makeErrorCode(Error::ProducerExists);
     }
-    return Producer(detail::mapFile(file_));
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Producer(std::move(storage).value());
   }
 
   /// Create consumer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer() {
+    return valueOrThrow(tryCreateConsumer());
+  }
+
+  /// Create consumer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue not initialized");
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Consumer(std::move(storage).value());
+  }
+
+  /// Create consumer bound to named cursor. Only one consumer should use the
+  /// cursor at a time. Throws on error.
+  /// \see BoundedSPMCRawQueueConsumer::resumed
+  [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer(std::string_view cursorName) {
+    return valueOrThrow(tryCreateConsumer(cursorName));
+  }
+
+  /// Create consumer bound to named cursor.
+  /// \see createConsumer(std::string_view)
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer(std::string_view cursorName) noexcept {
+    auto consumer = tryCreateConsumer();
+    if (!consumer) {
+      return failure(consumer.error());
+    }
+    if (auto bound = consumer.value().bindCursor(cursorName); !bound) {
+      return failure(bound.error());
     }
-    return Consumer(detail::mapFile(file_));
+    return consumer;
+  }
+
+  /// Release named cursor slot. Return false in case of cursor not found.
+  /// Throws on error.
+  bool removeCursor(std::string_view cursorName) {
+    return valueOrThrow(tryRemoveCursor(cursorName));
+  }
+
+  /// Release named cursor slot. Return false in case of cursor not found.
+  Result<bool> tryRemoveCursor(std::string_view cursorName) noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    auto const cursor = Consumer::findCursor(std::bit_cast<MemoryHeader*>(storage.value().data()), cursorName);
+    if (!cursor) {
+      return false;
+    }
+    std::atomic_ref(cursor->state).store(QueueDetail::kCursorFree, std::memory_order_release);
+    return true;
   }
 
   /// Swap resources with other queue.
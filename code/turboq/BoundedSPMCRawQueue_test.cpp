@@ -2,8 +2,13 @@
 // SPDX-License-Identifier: AGPL-3.0
 
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <tuple>
+#include <utility>
 
+#include <boost/scope_exit.hpp>
 #include <doctest/doctest.h>
 
 #include "BoundedSPMCRawQueue.h"
@@ -47,4 +52,239 @@ TEST_CASE("BoundedSPMCRawQueue: basic") {
   REQUIRE(value == std::uint64_t(-1));
 }
 
+TEST_CASE("BoundedSPMCRawQueue: wrap") {
+  BoundedSPMCRawQueue queue("test", BoundedSPMCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  for (std::uint64_t i = 0; i < 10000; ++i) {
+    REQUIRE(enqueue(producer, i));
+    std::uint64_t value = std::uint64_t(-1);
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == i);
+  }
+  std::uint64_t value;
+  REQUIRE(!dequeue(consumer, value));
+}
+
+TEST_CASE("BoundedSPMCRawQueue: abort") {
+  BoundedSPMCRawQueue queue("test", BoundedSPMCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::uint64_t value = std::uint64_t(-1);
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    auto buffer = producer.prepare(100);
+    REQUIRE(!buffer.empty());
+    std::memcpy(buffer.data(), &i, sizeof(i));
+    if (i % 3 == 0) {
+      producer.abort();
+      continue;
+    }
+    producer.commit();
+
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == i);
+    REQUIRE(!dequeue(consumer, value));
+  }
+}
+
+TEST_CASE("BoundedSPMCRawQueue: lag") {
+  BoundedSPMCRawQueue queue("test", BoundedSPMCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer1 = queue.createConsumer();
+  auto consumer2 = queue.createConsumer();
+
+  REQUIRE(consumer1.lag() == 0);
+  REQUIRE(consumer1.messagesBehind() == 0);
+
+  std::uint64_t value = 0;
+  for (std::uint64_t i = 0; i < 10; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+  REQUIRE(consumer1.messagesBehind() == 10);
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    REQUIRE(dequeue(consumer1, value));
+  }
+  REQUIRE(consumer1.messagesBehind() == 6);
+  REQUIRE(consumer2.messagesBehind() == 10);
+  REQUIRE(consumer2.lag() > consumer1.lag());
+  REQUIRE(!consumer2.lapped());
+
+  // consumer1 keeps up across many laps, consumer2 is overrun
+  for (std::uint64_t i = 0; i < 6; ++i) {
+    REQUIRE(dequeue(consumer1, value));
+  }
+  for (std::uint64_t i = 10; i < 1000; ++i) {
+    REQUIRE(enqueue(producer, i));
+    REQUIRE(consumer1.messagesBehind() == 1);
+    REQUIRE(dequeue(consumer1, value));
+    REQUIRE(value == i);
+    REQUIRE(consumer1.lag() == 0);
+  }
+  REQUIRE(consumer2.lapped());
+  REQUIRE(consumer2.lag() > 4096);
+  // header at the lapped position was overwritten, all messages are behind
+  REQUIRE(consumer2.messagesBehind() == 1000);
+
+  consumer2.reset();
+  REQUIRE(!consumer2.lapped());
+  REQUIRE(consumer2.lag() == 0);
+  REQUIRE(consumer2.messagesBehind() == 0);
+}
+
+TEST_CASE("BoundedSPMCRawQueue: abort") {
+  BoundedSPMCRawQueue queue("test", BoundedSPMCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  REQUIRE(enqueue(producer, std::uint64_t(0)));
+  auto const fetched = consumer.fetch();
+  REQUIRE(!fetched.empty());
+
+  // aborted reservation wraps to the data start over the fetched message
+  for (std::byte* last = nullptr;;) {
+    auto buffer = producer.prepare(256);
+    REQUIRE(!buffer.empty());
+    if (std::exchange(last, buffer.data()) > buffer.data()) {
+      std::memset(buffer.data(), 0xff, buffer.size());
+      producer.abort();
+      break;
+    }
+    producer.commit();
+  }
+
+  // smaller reservation doesn't hide the overwrite
+  REQUIRE(enqueue(producer, std::uint64_t(1)));
+  REQUIRE(consumer.lapped());
+}
+
+TEST_CASE("BoundedSPMCRawQueue: named cursor") {
+  BoundedSPMCRawQueue queue("test", BoundedSPMCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  for (std::uint64_t i = 0; i < 10; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+
+  SUBCASE("resume") {
+    {
+      auto consumer = queue.createConsumer("reader");
+      REQUIRE(!consumer.resumed());
+    }
+
+    // cursor created at the producer position, new messages are visible after restart
+    for (std::uint64_t i = 10; i < 20; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+    {
+      auto consumer = queue.createConsumer("reader");
+      REQUIRE(consumer.resumed());
+      for (std::uint64_t i = 10; i < 15; ++i) {
+        std::uint64_t value = std::uint64_t(-1);
+        REQUIRE(dequeue(consumer, value));
+        REQUIRE(value == i);
+        consumer.checkpoint();
+      }
+    }
+
+    // other cursors are independent
+    auto other = queue.createConsumer("other");
+    REQUIRE(!other.resumed());
+    std::uint64_t value;
+    REQUIRE(!dequeue(other, value));
+
+    auto consumer = queue.createConsumer("reader");
+    REQUIRE(consumer.resumed());
+    for (std::uint64_t i = 15; i < 20; ++i) {
+      value = std::uint64_t(-1);
+      REQUIRE(dequeue(consumer, value));
+      REQUIRE(value == i);
+    }
+    REQUIRE(!dequeue(consumer, value));
+  }
+
+  SUBCASE("overwritten") {
+    {
+      auto consumer = queue.createConsumer("reader");
+      REQUIRE(!consumer.resumed());
+    }
+
+    // lap the ring so the checkpoint is overwritten
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+
+    auto consumer = queue.createConsumer("reader");
+    REQUIRE(!consumer.resumed());
+    std::uint64_t value;
+    REQUIRE(!dequeue(consumer, value));
+
+    REQUIRE(enqueue(producer, std::uint64_t(42)));
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == 42);
+  }
+
+  SUBCASE("remove") {
+    { auto consumer = queue.createConsumer("reader"); }
+    REQUIRE(queue.removeCursor("reader"));
+    REQUIRE(!queue.removeCursor("reader"));
+    REQUIRE(!queue.tryRemoveCursor("reader").value());
+    REQUIRE(!BoundedSPMCRawQueue().tryRemoveCursor("reader"));
+  }
+
+  SUBCASE("slots") {
+    REQUIRE_THROWS(queue.createConsumer(""));
+    REQUIRE_THROWS(queue.createConsumer(std::string(100, 'x')));
+    for (int i = 0; i < 8; ++i) {
+      std::ignore = queue.createConsumer("reader" + std::to_string(i));
+    }
+    REQUIRE_THROWS(queue.createConsumer("reader8"));
+    REQUIRE_NOTHROW(queue.createConsumer("reader0"));
+  }
+}
+
+struct BoundedSPMCRawQueueFewCursorsTraits : BoundedSPMCRawQueueDefaultTraits {
+  static constexpr std::size_t kCursorSlots = 4;
+};
+
+TEST_CASE("BoundedSPMCRawQueue: cursor slots") {
+  using QueueDetail = detail::BoundedSPMCRawQueueDetail<BoundedSPMCRawQueueDefaultTraits>;
+  using MemoryHeader = QueueDetail::MemoryHeader;
+
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-spmc-test");
+  };
+
+  BoundedSPMCRawQueue queue("turboq-spmc-test", BoundedSPMCRawQueue::CreationOptions(4096), memorySource);
+
+  // header laid out for different cursor slots count
+  using FewCursorsQueue = BoundedSPMCRawQueueImpl<BoundedSPMCRawQueueFewCursorsTraits>;
+  REQUIRE_THROWS(FewCursorsQueue("turboq-spmc-test", memorySource));
+
+  for (int i = 0; i < 8; ++i) {
+    std::ignore = queue.createConsumer("reader" + std::to_string(i));
+  }
+  REQUIRE(queue.removeCursor("reader0"));
+
+  auto [file, pageSize] = memorySource.open("turboq-spmc-test", MemorySource::OpenOnly).value();
+  auto storage = detail::mapFile(file);
+  auto& state = std::bit_cast<MemoryHeader*>(storage.data())->cursors[0].state;
+
+  // slot being claimed by live consumer is not reused
+  state = QueueDetail::now();
+  REQUIRE_THROWS(queue.createConsumer("reader8"));
+
+  // slot claimed by crashed consumer is reclaimed
+  state = QueueDetail::now() - QueueDetail::kCursorClaimTimeout;
+  REQUIRE_NOTHROW(queue.createConsumer("reader8"));
+  REQUIRE(state == QueueDetail::kCursorReady);
+}
+
 } // namespace turboq::testing
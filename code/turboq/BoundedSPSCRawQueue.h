@@ -7,13 +7,22 @@
 #include <atomic>
 #include <bit>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <span>
 #include <string_view>
 #include <type_traits>
 
+#include <turboq/FlightRecorder.h>
 #include <turboq/MappedRegion.h>
 #include <turboq/MemorySource.h>
+#include <turboq/ReadinessBitmap.h>
+#include <turboq/Result.h>
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/futex.h>
 #include <turboq/detail/math.h>
 #include <turboq/detail/memory.h>
 #include <turboq/platform.h>
@@ -30,27 +39,95 @@ struct BoundedSPSCRawQueueDetail {
   static constexpr std::size_t kSegmentSize = Traits::kSegmentSize;
   /// Alignment
   static constexpr std::size_t kAlign = Traits::kAlign;
+  /// Overwrite oldest messages instead of failing when the queue is full
+  static constexpr bool kOverwriteOldest = [] {
+    if constexpr (requires { Traits::kOverwriteOldest; }) {
+      return bool(Traits::kOverwriteOldest);
+    } else {
+      return false;
+    }
+  }();
+  /// Producer could sleep on full queue until consumer frees space
+  static constexpr bool kProducerWait = [] {
+    if constexpr (requires { Traits::kProducerWait; }) {
+      return bool(Traits::kProducerWait);
+    } else {
+      return false;
+    }
+  }();
+  static_assert(!(kOverwriteOldest && kProducerWait), "overwrite mode producer never waits");
+  static_assert(std::has_single_bit(kSegmentSize) && kSegmentSize > 1, "segment size must be power of two");
+
+  /// Positions are multiple of segment size, consumer position word keeps the
+  /// consumer ownership epoch in the low bits. Epoch has log2(kSegmentSize)
+  /// bits and wraps, so owner stalled for that many takeovers sees its epoch
+  /// again and considers itself the owner.
+  static constexpr std::size_t kEpochMask = kSegmentSize - 1;
 
   /// Control struct for queue buffer
+  /// Positions are monotonic (lap * data size + offset), so depth and lag are
+  /// differences of positions.
   struct MemoryHeader {
     /// Placeholder for queue tag
     char tag[kTag.size()];
+    /// Segment size the queue was created with
+    std::size_t segmentSize;
+    /// Alignment the queue was created with
+    std::size_t align;
     /// Producer position
     alignas(kAlign) std::size_t producerPos;
-    /// Consumer position
+    /// Number of committed messages
+    std::size_t producerCount;
+    /// End of the region the producer is writing to (overwrite mode only)
+    std::size_t producerReservedPos;
+    /// Position of the last committed message (overwrite mode only)
+    std::size_t producerLastPos;
+    /// Position of the last message wrapped to the data start (overwrite mode only)
+    std::size_t producerWrapPos;
+    /// Consumer position and ownership epoch (low bits)
     alignas(kAlign) std::size_t consumerPos;
+    /// Number of consumed messages (non overwrite mode only)
+    std::size_t consumerCount;
+    /// Free space producer waits for (wait mode only)
+    std::size_t producerWakeThreshold;
+    /// Producer sleeps on this word (wait mode only)
+    std::uint32_t producerWaiting;
+    /// Owning consumer heartbeat (steady clock, nanoseconds), kVacantHeartbeat
+    /// in case of no owner
+    alignas(kAlign) std::int64_t consumerHeartbeat;
 
     static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+    static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
   };
   static_assert(std::is_trivially_copyable_v<MemoryHeader>);
 
+  /// Heartbeat of vacant consumer role, always expired
+  static constexpr std::int64_t kVacantHeartbeat = std::numeric_limits<std::int64_t>::min();
+
+  /// Payload size marking message released out of order but not yet passed by
+  /// the consumer position
+  static constexpr std::size_t kReleased = std::size_t(-1);
+
   /// Control struct for message
-  struct MessageHeader {
+  struct PlainMessageHeader {
+    std::size_t size;
+    std::size_t payloadOffset;
+    std::size_t payloadSize;
+  };
+  static_assert(std::is_trivially_copyable_v<PlainMessageHeader>);
+
+  /// Control struct for message in overwrite mode
+  struct SequencedMessageHeader {
     std::size_t size;
     std::size_t payloadOffset;
     std::size_t payloadSize;
+    /// Message sequence number (used to count dropped messages)
+    std::size_t sequence;
   };
-  static_assert(std::is_trivially_copyable_v<MessageHeader>);
+  static_assert(std::is_trivially_copyable_v<SequencedMessageHeader>);
+
+  /// Control struct for message
+  using MessageHeader = std::conditional_t<kOverwriteOldest, SequencedMessageHeader, PlainMessageHeader>;
 
   /// Align message buffer size
   static constexpr std::size_t alignBufferSize(std::size_t value) noexcept {
@@ -73,6 +150,10 @@ struct BoundedSPSCRawQueueDetail {
     if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
       return false;
     }
+    // refuse to attach to queue laid out for different cache line size
+    if (header->segmentSize != kSegmentSize || header->align != kAlign) {
+      return false;
+    }
     return true;
   }
 
@@ -80,8 +161,29 @@ struct BoundedSPSCRawQueueDetail {
   static void init(std::span<std::byte> buffer) noexcept {
     auto header = std::bit_cast<MemoryHeader*>(buffer.data());
     std::copy(kTag.begin(), kTag.end(), header->tag);
+    header->segmentSize = kSegmentSize;
+    header->align = kAlign;
     std::atomic_ref(header->producerPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerCount).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerReservedPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerLastPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerWrapPos).store(0, std::memory_order_relaxed);
     std::atomic_ref(header->consumerPos).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->consumerCount).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerWakeThreshold).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->producerWaiting).store(0, std::memory_order_relaxed);
+    std::atomic_ref(header->consumerHeartbeat).store(kVacantHeartbeat, std::memory_order_relaxed);
+  }
+
+  /// Return position from consumer position word
+  [[nodiscard]] static constexpr std::size_t position(std::size_t word) noexcept {
+    return word & ~kEpochMask;
+  }
+
+  /// Return steady clock time for heartbeats
+  [[nodiscard]] static TURBOQ_FORCE_INLINE std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
   }
 };
 
@@ -99,6 +201,13 @@ private:
   std::size_t producerPosCache_ = 0;
   std::size_t minFreeSpace_ = 0;
   MessageHeader* lastMessageHeader_ = nullptr;
+  std::size_t lapBase_ = 0;
+  std::size_t lastPos_ = 0;
+  std::size_t sequence_ = 0;
+  std::size_t prevWrapPos_ = 0;
+  std::size_t batchPos_ = 0;
+  FlightRecorderWriter* recorder_ = nullptr;
+  ReadinessBitmapNotifier* notifier_ = nullptr;
 
 public:
   BoundedSPSCRawQueueProducer() = default;
@@ -117,20 +226,33 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(content.data());
     data_ = content.subspan(QueueDetail::kDataStartPos);
     producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    lapBase_ = producerPosCache_ - producerPosCache_ % data_.size();
+    sequence_ = std::atomic_ref(header_->producerCount).load(std::memory_order_relaxed);
+
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      if (producerPosCache_ != 0) {
+        // continue numbering after the last committed message
+        lastPos_ = std::atomic_ref(header_->producerLastPos).load(std::memory_order_relaxed);
+        auto const lastMessageOffset = lastPos_ % data_.size();
+        sequence_ = std::bit_cast<MessageHeader const*>(data_.data() + lastMessageOffset)->sequence + 1;
+      }
+      return;
+    }
 
-    auto const consumerPos = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
-    if (consumerPos > producerPosCache_) {
-      // queue is empty in case of consumerPos == producerPos
-      minFreeSpace_ = consumerPos - producerPosCache_ - 1;
+    auto const consumerPos =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire));
+    if (consumerPos < lapBase_) {
+      // consumer is on the previous lap
+      minFreeSpace_ = consumerPos + data_.size() - producerPosCache_ - 1;
     } else {
       // Reserve space at end for last MessageHeader
-      minFreeSpace_ = data_.size() - producerPosCache_ - sizeof(MessageHeader);
+      minFreeSpace_ = data_.size() - (producerPosCache_ - lapBase_) - sizeof(MessageHeader);
     }
   }
 
@@ -141,83 +263,228 @@ public:
 
   /// Reserve contiguous space for writing without making it visible to the
   /// consumers. Return empty buffer on error
+  /// In overwrite mode never waits for the consumer and fails only in case of
+  /// the message doesn't fit the queue.
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepare(std::size_t size) noexcept {
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      return prepareOverwrite(size);
+    }
+
     std::size_t const alignedSize = QueueDetail::alignBufferSize(size + sizeof(MessageHeader));
 
     if (alignedSize <= minFreeSpace_) [[likely]] {
-      lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
-      lastMessageHeader_->size = alignedSize - sizeof(MessageHeader);
-      lastMessageHeader_->payloadSize = size;
-      lastMessageHeader_->payloadOffset = producerPosCache_ + sizeof(MessageHeader);
-      producerPosCache_ += alignedSize;
-      minFreeSpace_ -= alignedSize;
-
-      return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
+      return reserve(alignedSize, size);
     }
 
-    auto const consumerPosCache = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
+    auto const consumerPosCache =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire));
 
-    if (consumerPosCache > producerPosCache_) {
-      // queue is empty in case of consumerPos == producerPos
-      minFreeSpace_ = consumerPosCache - producerPosCache_ - 1;
+    if (consumerPosCache < lapBase_) {
+      // consumer is on the previous lap, queue is empty in case of consumerPos == producerPos
+      minFreeSpace_ = consumerPosCache + data_.size() - producerPosCache_ - 1;
 
       if (alignedSize <= minFreeSpace_) [[likely]] {
-        lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
-        lastMessageHeader_->size = alignedSize - sizeof(MessageHeader);
-        lastMessageHeader_->payloadSize = size;
-        lastMessageHeader_->payloadOffset = producerPosCache_ + sizeof(MessageHeader);
-        producerPosCache_ += alignedSize;
-        minFreeSpace_ -= alignedSize;
-
-        return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
+        return reserve(alignedSize, size);
       }
     } else {
-      assert(sizeof(MessageHeader) <= (data_.size() - producerPosCache_));
+      assert(sizeof(MessageHeader) <= (data_.size() - (producerPosCache_ - lapBase_)));
 
-      minFreeSpace_ = data_.size() - producerPosCache_ - sizeof(MessageHeader);
+      minFreeSpace_ = data_.size() - (producerPosCache_ - lapBase_) - sizeof(MessageHeader);
 
       if (alignedSize <= minFreeSpace_) [[likely]] {
-        lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
-        lastMessageHeader_->size = alignedSize - sizeof(MessageHeader);
-        lastMessageHeader_->payloadSize = size;
-        lastMessageHeader_->payloadOffset = producerPosCache_ + sizeof(MessageHeader);
-        producerPosCache_ += alignedSize;
-        minFreeSpace_ -= alignedSize;
-
-        return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
+        return reserve(alignedSize, size);
       }
 
       // align payload to cache-line size when payload starts from begining
       std::size_t const alignedSize2 = QueueDetail::alignBufferSize(size);
-      if (alignedSize2 < consumerPosCache) {
-        lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + producerPosCache_);
+      if (alignedSize2 < consumerPosCache - lapBase_) {
+        lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + (producerPosCache_ - lapBase_));
         lastMessageHeader_->size = alignedSize2;
         lastMessageHeader_->payloadSize = size;
         lastMessageHeader_->payloadOffset = 0;
-        producerPosCache_ = lastMessageHeader_->size;
-        minFreeSpace_ = consumerPosCache - producerPosCache_ - 1;
-
+        lapBase_ += data_.size();
+        producerPosCache_ = lapBase_ + alignedSize2;
+        minFreeSpace_ = consumerPosCache + data_.size() - producerPosCache_ - 1;
+
+        if (recorder_) [[unlikely]] {
+          recorder_->slowPath(FlightEvent::Wrap, producerPosCache_, [this] {
+            return peerPosition();
+          });
+        }
         return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
       }
     }
 
+    if (recorder_) [[unlikely]] {
+      recorder_->slowPath(FlightEvent::Full, producerPosCache_, [this] {
+        return peerPosition();
+      });
+    }
     return {};
   }
 
+  /// Reserve space like prepare(), sleeping while the queue is full.
+  /// Consumer wakes producer once free space reaches max(requested, wakeThreshold)
+  /// bytes. Return empty buffer on timeout.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepareWait(std::size_t size,
+      std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max(), std::size_t wakeThreshold = 0) noexcept
+    requires QueueDetail::kProducerWait
+  {
+    if (auto buffer = prepare(size); !buffer.empty()) [[likely]] {
+      return buffer;
+    }
+    return prepareWaitSlow(size, timeout, wakeThreshold);
+  }
+
   /// Make reserved buffer visible for consumers
   TURBOQ_FORCE_INLINE void commit() noexcept {
-    std::atomic_ref(header_->producerPos).store(producerPosCache_, std::memory_order_release);
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      std::atomic_ref(header_->producerLastPos).store(lastPos_, std::memory_order_relaxed);
+    } else {
+      sequence_++;
+    }
+    publish();
+
+    if (recorder_) [[unlikely]] {
+      recorder_->sample(FlightEvent::Commit, producerPosCache_, [this] {
+        return peerPosition();
+      });
+    }
   }
 
   /// \overload
+  /// Size could exceed requested size up to the space reserved for the message.
+  /// Throws on size greater reserved size.
   TURBOQ_FORCE_INLINE void commit(std::size_t size) {
-    // TODO: new size could be greater previous but less than lastMessageHeader_->size
-    if (size <= lastMessageHeader_->payloadSize) [[likely]] {
+    valueOrThrow(tryCommit(size));
+  }
+
+  /// Commit like commit(size), return error on size greater reserved size
+  /// (reservation is kept).
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<> tryCommit(std::size_t size) noexcept {
+    if (size > lastMessageHeader_->size) [[unlikely]] {
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    lastMessageHeader_->payloadSize = size;
+    commit();
+    return success();
+  }
+
+  /// Grow reserved buffer keeping data written so far. Grows in place while
+  /// contiguous space remains and moves payload to the buffer start at the wrap point.
+  /// Return whole payload buffer or empty buffer on error (reservation is kept).
+  /// pre: prepare() -> non empty buffer
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> extend(std::size_t size) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    if (size <= lastMessageHeader_->size) [[likely]] {
       lastMessageHeader_->payloadSize = size;
+      return data_.subspan(lastMessageHeader_->payloadOffset, size);
+    }
+    return extendSlow(size);
+  }
+
+  /// Release reservation made by the last prepare()
+  /// pre: prepare() -> non empty buffer, not committed
+  TURBOQ_FORCE_INLINE void abort() noexcept {
+    auto const offset = std::size_t(std::bit_cast<std::byte*>(lastMessageHeader_) - data_.data());
+    // payload of the message wrapped to the data start doesn't follow its header
+    bool const wrapped = lastMessageHeader_->payloadOffset == 0;
+
+    if (wrapped) {
+      lapBase_ -= data_.size();
+    }
+    producerPosCache_ = lapBase_ + offset;
+
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      if (wrapped) {
+        std::atomic_ref(header_->producerWrapPos).store(prevWrapPos_, std::memory_order_relaxed);
+      }
+      --sequence_;
     } else {
-      throw std::runtime_error("new commit size greater previously requested size");
+      // free space is recalculated on the next prepare
+      minFreeSpace_ = 0;
     }
-    commit();
+  }
+
+  /// Reserve up to buffers.size() buffers of size bytes each for batched writing
+  /// (e.g. scatter reads). Return number of reserved buffers.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t prepareBatch(
+      std::size_t size, std::span<std::span<std::byte>> buffers) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    batchPos_ = producerPosCache_;
+    std::size_t count = 0;
+    for (; count < buffers.size(); ++count) {
+      buffers[count] = prepare(size);
+      if (buffers[count].empty()) {
+        break;
+      }
+    }
+    return count;
+  }
+
+  /// Make first sizes.size() buffers of the batch visible for consumers with
+  /// the actual sizes, drop the rest of the batch
+  /// pre: prepareBatch() -> count >= sizes.size()
+  TURBOQ_FORCE_INLINE void commitBatch(std::span<std::size_t const> sizes) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    std::size_t pos = batchPos_;
+    std::size_t lapBase = pos - pos % data_.size();
+    for (auto const size : sizes) {
+      auto const header = std::bit_cast<MessageHeader*>(data_.data() + (pos - lapBase));
+      assert(size <= header->size);
+      header->payloadSize = size;
+      if (header->payloadOffset < pos - lapBase) {
+        // message wrapped
+        lapBase += data_.size();
+      }
+      pos = lapBase + header->payloadOffset + header->size;
+    }
+    if (pos != producerPosCache_) [[unlikely]] {
+      // free space is recalculated on the next prepare
+      producerPosCache_ = pos;
+      lapBase_ = lapBase;
+      minFreeSpace_ = 0;
+    }
+    sequence_ += sizes.size();
+    publish();
+
+    if (recorder_) [[unlikely]] {
+      recorder_->sample(FlightEvent::Commit, producerPosCache_, [this] {
+        return peerPosition();
+      });
+    }
+  }
+
+  /// Record commits (sampled), full queue and wraps to flight recorder,
+  /// nullptr disables recording. Recorder must outlive the producer.
+  TURBOQ_FORCE_INLINE void setFlightRecorder(FlightRecorderWriter* recorder) noexcept {
+    recorder_ = recorder;
+  }
+
+  /// Flag queue in readiness bitmap on commits to the queue drained by consumer
+  /// (messages held by consumer count as not drained), nullptr disables
+  /// flagging. Notifier must outlive the producer.
+  TURBOQ_FORCE_INLINE void setReadinessNotifier(ReadinessBitmapNotifier* notifier) noexcept {
+    notifier_ = notifier;
+  }
+
+  /// Return number of bytes committed and not consumed yet
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t size() const noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    auto const consumerPos =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire));
+    return std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed) - consumerPos;
+  }
+
+  /// Return number of committed messages the consumer hasn't consumed yet
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t messagesBehind() const noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    return sequence_ - std::atomic_ref(header_->consumerCount).load(std::memory_order_acquire);
   }
 
   /// Swap resources with other producer
@@ -230,12 +497,194 @@ public:
     swap(producerPosCache_, that.producerPosCache_);
     swap(minFreeSpace_, that.minFreeSpace_);
     swap(lastMessageHeader_, that.lastMessageHeader_);
+    swap(lapBase_, that.lapBase_);
+    swap(lastPos_, that.lastPos_);
+    swap(sequence_, that.sequence_);
+    swap(prevWrapPos_, that.prevWrapPos_);
+    swap(batchPos_, that.batchPos_);
+    swap(recorder_, that.recorder_);
+    swap(notifier_, that.notifier_);
   }
 
   /// \see BoundedSPSCRawQueueProducer::swap
   friend void swap(BoundedSPSCRawQueueProducer& a, BoundedSPSCRawQueueProducer& b) noexcept {
     a.swap(b);
   }
+
+private:
+  /// Return consumer position without epoch for flight recorder
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t peerPosition() const noexcept {
+    return QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_relaxed));
+  }
+
+  /// Fill header of the message reserved at producer position
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> reserve(std::size_t alignedSize, std::size_t size) noexcept {
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + (producerPosCache_ - lapBase_));
+    lastMessageHeader_->size = alignedSize - sizeof(MessageHeader);
+    lastMessageHeader_->payloadSize = size;
+    lastMessageHeader_->payloadOffset = producerPosCache_ - lapBase_ + sizeof(MessageHeader);
+    producerPosCache_ += alignedSize;
+    minFreeSpace_ -= alignedSize;
+
+    return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
+  }
+
+  /// Store message count and position, count is stored first so it is never
+  /// behind the position consumer acquires
+  TURBOQ_FORCE_INLINE void publish() noexcept {
+    if (notifier_) [[unlikely]] {
+      publishNotify();
+      return;
+    }
+    std::atomic_ref(header_->producerCount).store(sequence_, std::memory_order_relaxed);
+    std::atomic_ref(header_->producerPos).store(producerPosCache_, std::memory_order_release);
+  }
+
+  /// Publish and flag queue as ready in case of consumer has consumed all
+  /// messages committed before (empty to non-empty transition)
+  TURBOQ_NO_INLINE void publishNotify() noexcept {
+    auto const prevPos = std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed);
+    std::atomic_ref(header_->producerCount).store(sequence_, std::memory_order_relaxed);
+    std::atomic_ref(header_->producerPos).store(producerPosCache_, std::memory_order_release);
+    auto const consumerPos =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_relaxed));
+    if (consumerPos == prevPos) {
+      notifier_->notify();
+    }
+  }
+
+  /// Grow reservation beyond the space reserved for the message
+  TURBOQ_NO_INLINE std::span<std::byte> extendSlow(std::size_t size) noexcept {
+    // payload of the message wrapped to the buffer start doesn't follow its header
+    bool const wrapped = lastMessageHeader_->payloadOffset == 0;
+    std::size_t const bufferSize = wrapped ? QueueDetail::alignBufferSize(size)
+                                           : QueueDetail::alignBufferSize(size + sizeof(MessageHeader)) -
+                                                 sizeof(MessageHeader);
+    std::size_t const delta = bufferSize - lastMessageHeader_->size;
+
+    if (delta > minFreeSpace_) {
+      auto const consumerPosCache =
+          QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire));
+      // consumer is on the previous lap
+      bool const behind = consumerPosCache < lapBase_;
+
+      if (behind) {
+        minFreeSpace_ = consumerPosCache + data_.size() - producerPosCache_ - 1;
+      } else {
+        // Reserve space at end for last MessageHeader
+        minFreeSpace_ = data_.size() - (producerPosCache_ - lapBase_) - sizeof(MessageHeader);
+      }
+
+      if (delta > minFreeSpace_) {
+        // relocate payload to the begining, header stays in place
+        std::size_t const alignedSize2 = QueueDetail::alignBufferSize(size);
+        if (wrapped || behind || alignedSize2 >= consumerPosCache - lapBase_) {
+          return {};
+        }
+
+        std::memcpy(data_.data(), data_.data() + lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
+        lastMessageHeader_->size = alignedSize2;
+        lastMessageHeader_->payloadSize = size;
+        lastMessageHeader_->payloadOffset = 0;
+        lapBase_ += data_.size();
+        producerPosCache_ = lapBase_ + alignedSize2;
+        minFreeSpace_ = consumerPosCache + data_.size() - producerPosCache_ - 1;
+
+        if (recorder_) [[unlikely]] {
+          recorder_->slowPath(FlightEvent::Wrap, producerPosCache_, [this] {
+            return peerPosition();
+          });
+        }
+        return data_.subspan(0, size);
+      }
+    }
+
+    lastMessageHeader_->size = bufferSize;
+    lastMessageHeader_->payloadSize = size;
+    producerPosCache_ += delta;
+    minFreeSpace_ -= delta;
+
+    return data_.subspan(lastMessageHeader_->payloadOffset, size);
+  }
+
+  /// Sleep until consumer frees space
+  TURBOQ_NO_INLINE std::span<std::byte> prepareWaitSlow(
+      std::size_t size, std::chrono::nanoseconds timeout, std::size_t wakeThreshold) noexcept {
+    using Clock = std::chrono::steady_clock;
+
+    // saturate deadline, large timeouts overflow the clock
+    auto const now = Clock::now();
+    auto const deadline = (timeout >= Clock::time_point::max() - now) ? Clock::time_point::max() : now + timeout;
+    std::size_t const threshold =
+        std::max(QueueDetail::alignBufferSize(size + sizeof(MessageHeader)) + sizeof(MessageHeader), wakeThreshold);
+
+    for (;;) {
+      std::atomic_ref(header_->producerWakeThreshold).store(threshold, std::memory_order_relaxed);
+      std::atomic_ref(header_->producerWaiting).store(1, std::memory_order_relaxed);
+      // Order the flag before re-reading consumer position, pairs with fence in consumer
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (auto buffer = prepare(size); !buffer.empty()) {
+        return buffer;
+      }
+
+      std::chrono::nanoseconds remaining = std::chrono::nanoseconds::max();
+      if (deadline != Clock::time_point::max()) {
+        remaining = deadline - Clock::now();
+        if (remaining.count() <= 0) {
+          return {};
+        }
+      }
+      detail::futexWait(&header_->producerWaiting, 1, remaining);
+    }
+  }
+
+  /// Reserve space overwriting the oldest messages, never reads consumer position
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> prepareOverwrite(std::size_t size) noexcept {
+    std::size_t const alignedSize = QueueDetail::alignBufferSize(size + sizeof(MessageHeader));
+
+    // payload placed at the begining on wrap must not overlap own header
+    if (2 * alignedSize + sizeof(MessageHeader) > data_.size()) [[unlikely]] {
+      return {};
+    }
+
+    std::size_t const offset = producerPosCache_ - lapBase_;
+    std::size_t payloadOffset = offset + sizeof(MessageHeader);
+    std::size_t bufferSize = alignedSize - sizeof(MessageHeader);
+
+    lastPos_ = producerPosCache_;
+
+    if (offset + alignedSize + sizeof(MessageHeader) > data_.size()) [[unlikely]] {
+      // align payload to cache-line size when payload starts from begining
+      lapBase_ += data_.size();
+      payloadOffset = 0;
+      bufferSize = QueueDetail::alignBufferSize(size);
+      prevWrapPos_ = std::atomic_ref(header_->producerWrapPos).load(std::memory_order_relaxed);
+      std::atomic_ref(header_->producerWrapPos).store(lastPos_, std::memory_order_relaxed);
+      if (recorder_) [[unlikely]] {
+        recorder_->slowPath(FlightEvent::Wrap, lapBase_, [this] {
+          return peerPosition();
+        });
+      }
+    }
+
+    producerPosCache_ = lapBase_ + payloadOffset + bufferSize;
+
+    // Announce the region before overwriting it, consumers validate reads against it.
+    // Never move it back: aborted reservation could have overwritten bytes up to it.
+    auto const reservedPos =
+        std::max(std::atomic_ref(header_->producerReservedPos).load(std::memory_order_relaxed), producerPosCache_);
+    std::atomic_ref(header_->producerReservedPos).store(reservedPos, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + offset);
+    lastMessageHeader_->size = bufferSize;
+    lastMessageHeader_->payloadSize = size;
+    lastMessageHeader_->payloadOffset = payloadOffset;
+    lastMessageHeader_->sequence = sequence_++;
+
+    return data_.subspan(payloadOffset, size);
+  }
 };
 
 /// Implements a SPSC queue consumer
@@ -252,8 +701,36 @@ private:
   std::size_t consumerPosCache_ = 0;
   std::size_t producerPosCache_ = 0;
   MessageHeader* lastMessageHeader_ = nullptr;
+  MessageHeader lastMessage_ = {};
+  std::size_t lapBase_ = 0;
+  std::size_t sequence_ = 0;
+  std::size_t dropped_ = 0;
+  std::size_t holdPos_ = 0;
+  std::size_t holdLapBase_ = 0;
+  std::size_t wakeCheckPos_ = 0;
+  std::size_t epoch_ = 0;
+  std::size_t publishedPos_ = 0;
+  bool takenOver_ = false;
+  bool synchronized_ = false;
+  FlightRecorderWriter* recorder_ = nullptr;
+
+  /// Number of fenced producer wake checks per ring lap (wait mode only)
+  static constexpr std::size_t kWakeChecksPerLap = 8;
 
 public:
+  /// Message held by consumer until release()
+  struct HeldMessage {
+    /// Message payload
+    std::span<std::byte const> buffer;
+    /// Message header offset
+    std::size_t offset = 0;
+
+    /// Return true in case of no message
+    [[nodiscard]] TURBOQ_FORCE_INLINE bool empty() const noexcept {
+      return buffer.empty();
+    }
+  };
+
   BoundedSPSCRawQueueConsumer() = default;
   ~BoundedSPSCRawQueueConsumer() = default;
 
@@ -270,13 +747,43 @@ public:
     auto content = storage_.content();
 
     if (!QueueDetail::check(content)) {
-      throw std::runtime_error("invalid queue");
+      throwError(Error::InvalidQueue);
     }
 
     header_ = std::bit_cast<MemoryHeader*>(content.data());
     data_ = content.subspan(QueueDetail::kDataStartPos);
-    consumerPosCache_ = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
-    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    loadPosition();
+  }
+
+  /// Construct consumer claiming the consumer role in case of owner's heartbeat
+  /// is older than heartbeatTimeout. Consumer resumes from the last consumed
+  /// message, messages fetched but not consumed by previous owner are fetched
+  /// again. Consumer is not initialized in case of owner is alive.
+  /// Stale heartbeat is claimed by CAS first, so only one standby proceeds.
+  /// Position is adopted together with the next epoch by one CAS, so the
+  /// previous owner can't move it anymore (\see QueueDetail::kEpochMask).
+  /// Throws on error.
+  BoundedSPSCRawQueueConsumer(MappedRegion&& storage, std::chrono::nanoseconds heartbeatTimeout)
+      : BoundedSPSCRawQueueConsumer(std::move(storage)) {
+    std::atomic_ref consumerHeartbeat(header_->consumerHeartbeat);
+    auto heartbeat = consumerHeartbeat.load(std::memory_order_relaxed);
+    auto const now = QueueDetail::now();
+    bool const alive = heartbeat != QueueDetail::kVacantHeartbeat && now - heartbeat < heartbeatTimeout.count();
+    if (alive || !consumerHeartbeat.compare_exchange_strong(heartbeat, now, std::memory_order_relaxed)) {
+      // owner is alive or heartbeat moved (owner refreshed it or other standby claimed it)
+      storage_ = MappedRegion();
+      return;
+    }
+    std::atomic_ref consumerPos(header_->consumerPos);
+    auto word = consumerPos.load(std::memory_order_acquire);
+    std::size_t const epoch = (word + 1) & QueueDetail::kEpochMask;
+    if (!consumerPos.compare_exchange_strong(word, QueueDetail::position(word) | epoch, std::memory_order_acq_rel)) {
+      // owner published position after the heartbeat was claimed
+      storage_ = MappedRegion();
+      return;
+    }
+    takenOver_ = true;
+    loadPosition();
   }
 
   /// Return true on initialized
@@ -284,15 +791,120 @@ public:
     return static_cast<bool>(storage_);
   }
 
+  /// Return true in case of consumer still owns the consumer role.
+  /// Consumer not created by takeover always owns it.
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool owner() const noexcept {
+    return !takenOver_ ||
+           (std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire) & QueueDetail::kEpochMask) == epoch_;
+  }
+
+  /// Refresh heartbeat, call periodically more often than standby's heartbeat
+  /// timeout. Return false in case of ownership was taken over, consumer must
+  /// stop processing then, its positions are not published anymore.
+  TURBOQ_FORCE_INLINE bool heartbeat() noexcept {
+    if (!owner()) [[unlikely]] {
+      return false;
+    }
+    std::atomic_ref(header_->consumerHeartbeat).store(QueueDetail::now(), std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Give up consumer role, standby could take over immediately
+  TURBOQ_FORCE_INLINE void resign() noexcept {
+    if (takenOver_ && owner()) {
+      std::atomic_ref(header_->consumerHeartbeat).store(QueueDetail::kVacantHeartbeat, std::memory_order_relaxed);
+    }
+  }
+
+  /// Record consumes (sampled) and empty queue to flight recorder, nullptr
+  /// disables recording. Recorder must outlive the consumer.
+  TURBOQ_FORCE_INLINE void setFlightRecorder(FlightRecorderWriter* recorder) noexcept {
+    recorder_ = recorder;
+  }
+
+  /// Return number of messages overwritten by producer before they were fetched.
+  /// Counting starts from the first fetched message.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t dropped() const noexcept
+    requires QueueDetail::kOverwriteOldest
+  {
+    return dropped_;
+  }
+
+  /// Return number of bytes the consumer is behind the producer
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t lag() const noexcept {
+    return std::atomic_ref(header_->producerPos).load(std::memory_order_acquire) - consumerPosCache_;
+  }
+
+  /// Return true in case of producer overwrote messages the consumer hasn't fetched
+  /// yet, lag() is zero for empty queue
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool lapped() const noexcept
+    requires QueueDetail::kOverwriteOldest
+  {
+    auto const reservedPos = std::atomic_ref(header_->producerReservedPos).load(std::memory_order_acquire);
+    return reservedPos - consumerPosCache_ > data_.size();
+  }
+
+  /// Return number of committed messages not consumed yet, including fetched
+  /// one. In overwrite mode includes overwritten messages and is exact after
+  /// the first fetch.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t messagesBehind() const noexcept {
+    auto const count = std::atomic_ref(header_->producerCount).load(std::memory_order_acquire);
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      if (!synchronized_) [[unlikely]] {
+        return count - std::min(count, unsynchronizedSequence());
+      }
+    }
+    return count - sequence_;
+  }
+
+  /// Return true in case of the buffer returned by the last fetch() was not
+  /// overwritten by producer. Call after reading the buffer and before consume().
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool verify() const noexcept
+    requires QueueDetail::kOverwriteOldest
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto const reservedPos = std::atomic_ref(header_->producerReservedPos).load(std::memory_order_relaxed);
+    return reservedPos - consumerPosCache_ <= data_.size();
+  }
+
+  /// Return shared producer position word. It changes whenever new messages
+  /// could be fetched, so it could be polled before calling fetch().
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t const* producerPosition() const noexcept {
+    return &header_->producerPos;
+  }
+
+  /// Return shared consumer position word, low bits keep consumer ownership
+  /// epoch and change on takeover only
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t const* consumerPosition() const noexcept {
+    return &header_->consumerPos;
+  }
+
   /// Get next buffer for reading. Return empty buffer in case of no data.
+  /// In overwrite mode skips messages overwritten by producer.
   [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      return fetchOverwrite();
+    }
+
     if ((consumerPosCache_ == producerPosCache_ &&
             (producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) ==
                 consumerPosCache_)) [[unlikely]] {
+      if constexpr (QueueDetail::kProducerWait) {
+        // Order consumer position before reading the flag, pairs with fence in producer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) [[unlikely]] {
+          wakeProducer();
+        }
+      }
+      if (recorder_) [[unlikely]] {
+        recorder_->slowPath(FlightEvent::Empty, consumerPosCache_, [this] {
+          return peerPosition();
+        });
+      }
       return {};
     }
 
-    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + consumerPosCache_);
+    lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + (consumerPosCache_ - lapBase_));
 
     return data_.subspan(lastMessageHeader_->payloadOffset, lastMessageHeader_->payloadSize);
   }
@@ -300,15 +912,189 @@ public:
   /// Consume front buffer and make buffer available for producer
   /// pre: fetch() -> non empty buffer
   TURBOQ_FORCE_INLINE void consume() noexcept {
-    consumerPosCache_ = lastMessageHeader_->payloadOffset + lastMessageHeader_->size;
-    std::atomic_ref(header_->consumerPos).store(consumerPosCache_, std::memory_order_release);
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      if (lastMessage_.payloadOffset < consumerPosCache_ - lapBase_) [[unlikely]] {
+        // message wrapped
+        lapBase_ += data_.size();
+      }
+      consumerPosCache_ = lapBase_ + lastMessage_.payloadOffset + lastMessage_.size;
+      sequence_ = lastMessage_.sequence + 1;
+    } else {
+      if (lastMessageHeader_->payloadOffset < consumerPosCache_ - lapBase_) [[unlikely]] {
+        // message wrapped
+        lapBase_ += data_.size();
+      }
+      consumerPosCache_ = lapBase_ + lastMessageHeader_->payloadOffset + lastMessageHeader_->size;
+      sequence_++;
+    }
+    publish();
+
+    if (recorder_) [[unlikely]] {
+      recorder_->sample(FlightEvent::Consume, consumerPosCache_, [this] {
+        return peerPosition();
+      });
+    }
+
+    if constexpr (QueueDetail::kProducerWait) {
+      notifyProducer();
+    }
+  }
+
+  /// Get up to buffers.size() next buffers for reading without consuming them
+  /// (e.g. gather writes). Return number of buffers.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t fetchBatch(std::span<std::span<std::byte const>> buffers) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    if (consumerPosCache_ == producerPosCache_) {
+      producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    }
+    std::size_t pos = consumerPosCache_;
+    std::size_t lapBase = lapBase_;
+    std::size_t count = 0;
+    for (; count < buffers.size() && pos != producerPosCache_; ++count) {
+      auto const header = std::bit_cast<MessageHeader const*>(data_.data() + (pos - lapBase));
+      buffers[count] = data_.subspan(header->payloadOffset, header->payloadSize);
+      if (header->payloadOffset < pos - lapBase) {
+        // message wrapped
+        lapBase += data_.size();
+      }
+      pos = lapBase + header->payloadOffset + header->size;
+    }
+    if constexpr (QueueDetail::kProducerWait) {
+      if (count == 0) [[unlikely]] {
+        // Order consumer position before reading the flag, pairs with fence in producer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) [[unlikely]] {
+          wakeProducer();
+        }
+      }
+    }
+    return count;
+  }
+
+  /// Consume first count buffers of the batch and make buffer space available for producer
+  /// pre: fetchBatch() -> count
+  TURBOQ_FORCE_INLINE void consumeBatch(std::size_t count) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    for (std::size_t i = 0; i < count; ++i) {
+      lastMessageHeader_ = std::bit_cast<MessageHeader*>(data_.data() + (consumerPosCache_ - lapBase_));
+      if (lastMessageHeader_->payloadOffset < consumerPosCache_ - lapBase_) {
+        // message wrapped
+        lapBase_ += data_.size();
+      }
+      consumerPosCache_ = lapBase_ + lastMessageHeader_->payloadOffset + lastMessageHeader_->size;
+    }
+    sequence_ += count;
+    publish();
+
+    if (recorder_) [[unlikely]] {
+      recorder_->sample(FlightEvent::Consume, consumerPosCache_, [this] {
+        return peerPosition();
+      });
+    }
+
+    if constexpr (QueueDetail::kProducerWait) {
+      notifyProducer();
+    }
+  }
+
+  /// Get next message after the held ones and hold it until release(), so
+  /// several messages could be processed in place at once. Return empty
+  /// message in case of no data. Don't mix with fetch() while messages are held.
+  [[nodiscard]] TURBOQ_FORCE_INLINE HeldMessage hold() noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    if (holdPos_ < consumerPosCache_) [[unlikely]] {
+      // messages were consumed with fetch()/consume()
+      holdPos_ = consumerPosCache_;
+      holdLapBase_ = lapBase_;
+    }
+
+    if ((holdPos_ == producerPosCache_ &&
+            (producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) ==
+                holdPos_)) [[unlikely]] {
+      if constexpr (QueueDetail::kProducerWait) {
+        // Order consumer position before reading the flag, pairs with fence in producer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) [[unlikely]] {
+          wakeProducer();
+        }
+      }
+      return {};
+    }
+
+    auto const header = std::bit_cast<MessageHeader const*>(data_.data() + (holdPos_ - holdLapBase_));
+    HeldMessage const message = {data_.subspan(header->payloadOffset, header->payloadSize), holdPos_ - holdLapBase_};
+    if (header->payloadOffset < holdPos_ - holdLapBase_) [[unlikely]] {
+      // message wrapped
+      holdLapBase_ += data_.size();
+    }
+    holdPos_ = holdLapBase_ + header->payloadOffset + header->size;
+
+    return message;
+  }
+
+  /// Release held message in any order. Buffer space is made available for
+  /// producer once all messages held before it are released too.
+  /// pre: hold() -> non empty message, not released
+  TURBOQ_FORCE_INLINE void release(HeldMessage const& message) noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    // space up to hold position belongs to consumer, mark message in place
+    std::bit_cast<MessageHeader*>(data_.data() + message.offset)->payloadSize = QueueDetail::kReleased;
+
+    std::size_t const consumerPos = consumerPosCache_;
+    while (consumerPosCache_ != holdPos_) {
+      auto const header = std::bit_cast<MessageHeader const*>(data_.data() + (consumerPosCache_ - lapBase_));
+      if (header->payloadSize != QueueDetail::kReleased) {
+        break;
+      }
+      if (header->payloadOffset < consumerPosCache_ - lapBase_) {
+        // message wrapped
+        lapBase_ += data_.size();
+      }
+      consumerPosCache_ = lapBase_ + header->payloadOffset + header->size;
+      sequence_++;
+    }
+    if (consumerPosCache_ == consumerPos) {
+      return;
+    }
+    publish();
+
+    if constexpr (QueueDetail::kProducerWait) {
+      notifyProducer();
+    }
   }
 
   /// Reset queue
   TURBOQ_FORCE_INLINE void reset() noexcept {
     producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
-    consumerPosCache_ = producerPosCache_;
-    std::atomic_ref(header_->consumerPos).store(consumerPosCache_, std::memory_order_release);
+    if constexpr (QueueDetail::kOverwriteOldest) {
+      consumerPosCache_ = producerPosCache_;
+      lapBase_ = consumerPosCache_ - consumerPosCache_ % data_.size();
+      synchronized_ = false;
+    } else {
+      // walk skipped messages, message count must match position
+      while (consumerPosCache_ != producerPosCache_) {
+        auto const header = std::bit_cast<MessageHeader const*>(data_.data() + (consumerPosCache_ - lapBase_));
+        if (header->payloadOffset < consumerPosCache_ - lapBase_) {
+          lapBase_ += data_.size();
+        }
+        consumerPosCache_ = lapBase_ + header->payloadOffset + header->size;
+        sequence_++;
+      }
+    }
+    holdPos_ = consumerPosCache_;
+    holdLapBase_ = lapBase_;
+    publish();
+
+    if constexpr (QueueDetail::kProducerWait) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) {
+        wakeProducer();
+      }
+    }
   }
 
   /// Swap resources with other object
@@ -320,12 +1106,317 @@ public:
     swap(consumerPosCache_, that.consumerPosCache_);
     swap(producerPosCache_, that.producerPosCache_);
     swap(lastMessageHeader_, that.lastMessageHeader_);
+    swap(lastMessage_, that.lastMessage_);
+    swap(lapBase_, that.lapBase_);
+    swap(sequence_, that.sequence_);
+    swap(dropped_, that.dropped_);
+    swap(holdPos_, that.holdPos_);
+    swap(holdLapBase_, that.holdLapBase_);
+    swap(wakeCheckPos_, that.wakeCheckPos_);
+    swap(epoch_, that.epoch_);
+    swap(publishedPos_, that.publishedPos_);
+    swap(takenOver_, that.takenOver_);
+    swap(synchronized_, that.synchronized_);
+    swap(recorder_, that.recorder_);
   }
 
   /// \see BoundedSPSCRawQueueConsumer::swap
   friend void swap(BoundedSPSCRawQueueConsumer& a, BoundedSPSCRawQueueConsumer& b) noexcept {
     a.swap(b);
   }
+
+private:
+  /// Return producer position for flight recorder
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t peerPosition() const noexcept {
+    return std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed);
+  }
+
+  /// Load consumer position and message count published by the last owner
+  void loadPosition() noexcept {
+    auto const word = std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire);
+    consumerPosCache_ = QueueDetail::position(word);
+    epoch_ = word & QueueDetail::kEpochMask;
+    publishedPos_ = consumerPosCache_;
+    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    lapBase_ = consumerPosCache_ - consumerPosCache_ % data_.size();
+    holdPos_ = consumerPosCache_;
+    holdLapBase_ = lapBase_;
+    if constexpr (!QueueDetail::kOverwriteOldest) {
+      sequence_ = std::atomic_ref(header_->consumerCount).load(std::memory_order_relaxed);
+    }
+  }
+
+  /// Store message count and position
+  TURBOQ_FORCE_INLINE void publish() noexcept {
+    if (takenOver_) [[unlikely]] {
+      publishOwned();
+      return;
+    }
+    if constexpr (!QueueDetail::kOverwriteOldest) {
+      std::atomic_ref(header_->consumerCount).store(sequence_, std::memory_order_relaxed);
+    }
+    std::atomic_ref(header_->consumerPos).store(consumerPosCache_ | epoch_, std::memory_order_release);
+  }
+
+  /// Store message count and position unless ownership was taken over.
+  /// Position is stored by CAS from the last stored word, it fails once standby
+  /// adopted the position. Message count could be off by the messages consumed
+  /// by stale owner racing with takeover.
+  TURBOQ_FORCE_INLINE void publishOwned() noexcept {
+    std::atomic_ref consumerPos(header_->consumerPos);
+    auto expected = publishedPos_ | epoch_;
+    if (consumerPos.load(std::memory_order_relaxed) != expected) [[unlikely]] {
+      // taken over
+      return;
+    }
+    if constexpr (!QueueDetail::kOverwriteOldest) {
+      std::atomic_ref(header_->consumerCount).store(sequence_, std::memory_order_relaxed);
+    }
+    if (consumerPos.compare_exchange_strong(
+            expected, consumerPosCache_ | epoch_, std::memory_order_release, std::memory_order_relaxed)) {
+      publishedPos_ = consumerPosCache_;
+    }
+  }
+
+  /// Wake producer sleeping on full queue
+  TURBOQ_COLD void wakeProducer() noexcept {
+    if (std::atomic_ref(header_->producerWaiting).exchange(0, std::memory_order_acq_rel) != 0) {
+      detail::futexWake(&header_->producerWaiting, 1);
+    }
+  }
+
+  /// Wake producer sleeping on full queue in case of enough space is free.
+  /// Flag is read without fence, so it could miss producer going to sleep
+  /// right after consumer position was stored. Flag is re-checked after fence
+  /// each time consumer position crosses the next 1/kWakeChecksPerLap of the ring.
+  TURBOQ_FORCE_INLINE void notifyProducer() noexcept {
+    if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0 ||
+        consumerPosCache_ >= wakeCheckPos_) [[unlikely]] {
+      notifyProducerSlow();
+    }
+  }
+
+  /// \see BoundedSPSCRawQueueConsumer::notifyProducer
+  TURBOQ_COLD void notifyProducerSlow() noexcept {
+    // Order consumer position before reading the flag, pairs with fence in producer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeCheckPos_ = consumerPosCache_ + data_.size() / kWakeChecksPerLap;
+    if (std::atomic_ref(header_->producerWaiting).load(std::memory_order_relaxed) != 0) {
+      wakeProducerOnThreshold();
+    }
+  }
+
+  /// Wake producer in case of free space reached producer's threshold
+  TURBOQ_COLD void wakeProducerOnThreshold() noexcept {
+    // producer position is stable while producer sleeps
+    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    std::size_t const used = producerPosCache_ - consumerPosCache_;
+    auto const threshold = std::atomic_ref(header_->producerWakeThreshold).load(std::memory_order_relaxed);
+    if (data_.size() - used >= threshold) {
+      wakeProducer();
+    }
+  }
+
+  /// Return sequence of the message at consumer position before the first fetch
+  [[nodiscard]] TURBOQ_COLD std::size_t unsynchronizedSequence() const noexcept {
+    auto const producerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    if (consumerPosCache_ == producerPos) {
+      return std::atomic_ref(header_->producerCount).load(std::memory_order_relaxed);
+    }
+    // header could be overwritten at any moment
+    MessageHeader const message = *std::bit_cast<MessageHeader const*>(data_.data() + (consumerPosCache_ - lapBase_));
+    return message.sequence;
+  }
+
+  /// Fetch next message detecting producer overrun
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetchOverwrite() noexcept {
+    for (;;) {
+      if ((consumerPosCache_ == producerPosCache_ &&
+              (producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire)) ==
+                  consumerPosCache_)) [[unlikely]] {
+        if (recorder_) [[unlikely]] {
+          recorder_->slowPath(FlightEvent::Empty, consumerPosCache_, [this] {
+            return peerPosition();
+          });
+        }
+        return {};
+      }
+
+      // copy header, it could be overwritten at any moment
+      lastMessage_ = *std::bit_cast<MessageHeader const*>(data_.data() + (consumerPosCache_ - lapBase_));
+      if (!verify()) [[unlikely]] {
+        resync();
+        continue;
+      }
+
+      if (synchronized_) [[likely]] {
+        dropped_ += lastMessage_.sequence - sequence_;
+      }
+      sequence_ = lastMessage_.sequence;
+      synchronized_ = true;
+
+      return data_.subspan(lastMessage_.payloadOffset, lastMessage_.payloadSize);
+    }
+  }
+
+  /// Skip messages overwritten by producer. Continue from the message wrapped to
+  /// the data start or from the last committed message.
+  TURBOQ_COLD void resync() noexcept {
+    auto const lastPos = std::atomic_ref(header_->producerLastPos).load(std::memory_order_acquire);
+    producerPosCache_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    auto const wrapPos = std::atomic_ref(header_->producerWrapPos).load(std::memory_order_relaxed);
+    auto const reservedPos = std::atomic_ref(header_->producerReservedPos).load(std::memory_order_relaxed);
+
+    // last position could belong to not yet committed message
+    consumerPosCache_ = (lastPos < producerPosCache_) ? lastPos : producerPosCache_;
+    if (wrapPos < consumerPosCache_ && reservedPos - wrapPos <= data_.size()) {
+      consumerPosCache_ = wrapPos;
+    }
+    lapBase_ = consumerPosCache_ - consumerPosCache_ % data_.size();
+    publish();
+  }
+};
+
+/// Implements a SPSC queue tap: read-only observer following the producer.
+/// Tap never stores to the queue memory (mapped read-only) and is invisible to
+/// the producer and the consumer. Tap sees only messages the consumer hasn't
+/// released yet and resyncs to the consumer position when overrun.
+template <typename Traits>
+class BoundedSPSCRawQueueTap {
+private:
+  using QueueDetail = BoundedSPSCRawQueueDetail<Traits>;
+  using MemoryHeader = typename QueueDetail::MemoryHeader;
+  using MessageHeader = typename QueueDetail::MessageHeader;
+
+  MappedRegion storage_;
+  MemoryHeader* header_ = nullptr;
+  std::span<std::byte const> data_;
+  std::size_t tapPos_ = 0;
+  std::size_t nextPos_ = 0;
+  std::size_t overruns_ = 0;
+
+public:
+  BoundedSPSCRawQueueTap() = default;
+  ~BoundedSPSCRawQueueTap() = default;
+
+  BoundedSPSCRawQueueTap(BoundedSPSCRawQueueTap&& that) noexcept {
+    swap(that);
+  }
+
+  BoundedSPSCRawQueueTap& operator=(BoundedSPSCRawQueueTap&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  BoundedSPSCRawQueueTap(MappedRegion&& storage) : storage_(std::move(storage)) {
+    auto content = storage_.content();
+
+    if (!QueueDetail::check(content)) {
+      throwError(Error::InvalidQueue);
+    }
+
+    header_ = std::bit_cast<MemoryHeader*>(storage_.data());
+    data_ = content.subspan(QueueDetail::kDataStartPos);
+    // start from the messages committed after tap creation
+    tapPos_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+  }
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return number of times tap was overrun by the consumer and resynced
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t overruns() const noexcept {
+    return overruns_;
+  }
+
+  /// Get next buffer for reading. Return empty buffer in case of no data.
+  /// Buffer could be released by consumer and overwritten at any moment, call
+  /// verify() after reading it.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> fetch() noexcept {
+    auto const producerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+    if (tapPos_ == producerPos) {
+      return {};
+    }
+    auto const consumerPos =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_acquire));
+    if (!unconsumed(tapPos_, consumerPos, producerPos)) [[unlikely]] {
+      overruns_++;
+      tapPos_ = consumerPos;
+      if (tapPos_ == producerPos) {
+        return {};
+      }
+    }
+
+    while (tapPos_ != producerPos) {
+      // copy header, it could be overwritten at any moment
+      std::size_t const offset = tapPos_ % data_.size();
+      MessageHeader const message = *std::bit_cast<MessageHeader const*>(data_.data() + offset);
+      bool const released = message.payloadSize == QueueDetail::kReleased;
+      bool const valid = (message.payloadOffset == offset + sizeof(MessageHeader) || message.payloadOffset == 0) &&
+                         (released || message.payloadSize <= message.size) &&
+                         message.payloadOffset + message.size <= data_.size();
+      if (!valid || !verify()) [[unlikely]] {
+        return {};
+      }
+
+      // payload of the message wrapped to the data start doesn't follow its header
+      std::size_t const lapBase = tapPos_ - offset + (message.payloadOffset == 0 ? data_.size() : 0);
+      nextPos_ = lapBase + message.payloadOffset + message.size;
+      if (released) [[unlikely]] {
+        // released out of order behind a held message, skip it
+        tapPos_ = nextPos_;
+        continue;
+      }
+      return data_.subspan(message.payloadOffset, message.payloadSize);
+    }
+    return {};
+  }
+
+  /// Return true in case of the buffer returned by the last fetch() was not
+  /// released by consumer. Call after reading the buffer and before consume().
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool verify() const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto const consumerPos =
+        QueueDetail::position(std::atomic_ref(header_->consumerPos).load(std::memory_order_relaxed));
+    auto const producerPos = std::atomic_ref(header_->producerPos).load(std::memory_order_relaxed);
+    return unconsumed(tapPos_, consumerPos, producerPos);
+  }
+
+  /// Move to the next message
+  /// pre: fetch() -> non empty buffer
+  TURBOQ_FORCE_INLINE void consume() noexcept {
+    tapPos_ = nextPos_;
+  }
+
+  /// Skip all messages
+  TURBOQ_FORCE_INLINE void reset() noexcept {
+    tapPos_ = std::atomic_ref(header_->producerPos).load(std::memory_order_acquire);
+  }
+
+  /// Swap resources with other object
+  void swap(BoundedSPSCRawQueueTap& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(data_, that.data_);
+    swap(tapPos_, that.tapPos_);
+    swap(nextPos_, that.nextPos_);
+    swap(overruns_, that.overruns_);
+  }
+
+  /// \see BoundedSPSCRawQueueTap::swap
+  friend void swap(BoundedSPSCRawQueueTap& a, BoundedSPSCRawQueueTap& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return true in case of pos is in [consumerPos, producerPos) range
+  [[nodiscard]] static TURBOQ_FORCE_INLINE bool unconsumed(
+      std::size_t pos, std::size_t consumerPos, std::size_t producerPos) noexcept {
+    return consumerPos <= pos && pos < producerPos;
+  }
 };
 
 } // namespace detail
@@ -350,6 +1441,17 @@ struct BoundedSPSCRawQueueDefaultTraits {
 
 using BoundedSPSCRawQueue = BoundedSPSCRawQueueImpl<BoundedSPSCRawQueueDefaultTraits>;
 
+/// Producer overwrites the oldest messages instead of failing on full queue.
+/// Consumer detects it was overtaken, counts dropped messages and resynchronises.
+struct BoundedSPSCRawQueueOverwriteTraits {
+  static constexpr std::string_view kTag = "turboq/SPSC-overwrite";
+  static constexpr std::size_t kSegmentSize = kHardwareDestructiveInterferenceSize;
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+  static constexpr bool kOverwriteOldest = true;
+};
+
+using BoundedSPSCOverwriteRawQueue = BoundedSPSCRawQueueImpl<BoundedSPSCRawQueueOverwriteTraits>;
+
 template <typename Traits>
 class BoundedSPSCRawQueueImpl {
 private:
@@ -362,6 +1464,7 @@ private:
 public:
   using Producer = detail::BoundedSPSCRawQueueProducer<Traits>;
   using Consumer = detail::BoundedSPSCRawQueueConsumer<Traits>;
+  using Tap = detail::BoundedSPSCRawQueueTap<Traits>;
 
   struct CreationOptions {
     std::size_t capacityHint;
@@ -381,45 +1484,81 @@ public:
   }
 
   /// Open only queue. Throws on error.
-  BoundedSPSCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) {
+  BoundedSPSCRawQueueImpl(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedSPSCRawQueueImpl(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create queue. Throws on error.
+  BoundedSPSCRawQueueImpl(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : BoundedSPSCRawQueueImpl(valueOrThrow(create(name, options, memorySource))) {}
+
+  /// Open only queue.
+  [[nodiscard]] static Result<BoundedSPSCRawQueueImpl> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept {
     auto result = memorySource.open(name, MemorySource::OpenOnly);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
+
+    BoundedSPSCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
-    if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-      throw std::runtime_error("failed to open queue (invalid)");
+    auto storage = detail::tryMapFile(queue.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
     }
+    return queue;
   }
 
-  /// Open or create queue. Throws on error.
-  BoundedSPSCRawQueueImpl(
-      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource()) {
+  /// Open or create queue.
+  [[nodiscard]] static Result<BoundedSPSCRawQueueImpl> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept {
+    if (!detail::isCacheLineAligned(QueueDetail::kAlign)) {
+      return makeErrorCode(Error::Alignment);
+    }
     auto result = memorySource.open(name, MemorySource::OpenOrCreate);
     if (!result) {
-      throw std::runtime_error("failed to open memory source");
+      return makeErrorCode(Error::MemorySourceOpen);
     }
 
+    BoundedSPSCRawQueueImpl queue;
     std::size_t pageSize;
-    std::tie(file_, pageSize) = std::move(result).value();
+    std::tie(queue.file_, pageSize) = std::move(result).value();
 
     // round-up requested size to page size
     std::size_t const capacity = detail::align_up(options.capacityHint, pageSize);
 
     // init queue or check queue's options is the same as requested
-    if (auto const fileSize = file_.getFileSize(); fileSize != 0) {
-      if (fileSize != capacity) {
-        throw std::runtime_error("size mismatch");
+    auto const fileSize = queue.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
       }
-      if (auto storage = detail::mapFile(file_); !QueueDetail::check(storage.content())) {
-        throw std::runtime_error("failed to open queue (invalid)");
+      auto storage = detail::tryMapFile(queue.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!QueueDetail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
       }
     } else {
-      file_.truncate(capacity);
-      QueueDetail::init(detail::mapFile(file_, capacity).content());
+      if (auto truncated = queue.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(queue.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      QueueDetail::init(storage.value().content());
     }
+    return queue;
   }
 
   /// Return true on queue intialized.
@@ -429,21 +1568,99 @@ public:
 
   /// Create producer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Producer createProducer() {
+    return valueOrThrow(tryCreateProducer());
+  }
+
+  /// Create producer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Producer> tryCreateProducer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue not initialized");
+      return makeErrorCode(Error::NotInitialized);
     }
-    return Producer(detail::mapFile(file_));
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Producer(std::move(storage).value());
   }
 
   /// Create consumer for the queue. Throws on error.
   [[nodiscard]] TURBOQ_FORCE_INLINE Consumer createConsumer() {
+    return valueOrThrow(tryCreateConsumer());
+  }
+
+  /// Create consumer for the queue.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryCreateConsumer() noexcept {
     if (!operator bool()) {
-      throw std::runtime_error("queue not initialized");
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto const locked = file_.tryLockNoThrow();
+    if (!locked) {
+      return failure(locked.error());
+    }
+    if (!locked.value()) {
+      return makeErrorCode(Error::ConsumerExists);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Consumer(std::move(storage).value());
+  }
+
+  /// Claim consumer role in case of its owner's heartbeat is older than
+  /// heartbeatTimeout (hot standby). Doesn't use the consumer file lock, don't mix
+  /// with createConsumer(). Return not initialized consumer in case of owner
+  /// is alive. Throws on error.
+  /// \see BoundedSPSCRawQueueConsumer::heartbeat
+  [[nodiscard]] TURBOQ_FORCE_INLINE Consumer tryTakeOverConsumer(std::chrono::nanoseconds heartbeatTimeout) {
+    return valueOrThrow(tryTakeOverConsumerNoThrow(heartbeatTimeout));
+  }
+
+  /// \see tryTakeOverConsumer
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Consumer> tryTakeOverConsumerNoThrow(
+      std::chrono::nanoseconds heartbeatTimeout) noexcept {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFile(file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+    return Consumer(std::move(storage).value(), heartbeatTimeout);
+  }
+
+  /// Create read-only tap for the queue. Doesn't affect producer and consumer.
+  /// Throws on error.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Tap createTap()
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    return valueOrThrow(tryCreateTap());
+  }
+
+  /// Create read-only tap for the queue. Doesn't affect producer and consumer.
+  [[nodiscard]] TURBOQ_FORCE_INLINE Result<Tap> tryCreateTap() noexcept
+    requires(!QueueDetail::kOverwriteOldest)
+  {
+    if (!operator bool()) {
+      return makeErrorCode(Error::NotInitialized);
+    }
+    auto storage = detail::tryMapFileReadOnly(file_);
+    if (!storage) {
+      return failure(storage.error());
     }
-    if (!file_.tryLock()) {
-      throw std::runtime_error("can't create consumer (already exists?)");
+    if (!QueueDetail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
     }
-    return Consumer(detail::mapFile(file_));
+    return Tap(std::move(storage).value());
   }
 
   /// Swap resources with other queue.
@@ -2,7 +2,15 @@
 // SPDX-License-Identifier: AGPL-3.0
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <doctest/doctest.h>
 
@@ -48,6 +56,609 @@ TEST_CASE("BoundedSPSCRawQueue: basic") {
   REQUIRE(value == std::uint64_t(-1));
 }
 
+TEST_CASE("BoundedSPSCRawQueue: overwrite oldest") {
+  BoundedSPSCOverwriteRawQueue queue(
+      "test", BoundedSPSCOverwriteRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  REQUIRE(producer);
+
+  auto consumer = queue.createConsumer();
+  REQUIRE(consumer);
+
+  std::uint64_t value = std::uint64_t(-1);
+
+  // consumer starts counting dropped messages from the first fetched one
+  REQUIRE(enqueue(producer, std::uint64_t(0)));
+  REQUIRE(dequeue(consumer, value));
+  REQUIRE(value == 0);
+
+  constexpr std::uint64_t kCount = 1000;
+  for (std::uint64_t i = 1; i <= kCount; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+
+  std::uint64_t received = 0;
+  std::uint64_t last = 0;
+  while (dequeue(consumer, value)) {
+    REQUIRE(value > last);
+    last = value;
+    received++;
+  }
+
+  REQUIRE(last == kCount);
+  REQUIRE(consumer.dropped() > 0);
+  REQUIRE(received + consumer.dropped() == kCount);
+
+  // message never fits the queue
+  REQUIRE(producer.prepare(4096).empty());
+}
+
+TEST_CASE("BoundedSPSCRawQueue: overwrite oldest abort") {
+  BoundedSPSCOverwriteRawQueue queue(
+      "test", BoundedSPSCOverwriteRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  REQUIRE(enqueue(producer, std::uint64_t(0)));
+  auto const fetched = consumer.fetch();
+  REQUIRE(!fetched.empty());
+
+  // aborted reservation wraps to the data start over the fetched message
+  for (std::byte* last = nullptr;;) {
+    auto buffer = producer.prepare(256);
+    REQUIRE(!buffer.empty());
+    if (std::exchange(last, buffer.data()) > buffer.data()) {
+      std::memset(buffer.data(), 0xff, buffer.size());
+      producer.abort();
+      break;
+    }
+    producer.commit();
+  }
+
+  // smaller reservation doesn't hide the overwrite
+  REQUIRE(enqueue(producer, std::uint64_t(1)));
+  REQUIRE(!consumer.verify());
+  REQUIRE(consumer.lapped());
+}
+
+TEST_CASE("BoundedSPSCRawQueue: overwrite oldest (threads)") {
+  BoundedSPSCOverwriteRawQueue queue(
+      "test", BoundedSPSCOverwriteRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  constexpr std::uint64_t kCount = 1000000;
+
+  std::uint64_t value = std::uint64_t(-1);
+
+  // consumer starts counting dropped messages from the first fetched one
+  REQUIRE(enqueue(producer, std::uint64_t(0)));
+  REQUIRE(dequeue(consumer, value));
+  REQUIRE(value == 0);
+
+  std::thread thread([&] {
+    for (std::uint64_t i = 1; i <= kCount; ++i) {
+      while (!enqueue(producer, i)) {}
+    }
+  });
+
+  std::uint64_t received = 0;
+  std::uint64_t last = 0;
+  bool ordered = true;
+  while (last != kCount) {
+    if (dequeue(consumer, value)) {
+      ordered = ordered && (value > last);
+      last = value;
+      received++;
+    }
+  }
+
+  thread.join();
+
+  REQUIRE(ordered);
+  REQUIRE(received + consumer.dropped() == kCount);
+}
+
+TEST_CASE("BoundedSPSCRawQueue: tap") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  auto tap0 = queue.createTap();
+  auto tap1 = queue.createTap();
+  REQUIRE(tap0);
+  REQUIRE(tap1);
+
+  std::uint64_t value = std::uint64_t(-1);
+  REQUIRE(!dequeue(tap0, value));
+
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+
+  // taps don't take messages from the consumer
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(dequeue(tap0, value));
+    REQUIRE(value == i);
+  }
+  REQUIRE(!dequeue(tap0, value));
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(value == i);
+  }
+
+  // messages released by consumer are not visible to the lagging tap
+  REQUIRE(!dequeue(tap1, value));
+  REQUIRE(tap1.overruns() == 1);
+  REQUIRE(tap0.overruns() == 0);
+
+  REQUIRE(enqueue(producer, std::uint64_t(3)));
+  REQUIRE(dequeue(tap1, value));
+  REQUIRE(value == 3);
+}
+
+TEST_CASE("BoundedSPSCRawQueue: tap (threads)") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(1 << 20), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  auto tap = queue.createTap();
+
+  constexpr std::uint64_t kCount = 100000;
+
+  std::thread thread([&] {
+    for (std::uint64_t i = 1; i <= kCount; ++i) {
+      while (!enqueue(producer, i)) {}
+    }
+  });
+
+  std::uint64_t value = 0;
+  std::uint64_t last = 0;
+  std::uint64_t tapped = 0;
+  bool ordered = true;
+  while (last != kCount) {
+    // tap sees a subset of messages in order
+    if (std::uint64_t tapValue; dequeue(tap, tapValue)) {
+      ordered = ordered && (tapValue > tapped) && (tapValue <= kCount);
+      tapped = tapValue;
+    }
+    if (dequeue(consumer, value)) {
+      ordered = ordered && (value == last + 1);
+      last = value;
+    }
+  }
+
+  thread.join();
+
+  REQUIRE(ordered);
+}
+
+struct BoundedSPSCRawQueueWaitTraits : BoundedSPSCRawQueueDefaultTraits {
+  static constexpr bool kProducerWait = true;
+};
+
+TEST_CASE("BoundedSPSCRawQueue: producer wait") {
+  using Queue = BoundedSPSCRawQueueImpl<BoundedSPSCRawQueueWaitTraits>;
+
+  Queue queue("test", Queue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  SUBCASE("timeout") {
+    while (!producer.prepare(sizeof(std::uint64_t)).empty()) {
+      producer.commit();
+    }
+    REQUIRE(producer.prepareWait(sizeof(std::uint64_t), std::chrono::milliseconds(1)).empty());
+  }
+
+  SUBCASE("large timeout") {
+    while (!producer.prepare(sizeof(std::uint64_t)).empty()) {
+      producer.commit();
+    }
+
+    std::thread thread([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      std::uint64_t value;
+      while (dequeue(consumer, value)) {}
+    });
+
+    // deadline saturates instead of overflowing into the past
+    REQUIRE(!producer.prepareWait(sizeof(std::uint64_t), std::chrono::nanoseconds::max() - std::chrono::seconds(1))
+                 .empty());
+    thread.join();
+  }
+
+  SUBCASE("threads") {
+    constexpr std::uint64_t kCount = 100000;
+
+    std::thread thread([&] {
+      for (std::uint64_t i = 0; i < kCount; ++i) {
+        auto buffer = producer.prepareWait(sizeof(i), std::chrono::nanoseconds::max(), 1024);
+        std::memcpy(buffer.data(), &i, sizeof(i));
+        producer.commit();
+      }
+    });
+
+    std::uint64_t value = std::uint64_t(-1);
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      while (!dequeue(consumer, value)) {}
+      REQUIRE(value == i);
+    }
+
+    thread.join();
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: extend") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  auto fill = [](std::span<std::byte> buffer, std::size_t from, std::size_t seed) {
+    for (std::size_t i = from; i < buffer.size(); ++i) {
+      buffer[i] = std::byte((i + seed) & 0xff);
+    }
+  };
+  auto check = [](std::span<std::byte const> buffer, std::size_t seed) {
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+      if (buffer[i] != std::byte((i + seed) & 0xff)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  SUBCASE("commit greater size") {
+    REQUIRE(!producer.prepare(1).empty());
+    producer.commit(sizeof(std::uint64_t));
+    REQUIRE(consumer.fetch().size() == sizeof(std::uint64_t));
+    consumer.consume();
+
+    REQUIRE(!producer.prepare(1).empty());
+    REQUIRE_THROWS(producer.commit(4096));
+  }
+
+  SUBCASE("in place and relocate") {
+    std::size_t relocations = 0;
+    for (std::size_t seed = 0; seed < 1000; ++seed) {
+      auto buffer = producer.prepare(16);
+      REQUIRE(!buffer.empty());
+      fill(buffer, 0, seed);
+
+      std::size_t const size = 16 + (seed * 37) % 900;
+      auto extended = producer.extend(size);
+      REQUIRE(extended.size() == size);
+      relocations += (extended.data() != buffer.data()) ? 1 : 0;
+      fill(extended, 16, seed);
+      producer.commit();
+
+      auto received = consumer.fetch();
+      REQUIRE(received.size() == size);
+      REQUIRE(check(received, seed));
+      consumer.consume();
+    }
+    REQUIRE(relocations > 0);
+  }
+
+  SUBCASE("no space") {
+    auto buffer = producer.prepare(16);
+    fill(buffer, 0, 0);
+    REQUIRE(producer.extend(8192).empty());
+    producer.commit();
+
+    auto received = consumer.fetch();
+    REQUIRE(received.size() == 16);
+    REQUIRE(check(received, 0));
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: batch") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  for (std::uint64_t round = 0; round < 100; ++round) {
+    std::array<std::span<std::byte>, 8> buffers;
+    auto const count = producer.prepareBatch(sizeof(std::uint64_t) * 4, buffers);
+    REQUIRE(count > 0);
+
+    std::array<std::size_t, 8> sizes;
+    std::size_t const used = std::min<std::size_t>(count, round % 8 + 1);
+    for (std::size_t i = 0; i < used; ++i) {
+      std::uint64_t const value = round * 8 + i;
+      std::memcpy(buffers[i].data(), &value, sizeof(value));
+      sizes[i] = sizeof(value);
+    }
+    producer.commitBatch(std::span(sizes.data(), used));
+
+    std::array<std::span<std::byte const>, 8> received;
+    REQUIRE(consumer.fetchBatch(received) == used);
+    for (std::size_t i = 0; i < used; ++i) {
+      REQUIRE(received[i].size() == sizeof(std::uint64_t));
+      std::uint64_t value;
+      std::memcpy(&value, received[i].data(), sizeof(value));
+      REQUIRE(value == round * 8 + i);
+    }
+    consumer.consumeBatch(used);
+    REQUIRE(consumer.fetchBatch(received) == 0);
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: abort") {
+  // aborted reservations never reach the consumer, including the ones wrapped to the data start
+  auto run = [](auto& queue) {
+    auto producer = queue.createProducer();
+    auto consumer = queue.createConsumer();
+
+    std::uint64_t value = std::uint64_t(-1);
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      auto buffer = producer.prepare(100);
+      REQUIRE(!buffer.empty());
+      std::memcpy(buffer.data(), &i, sizeof(i));
+      if (i % 3 == 0) {
+        producer.abort();
+        continue;
+      }
+      producer.commit();
+
+      REQUIRE(dequeue(consumer, value));
+      REQUIRE(value == i);
+      REQUIRE(!dequeue(consumer, value));
+    }
+  };
+
+  SUBCASE("default") {
+    BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+    run(queue);
+  }
+
+  SUBCASE("overwrite oldest") {
+    BoundedSPSCOverwriteRawQueue queue(
+        "test", BoundedSPSCOverwriteRawQueue::CreationOptions(4096), AnonymousMemorySource());
+    run(queue);
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: depth and lag") {
+  SUBCASE("default") {
+    BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+    auto producer = queue.createProducer();
+    auto consumer = queue.createConsumer();
+
+    // run through many laps, each message takes one segment
+    std::uint64_t value = 0;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      for (std::uint64_t j = 0; j < i % 10; ++j) {
+        REQUIRE(enqueue(producer, j));
+      }
+      REQUIRE(producer.size() == consumer.lag());
+      REQUIRE(consumer.lag() >= (i % 10) * kHardwareDestructiveInterferenceSize);
+      REQUIRE(producer.messagesBehind() == i % 10);
+      REQUIRE(consumer.messagesBehind() == i % 10);
+
+      for (std::uint64_t j = 0; j < i % 10; ++j) {
+        REQUIRE(dequeue(consumer, value));
+        REQUIRE(value == j);
+        REQUIRE(consumer.messagesBehind() == i % 10 - j - 1);
+      }
+      REQUIRE(producer.size() == 0);
+      REQUIRE(consumer.lag() == 0);
+      REQUIRE(producer.messagesBehind() == 0);
+    }
+
+    for (std::uint64_t i = 0; i < 5; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+    REQUIRE(dequeue(consumer, value));
+
+    // message count survives consumer re-creation and reset
+    consumer = {};
+    consumer = queue.createConsumer();
+    REQUIRE(consumer.messagesBehind() == 4);
+    consumer.reset();
+    REQUIRE(consumer.messagesBehind() == 0);
+    REQUIRE(consumer.lag() == 0);
+    REQUIRE(producer.messagesBehind() == 0);
+  }
+
+  SUBCASE("overwrite oldest") {
+    BoundedSPSCOverwriteRawQueue queue(
+        "test", BoundedSPSCOverwriteRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+    auto producer = queue.createProducer();
+    auto consumer = queue.createConsumer();
+
+    REQUIRE(consumer.lag() == 0);
+    REQUIRE(consumer.messagesBehind() == 0);
+    REQUIRE(!consumer.lapped());
+
+    for (std::uint64_t i = 0; i < 10; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+    REQUIRE(consumer.messagesBehind() == 10);
+    REQUIRE(!consumer.lapped());
+
+    // overrun the consumer
+    for (std::uint64_t i = 10; i < 1000; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+    REQUIRE(consumer.lapped());
+    REQUIRE(consumer.lag() > 4096);
+
+    std::uint64_t value = 0;
+    REQUIRE(dequeue(consumer, value));
+    REQUIRE(!consumer.lapped());
+    REQUIRE(consumer.messagesBehind() == 1000 - value - 1);
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: out of order release") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  SUBCASE("prefix") {
+    for (std::uint64_t i = 0; i < 5; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+
+    std::array<BoundedSPSCRawQueue::Consumer::HeldMessage, 5> held;
+    for (std::uint64_t i = 0; i < 5; ++i) {
+      held[i] = consumer.hold();
+      REQUIRE(!held[i].empty());
+      std::uint64_t value;
+      std::memcpy(&value, held[i].buffer.data(), sizeof(value));
+      REQUIRE(value == i);
+    }
+    REQUIRE(consumer.hold().empty());
+
+    consumer.release(held[3]);
+    consumer.release(held[1]);
+    REQUIRE(producer.messagesBehind() == 5);
+    consumer.release(held[0]);
+    REQUIRE(producer.messagesBehind() == 3);
+    consumer.release(held[2]);
+    REQUIRE(producer.messagesBehind() == 1);
+    consumer.release(held[4]);
+    REQUIRE(producer.messagesBehind() == 0);
+    REQUIRE(producer.size() == 0);
+  }
+
+  SUBCASE("tap") {
+    auto tap = queue.createTap();
+    for (std::uint64_t i = 0; i < 4; ++i) {
+      REQUIRE(enqueue(producer, i));
+    }
+
+    std::array<BoundedSPSCRawQueue::Consumer::HeldMessage, 4> held;
+    for (auto& message : held) {
+      message = consumer.hold();
+    }
+    consumer.release(held[1]);
+    consumer.release(held[2]);
+
+    // tap skips messages released behind the held one
+    std::uint64_t value = std::uint64_t(-1);
+    REQUIRE(dequeue(tap, value));
+    REQUIRE(value == 0);
+    REQUIRE(dequeue(tap, value));
+    REQUIRE(value == 3);
+    REQUIRE(!dequeue(tap, value));
+    REQUIRE(tap.overruns() == 0);
+  }
+
+  SUBCASE("wrap") {
+    // held payloads are never overwritten, released space is reused across laps
+    std::vector<BoundedSPSCRawQueue::Consumer::HeldMessage> held;
+    std::vector<std::uint64_t> values;
+    std::uint64_t next = 0;
+    std::uint64_t holdCount = 0;
+    for (std::uint64_t round = 0; round < 500; ++round) {
+      while (enqueue(producer, next)) {
+        next++;
+      }
+      for (auto message = consumer.hold(); !message.empty(); message = consumer.hold()) {
+        held.push_back(message);
+        values.push_back(holdCount++);
+      }
+      for (std::size_t i = 0; i < held.size(); ++i) {
+        std::uint64_t value;
+        std::memcpy(&value, held[i].buffer.data(), sizeof(value));
+        REQUIRE(value == values[i]);
+      }
+      // release every other message from the back, keep the oldest one
+      for (std::size_t i = held.size(); i >= 3; i -= 2) {
+        consumer.release(held[i - 2]);
+        held.erase(held.begin() + std::ptrdiff_t(i - 2));
+        values.erase(values.begin() + std::ptrdiff_t(i - 2));
+      }
+      if (round % 3 == 0) {
+        for (auto const& message : held) {
+          consumer.release(message);
+        }
+        held.clear();
+        values.clear();
+        REQUIRE(producer.size() == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("BoundedSPSCRawQueue: takeover") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  constexpr auto kTimeout = std::chrono::milliseconds(20);
+
+  auto producer = queue.createProducer();
+  auto primary = queue.tryTakeOverConsumer(kTimeout);
+  REQUIRE(primary);
+  REQUIRE(primary.owner());
+  REQUIRE(!queue.tryTakeOverConsumer(kTimeout));
+  REQUIRE(!queue.tryTakeOverConsumerNoThrow(kTimeout).value());
+  REQUIRE(!BoundedSPSCRawQueue().tryTakeOverConsumerNoThrow(kTimeout));
+
+  for (std::uint64_t i = 0; i < 5; ++i) {
+    REQUIRE(enqueue(producer, i));
+  }
+
+  std::uint64_t value = 0;
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(dequeue(primary, value));
+    REQUIRE(value == i);
+  }
+  // fetched, but primary stalls before processing it
+  REQUIRE(fetch(primary, value));
+  REQUIRE(primary.heartbeat());
+
+  std::this_thread::sleep_for(2 * kTimeout);
+  auto standby = queue.tryTakeOverConsumer(kTimeout);
+  REQUIRE(standby);
+  REQUIRE(standby.owner());
+  REQUIRE(!primary.owner());
+  REQUIRE(!primary.heartbeat());
+
+  // stale primary can't move the shared position
+  primary.consume();
+  REQUIRE(producer.messagesBehind() == 2);
+
+  REQUIRE(dequeue(standby, value));
+  REQUIRE(value == 3);
+  REQUIRE(dequeue(standby, value));
+  REQUIRE(value == 4);
+  REQUIRE(producer.messagesBehind() == 0);
+
+  // resigned owner is replaced without waiting for timeout
+  standby.resign();
+  auto next = queue.tryTakeOverConsumer(std::chrono::hours(1));
+  REQUIRE(next);
+  REQUIRE(!standby.owner());
+  REQUIRE(enqueue(producer, std::uint64_t(5)));
+  REQUIRE(dequeue(next, value));
+  REQUIRE(value == 5);
+
+  // epoch kept in consumer position word doesn't affect free space
+  for (int lap = 0; lap < 4; ++lap) {
+    std::uint64_t count = 0;
+    while (enqueue(producer, count)) {
+      count++;
+    }
+    REQUIRE(count > 0);
+    for (std::uint64_t i = 0; i < count; ++i) {
+      REQUIRE(dequeue(next, value));
+      REQUIRE(value == i);
+    }
+    REQUIRE(producer.size() == 0);
+  }
+}
+
 #if 0
 
 TEST_CASE("BoundedSPSCRawQueue: multipleMessages0") {
@@ -85,4 +696,28 @@ TEST_CASE("BoundedSPSCRawQueue: multipleMessages0") {
 }
 #endif
 
+TEST_CASE("BoundedSPSCRawQueue: result") {
+  auto missing = BoundedSPSCRawQueue::open(
+      "turboq-missing", DefaultMemorySource(std::filesystem::temp_directory_path(), 4096));
+  REQUIRE(!missing);
+  REQUIRE(missing.error() == std::error_code(int(Error::MemorySourceOpen), getErrorCategory()));
+
+  auto queue = BoundedSPSCRawQueue::create("test", {4096}, AnonymousMemorySource());
+  REQUIRE(queue);
+
+  auto producer = queue.value().tryCreateProducer();
+  auto consumer = queue.value().tryCreateConsumer();
+  REQUIRE(producer);
+  REQUIRE(consumer);
+  REQUIRE(!BoundedSPSCRawQueue().tryCreateProducer());
+
+  auto buffer = producer.value().prepare(8);
+  REQUIRE(!buffer.empty());
+  auto const committed = producer.value().tryCommit(8192);
+  REQUIRE(!committed);
+  REQUIRE(committed.error() == std::error_code(int(Error::InvalidArgument), getErrorCategory()));
+  REQUIRE(producer.value().tryCommit(4));
+  REQUIRE(consumer.value().fetch().size() == 4);
+}
+
 } // namespace turboq::testing
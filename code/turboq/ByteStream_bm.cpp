@@ -0,0 +1,156 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "SharedByteStream.h"
+
+namespace turboq {
+namespace {
+
+/// Bytes transferred per iteration
+constexpr std::size_t kTransferSize = std::size_t(64) << 20;
+/// Ring and pipe buffer size
+constexpr std::size_t kBufferSize = std::size_t(1) << 20;
+
+/// Pipe with enlarged buffer
+struct Pipe {
+  int fds[2] = {-1, -1};
+
+  Pipe() {
+    if (::pipe(fds) == -1) {
+      throw std::runtime_error("pipe(...)");
+    }
+    // best effort, limited by /proc/sys/fs/pipe-max-size
+    ::fcntl(fds[1], F_SETPIPE_SZ, int(kBufferSize));
+  }
+
+  ~Pipe() {
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+};
+
+/// Read the whole transfer from pipe into chunk sized buffer
+void readPipe(int fd, std::vector<std::byte>& buffer) {
+  std::size_t received = 0;
+  while (received < kTransferSize) {
+    auto const rc = ::read(fd, buffer.data(), buffer.size());
+    if (rc <= 0) {
+      throw std::runtime_error("read(...)");
+    }
+    ::benchmark::DoNotOptimize(buffer.data());
+    received += std::size_t(rc);
+  }
+}
+
+} // namespace
+
+/// Writer copies chunk into shared ring, reader copies it out
+static void BM_ByteStream_SharedByteStream(::benchmark::State& state) {
+  std::size_t const chunkSize = std::size_t(state.range(0));
+
+  SharedByteStream stream("bm", SharedByteStream::CreationOptions(kBufferSize), AnonymousMemorySource());
+  auto writer = stream.createWriter();
+  auto reader = stream.createReader();
+
+  std::vector<std::byte> source(chunkSize, std::byte(1));
+  std::vector<std::byte> target(chunkSize);
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      std::size_t sent = 0;
+      while (sent < kTransferSize) {
+        if (auto const size = writer.write(source); size != 0) {
+          sent += size;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    std::size_t received = 0;
+    while (received < kTransferSize) {
+      if (auto const size = reader.read(target); size != 0) {
+        ::benchmark::DoNotOptimize(target.data());
+        received += size;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    thread.join();
+  }
+
+  state.SetBytesProcessed(std::int64_t(state.iterations() * kTransferSize));
+}
+
+/// Writer and reader copy through kernel pipe buffer
+static void BM_ByteStream_Pipe(::benchmark::State& state) {
+  std::size_t const chunkSize = std::size_t(state.range(0));
+
+  Pipe pipe;
+  std::vector<std::byte> source(chunkSize, std::byte(1));
+  std::vector<std::byte> target(chunkSize);
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      std::size_t sent = 0;
+      while (sent < kTransferSize) {
+        auto const rc = ::write(pipe.fds[1], source.data(), source.size());
+        if (rc <= 0) {
+          throw std::runtime_error("write(...)");
+        }
+        sent += std::size_t(rc);
+      }
+    });
+
+    readPipe(pipe.fds[0], target);
+    thread.join();
+  }
+
+  state.SetBytesProcessed(std::int64_t(state.iterations() * kTransferSize));
+}
+
+/// Writer maps its pages into pipe (no copy), reader copies them out
+static void BM_ByteStream_Vmsplice(::benchmark::State& state) {
+  std::size_t const chunkSize = std::size_t(state.range(0));
+
+  Pipe pipe;
+  // pages must not be modified while in the pipe, source is never written
+  std::vector<std::byte> source(chunkSize, std::byte(1));
+  std::vector<std::byte> target(chunkSize);
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      std::size_t sent = 0;
+      while (sent < kTransferSize) {
+        iovec iov = {source.data(), source.size()};
+        auto const rc = ::vmsplice(pipe.fds[1], &iov, 1, 0);
+        if (rc <= 0) {
+          throw std::runtime_error("vmsplice(...)");
+        }
+        sent += std::size_t(rc);
+      }
+    });
+
+    readPipe(pipe.fds[0], target);
+    thread.join();
+  }
+
+  state.SetBytesProcessed(std::int64_t(state.iterations() * kTransferSize));
+}
+
+BENCHMARK(BM_ByteStream_SharedByteStream)->Arg(4096)->Arg(65536)->UseRealTime();
+BENCHMARK(BM_ByteStream_Pipe)->Arg(4096)->Arg(65536)->UseRealTime();
+BENCHMARK(BM_ByteStream_Vmsplice)->Arg(4096)->Arg(65536)->UseRealTime();
+
+} // namespace turboq
@@ -0,0 +1,182 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPMCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "bm_utils.h"
+
+namespace turboq {
+namespace {
+
+/// Every n-th message is timed individually
+constexpr std::size_t kSampleEvery = 16;
+
+/// Approximate ring footprint of message with payload size
+constexpr std::size_t footprint(std::size_t size) noexcept {
+  return detail::align_up(size + 32, kHardwareDestructiveInterferenceSize);
+}
+
+struct SPSC {
+  static BoundedSPSCRawQueue create(std::size_t capacity, std::size_t) {
+    return BoundedSPSCRawQueue("bm", {capacity}, AnonymousMemorySource());
+  }
+};
+
+struct SPMC {
+  static BoundedSPMCRawQueue create(std::size_t capacity, std::size_t) {
+    return BoundedSPMCRawQueue("bm", {capacity}, AnonymousMemorySource());
+  }
+};
+
+struct MPSC {
+  static BoundedMPSCRawQueue create(std::size_t capacity, std::size_t size) {
+    return BoundedMPSCRawQueue("bm", {size, std::bit_floor(capacity / footprint(size))}, AnonymousMemorySource());
+  }
+};
+
+/// Last level cache misses of the calling thread, invalid in case of perf
+/// events are not available (e.g. container without CAP_PERFMON)
+class LlcMissCounter {
+private:
+  int fd_ = -1;
+
+public:
+  LlcMissCounter() {
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  ~LlcMissCounter() {
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+  }
+
+  [[nodiscard]] bool valid() const noexcept {
+    return fd_ != -1;
+  }
+
+  void start() noexcept {
+    ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  [[nodiscard]] std::uint64_t stop() noexcept {
+    ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t value = 0;
+    if (::read(fd_, &value, sizeof(value)) != sizeof(value)) {
+      return 0;
+    }
+    return value;
+  }
+};
+
+} // namespace
+
+/// Producer runs half a ring ahead of consumer, so every message touches memory
+/// last used capacity / 2 bytes ago. Rings fitting in cache stay hot.
+template <typename QueueT>
+static void BM_CacheResidency(::benchmark::State& state) {
+  std::size_t const capacity = std::size_t(state.range(0));
+  std::size_t const size = std::size_t(state.range(1));
+
+  auto queue = QueueT::create(capacity, size);
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::vector<std::byte> source(size, std::byte(1));
+  std::vector<std::byte> target(size);
+
+  auto enqueue = [&] {
+    auto buffer = producer.prepare(size);
+    if (buffer.empty()) [[unlikely]] {
+      return false;
+    }
+    std::memcpy(buffer.data(), source.data(), size);
+    producer.commit();
+    return true;
+  };
+  auto dequeue = [&] {
+    auto buffer = consumer.fetch();
+    if (buffer.empty()) [[unlikely]] {
+      state.SkipWithError("queue is empty");
+      return;
+    }
+    std::memcpy(target.data(), buffer.data(), buffer.size());
+    ::benchmark::DoNotOptimize(target.data());
+    consumer.consume();
+  };
+
+  for (std::size_t i = 0; i < capacity / 2 / footprint(size) && enqueue(); ++i) {
+  }
+
+  std::vector<std::int64_t> samples;
+  samples.reserve(std::size_t(1) << 20);
+  LlcMissCounter llcMisses;
+  if (llcMisses.valid()) {
+    llcMisses.start();
+  }
+
+  std::size_t count = 0;
+  for (auto _ : state) {
+    if (++count % kSampleEvery == 0) [[unlikely]] {
+      auto const start = std::chrono::steady_clock::now();
+      enqueue();
+      dequeue();
+      samples.push_back((std::chrono::steady_clock::now() - start).count());
+    } else {
+      enqueue();
+      dequeue();
+    }
+  }
+
+  if (llcMisses.valid()) {
+    state.counters["llc_misses"] = ::benchmark::Counter(double(llcMisses.stop()) / double(state.iterations()));
+  } else {
+    state.SetLabel("no perf events");
+  }
+
+  std::sort(samples.begin(), samples.end());
+  state.counters["p50_ns"] = percentile(samples, 0.5);
+  state.counters["p99_ns"] = percentile(samples, 0.99);
+  state.counters["p999_ns"] = percentile(samples, 0.999);
+  state.SetItemsProcessed(std::int64_t(state.iterations()));
+  state.SetBytesProcessed(std::int64_t(state.iterations() * size));
+}
+
+/// Capacity from 16 KiB to 1 GiB, 64 and 512 bytes messages
+static void CacheResidencyArgs(::benchmark::internal::Benchmark* b) {
+  for (std::int64_t size : {64, 512}) {
+    for (std::int64_t capacity = std::int64_t(16) << 10; capacity <= std::int64_t(1) << 30; capacity *= 4) {
+      b->Args({capacity, size});
+    }
+  }
+  b->ArgNames({"capacity", "size"});
+}
+
+BENCHMARK(BM_CacheResidency<SPSC>)->Apply(CacheResidencyArgs);
+BENCHMARK(BM_CacheResidency<SPMC>)->Apply(CacheResidencyArgs);
+BENCHMARK(BM_CacheResidency<MPSC>)->Apply(CacheResidencyArgs);
+
+} // namespace turboq
@@ -0,0 +1,44 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedDelayedRawQueue.h"
+
+namespace turboq {
+
+/// Schedule batch of messages with delays up to range(0) ticks, then expire them all
+static void BM_Delayed_ScheduleExpire(::benchmark::State& state) {
+  constexpr std::size_t kBatch = 1024;
+  std::uint64_t const spread = state.range(0);
+
+  BoundedDelayedRawQueue queue("bm", {sizeof(std::uint64_t), kBatch}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  auto now = std::chrono::steady_clock::now();
+  std::uint64_t value = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kBatch; ++i) {
+      auto buffer = producer.prepare(sizeof(value));
+      std::memcpy(buffer.data(), &value, sizeof(value));
+      producer.commit(now + std::chrono::microseconds(value++ * 7919 % spread));
+    }
+    now += std::chrono::microseconds(spread);
+    for (std::size_t i = 0; i < kBatch; ++i) {
+      auto received = consumer.fetch(now);
+      ::benchmark::DoNotOptimize(received.data());
+      consumer.consume();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK(BM_Delayed_ScheduleExpire)->Arg(1)->Arg(64)->Arg(4096)->Arg(1 << 20)->Arg(1 << 26);
+
+} // namespace turboq
@@ -46,26 +46,42 @@ TURBOQ_FORCE_INLINE int flockNoInt(int fd, int op) noexcept {
 
 } // namespace
 
-File::File(OpenOnly, std::filesystem::path const& path, OpenMode openMode) {
-  int fd = ::open(path.c_str(), makeOpenFlags(openMode) | O_CLOEXEC);
-  if (fd == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "open(...)");
+File::File(OpenOnly tag, std::filesystem::path const& path, OpenMode openMode) {
+  auto result = openNoThrow(tag, path, openMode);
+  if (!result) {
+    throwError(result.error(), "open(...)");
   }
-
-  this->reset(fd, true);
+  swap(result.value());
 }
 
 File::File(CreateOnly, std::filesystem::path const& path, OpenMode openMode, mode_t mode) {
   int fd = ::open(path.c_str(), makeOpenFlags(openMode) | O_CLOEXEC | O_CREAT | O_EXCL);
   if (fd == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "open(...)");
+    throwError(std::error_code(errno, getPosixErrorCategory()), "open(...)");
   }
   ::fchmod(fd, mode);
 
   this->reset(fd, true);
 }
 
-File::File(OpenOrCreate, std::filesystem::path const& path, OpenMode openMode, mode_t mode) {
+File::File(OpenOrCreate tag, std::filesystem::path const& path, OpenMode openMode, mode_t mode) {
+  auto result = openNoThrow(tag, path, openMode, mode);
+  if (!result) {
+    throwError(result.error(), "open(...)");
+  }
+  swap(result.value());
+}
+
+Result<File> File::openNoThrow(OpenOnly, std::filesystem::path const& path, OpenMode openMode) noexcept {
+  int fd = ::open(path.c_str(), makeOpenFlags(openMode) | O_CLOEXEC);
+  if (fd == -1) {
+    return makePosixErrorCode(errno);
+  }
+  return File(fd, true);
+}
+
+Result<File> File::openNoThrow(
+    OpenOrCreate, std::filesystem::path const& path, OpenMode openMode, mode_t mode) noexcept {
   int const flags = makeOpenFlags(openMode);
   int fd = -1;
   while (true) {
@@ -81,10 +97,9 @@ File::File(OpenOrCreate, std::filesystem::path const& path, OpenMode openMode, m
     break;
   }
   if (fd == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "open(...)");
+    return makePosixErrorCode(errno);
   }
-
-  this->reset(fd, true);
+  return File(fd, true);
 }
 
 File::~File() noexcept {
@@ -117,7 +132,7 @@ Result<> File::closeNoThrow() noexcept {
 
 void File::close() {
   if (auto const result = closeNoThrow(); !result) {
-    throw std::system_error(result.error(), "close(...)");
+    throwError(result.error(), "close(...)");
   }
 }
 
@@ -153,6 +168,13 @@ void File::lock() {
   doLock(LOCK_EX);
 }
 
+Result<> File::lockNoThrow() noexcept {
+  if (flockNoInt(get(), LOCK_EX) == -1) {
+    return makePosixErrorCode(errno);
+  }
+  return success();
+}
+
 bool File::tryLock() {
   return doTryLock(LOCK_EX);
 }
@@ -165,11 +187,50 @@ bool File::tryLockShared() {
   return doTryLock(LOCK_SH);
 }
 
+Result<bool> File::tryLockNoThrow() noexcept {
+  if (flockNoInt(get(), LOCK_EX | LOCK_NB) == -1) {
+    if (errno != EWOULDBLOCK) {
+      return makePosixErrorCode(errno);
+    }
+    return false;
+  }
+  return true;
+}
+
 void File::unlock() {
-  int rc = flockNoInt(get(), LOCK_UN);
-  if (rc == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "flock(...)");
+  if (auto const result = unlockNoThrow(); !result) {
+    throwError(result.error(), "flock(...)");
+  }
+}
+
+Result<> File::unlockNoThrow() noexcept {
+  if (flockNoInt(get(), LOCK_UN) == -1) {
+    return makePosixErrorCode(errno);
   }
+  return success();
+}
+
+bool File::tryLockRange(std::size_t offset, std::size_t size) {
+  auto const result = tryLockRangeNoThrow(offset, size);
+  if (!result) {
+    throwError(result.error(), "fcntl(...)");
+  }
+  return result.value();
+}
+
+Result<bool> File::tryLockRangeNoThrow(std::size_t offset, std::size_t size) noexcept {
+  struct flock lock = {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = static_cast<off_t>(offset);
+  lock.l_len = static_cast<off_t>(size);
+  if (::fcntl(get(), F_OFD_SETLK, &lock) == -1) {
+    if (errno != EAGAIN && errno != EACCES) {
+      return makePosixErrorCode(errno);
+    }
+    return false;
+  }
+  return true;
 }
 
 Result<std::size_t> File::tryGetFileSize() const noexcept {
@@ -183,7 +244,7 @@ Result<std::size_t> File::tryGetFileSize() const noexcept {
 std::size_t File::getFileSize() const {
   struct stat st;
   if (::fstat(this->get(), &st) == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "fstat(...)");
+    throwError(std::error_code(errno, getPosixErrorCategory()), "fstat(...)");
   }
   return st.st_size;
 }
@@ -197,14 +258,14 @@ Result<> File::tryTruncate(std::size_t size) const noexcept {
 
 void File::truncate(std::size_t size) const {
   if (::ftruncate(this->get(), size) == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "ftruncate(...)");
+    throwError(std::error_code(errno, getPosixErrorCategory()), "ftruncate(...)");
   }
 }
 
 TURBOQ_FORCE_INLINE void File::doLock(int op) {
   int rc = flockNoInt(get(), op | LOCK_NB);
   if (rc == -1) {
-    throw std::system_error(errno, getPosixErrorCategory(), "flock(...)");
+    throwError(std::error_code(errno, getPosixErrorCategory()), "flock(...)");
   }
 }
 
@@ -212,7 +273,7 @@ TURBOQ_FORCE_INLINE bool File::doTryLock(int op) {
   int rc = flockNoInt(get(), op | LOCK_NB);
   if (rc == -1) {
     if (errno != EWOULDBLOCK) {
-      throw std::system_error(errno, getPosixErrorCategory(), "flock(...)");
+      throwError(std::error_code(errno, getPosixErrorCategory()), "flock(...)");
     }
     return false;
   }
@@ -59,6 +59,14 @@ public:
   /// Create file if not exists or open otherwise. Throws on error.
   File(OpenOrCreate, std::filesystem::path const& path, OpenMode openMode = OpenMode::ReadOnly, mode_t mode = 0666);
 
+  /// Open file.
+  static Result<File> openNoThrow(
+      OpenOnly, std::filesystem::path const& path, OpenMode openMode = OpenMode::ReadOnly) noexcept;
+
+  /// Create file if not exists or open otherwise.
+  static Result<File> openNoThrow(OpenOrCreate, std::filesystem::path const& path,
+      OpenMode openMode = OpenMode::ReadOnly, mode_t mode = 0666) noexcept;
+
   /// Destructor. Close file descriptor if owns it.
   virtual ~File() noexcept;
 
@@ -102,9 +110,15 @@ public:
   /// Lock file.
   void lock();
 
+  /// Lock file, wait in case of the lock is held by other.
+  Result<> lockNoThrow() noexcept;
+
   /// Try lock file.
   [[nodiscard]] bool tryLock();
 
+  /// Try lock file. Return false in case of the lock is held by other.
+  Result<bool> tryLockNoThrow() noexcept;
+
   /// Shared lock.
   void lockShared();
 
@@ -114,6 +128,16 @@ public:
   /// Unlock file. Throws on error.
   void unlock();
 
+  /// Unlock file.
+  Result<> unlockNoThrow() noexcept;
+
+  /// Try lock byte range of the file exclusively (open file description lock,
+  /// independent of lock()). Released on the last descriptor close.
+  [[nodiscard]] bool tryLockRange(std::size_t offset, std::size_t size);
+
+  /// \see tryLockRange
+  Result<bool> tryLockRangeNoThrow(std::size_t offset, std::size_t size) noexcept;
+
   /// Get file size
   Result<std::size_t> tryGetFileSize() const noexcept;
 
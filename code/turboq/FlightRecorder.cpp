@@ -0,0 +1,204 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <boost/scope_exit.hpp>
+
+#include <turboq/detail/cpu.h>
+#include <turboq/detail/memory.h>
+
+namespace turboq {
+namespace detail {
+
+bool FlightRecorderDetail::check(std::span<std::byte const> buffer) noexcept {
+  if (buffer.size() < kSlotsStartPos) {
+    return false;
+  }
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+    return false;
+  }
+  if (!std::has_single_bit(header->capacity) || header->sampleEvery == 0 ||
+      kSlotsStartPos + header->capacity * sizeof(Slot) > buffer.size()) {
+    return false;
+  }
+  return true;
+}
+
+void FlightRecorderDetail::init(std::span<std::byte> buffer, std::size_t capacity, std::size_t sampleEvery) noexcept {
+  auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+  std::copy(kTag.begin(), kTag.end(), header->tag);
+  header->capacity = capacity;
+  header->sampleEvery = sampleEvery;
+  std::atomic_ref(header->head).store(0, std::memory_order_relaxed);
+  std::atomic_ref(header->triggerCount).store(0, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+FlightRecorderWriter::FlightRecorderWriter(std::span<std::byte> buffer) noexcept
+    : header_(std::bit_cast<Detail::MemoryHeader*>(buffer.data())),
+      slots_(std::bit_cast<Detail::Slot*>(buffer.data() + Detail::kSlotsStartPos)),
+      sampleEvery_(header_->sampleEvery), countdown_(header_->sampleEvery) {}
+
+void FlightRecorderWriter::trigger() noexcept {
+  record(FlightEvent::Trigger, 0, 0);
+  lastEvent_ = FlightEvent::Trigger;
+  std::atomic_ref(header_->triggerCount).fetch_add(1, std::memory_order_release);
+}
+
+void FlightRecorderWriter::record(FlightEvent event, std::uint64_t position, std::uint64_t peerPosition) noexcept {
+  auto const index = std::atomic_ref(header_->head).fetch_add(1, std::memory_order_relaxed);
+  auto& slot = slots_[index & (header_->capacity - 1)];
+
+  // seqlock: readers skip the slot while sequence doesn't match before and after copying
+  std::atomic_ref(slot.sequence).store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::atomic_ref(slot.tsc).store(detail::readTsc(), std::memory_order_relaxed);
+  std::atomic_ref(slot.event).store(std::uint64_t(event), std::memory_order_relaxed);
+  std::atomic_ref(slot.position).store(position, std::memory_order_relaxed);
+  std::atomic_ref(slot.peerPosition).store(peerPosition, std::memory_order_relaxed);
+  std::atomic_ref(slot.sequence).store(index + 1, std::memory_order_release);
+}
+
+Result<FlightRecorder> FlightRecorder::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  FlightRecorder recorder;
+  std::size_t pageSize;
+  std::tie(recorder.file_, pageSize) = std::move(result).value();
+
+  auto storage = detail::tryMapFile(recorder.file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  recorder.storage_ = std::move(storage).value();
+  return recorder;
+}
+
+Result<FlightRecorder> FlightRecorder::create(
+    std::string_view name, CreationOptions const& options, MemorySource const& memorySource) noexcept {
+  if (invalidOption(options)) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  FlightRecorder recorder;
+  std::size_t pageSize;
+  std::tie(recorder.file_, pageSize) = std::move(result).value();
+
+  std::size_t const capacity = detail::upper_pow_2(options.capacityHint);
+  std::size_t const fileSize = detail::align_up(Detail::kSlotsStartPos + capacity * sizeof(Detail::Slot), pageSize);
+
+  // init recorder or check recorder's options is the same as requested,
+  // the lock is released before the recorder is returned
+  {
+    if (auto locked = recorder.file_.lockNoThrow(); !locked) {
+      return failure(locked.error());
+    }
+    BOOST_SCOPE_EXIT_ALL(&) {
+      std::ignore = recorder.file_.unlockNoThrow();
+    };
+    auto const currentSize = recorder.file_.tryGetFileSize();
+    if (!currentSize) {
+      return failure(currentSize.error());
+    }
+    if (currentSize.value() != 0) {
+      if (currentSize.value() != fileSize) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(recorder.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!Detail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+      recorder.storage_ = std::move(storage).value();
+    } else {
+      if (auto truncated = recorder.file_.tryTruncate(fileSize); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(recorder.file_, fileSize);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      Detail::init(storage.value().content(), capacity, options.sampleEvery);
+      recorder.storage_ = std::move(storage).value();
+    }
+  }
+  return recorder;
+}
+
+Result<FlightRecorderWriter> FlightRecorder::tryCreateWriter() noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  return FlightRecorderWriter(storage_.content());
+}
+
+Result<FlightRecorderReader> FlightRecorderReader::open(
+    std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  auto [file, pageSize] = std::move(result).value();
+
+  auto storage = detail::tryMapFileReadOnly(file);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+
+  FlightRecorderReader reader;
+  reader.storage_ = std::move(storage).value();
+  reader.header_ = std::bit_cast<Detail::MemoryHeader*>(reader.storage_.data());
+  reader.slots_ = std::bit_cast<Detail::Slot*>(reader.storage_.data() + Detail::kSlotsStartPos);
+  return reader;
+}
+
+std::vector<FlightRecord> FlightRecorderReader::snapshot() const {
+  std::size_t const capacity = header_->capacity;
+  auto const head = std::atomic_ref(header_->head).load(std::memory_order_acquire);
+
+  std::vector<FlightRecord> records;
+  records.reserve(std::min<std::uint64_t>(head, capacity));
+  for (auto index = head - std::min<std::uint64_t>(head, capacity); index < head; ++index) {
+    auto& slot = slots_[index & (capacity - 1)];
+    auto const sequence = std::atomic_ref(slot.sequence).load(std::memory_order_acquire);
+    if (sequence != index + 1) {
+      // being written or already overwritten
+      continue;
+    }
+    FlightRecord record;
+    record.tsc = std::atomic_ref(slot.tsc).load(std::memory_order_relaxed);
+    record.event = FlightEvent(std::atomic_ref(slot.event).load(std::memory_order_relaxed));
+    record.position = std::atomic_ref(slot.position).load(std::memory_order_relaxed);
+    record.peerPosition = std::atomic_ref(slot.peerPosition).load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::atomic_ref(slot.sequence).load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+} // namespace turboq
@@ -0,0 +1,281 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <turboq/File.h>
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/math.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Flight recorder event
+enum class FlightEvent : std::uint32_t {
+  /// Producer committed message (sampled)
+  Commit = 1,
+  /// Consumer consumed message (sampled)
+  Consume = 2,
+  /// Producer found queue full after refreshing consumer position
+  Full = 3,
+  /// Consumer found queue empty after refreshing producer position
+  Empty = 4,
+  /// Producer wrapped to the data start
+  Wrap = 5,
+  /// Application marked point of interest (e.g. latency spike)
+  Trigger = 6,
+};
+
+/// Recorded event
+struct FlightRecord {
+  /// Time stamp counter (\see detail::readTsc)
+  std::uint64_t tsc = 0;
+  /// Event
+  FlightEvent event = {};
+  /// Position of the recording side
+  std::uint64_t position = 0;
+  /// Position of the other side at the moment of recording
+  std::uint64_t peerPosition = 0;
+};
+
+namespace detail {
+
+/// Flight recorder detail
+struct FlightRecorderDetail {
+  /// Recorder tag
+  static constexpr std::string_view kTag = "turboq/FlightRecorder";
+
+  /// Control struct for recorder buffer
+  struct MemoryHeader {
+    /// Placeholder for tag
+    char tag[kTag.size()];
+    /// Slots count (power of two)
+    std::size_t capacity;
+    /// Record one in sampleEvery sampled events
+    std::size_t sampleEvery;
+    /// Number of claimed slots
+    alignas(kHardwareDestructiveInterferenceSize) std::uint64_t head;
+    /// Number of triggers
+    alignas(kHardwareDestructiveInterferenceSize) std::uint64_t triggerCount;
+
+    static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Record slot, sequence is index + 1 of the record stored in the slot or 0
+  /// while the slot is being written
+  struct Slot {
+    std::uint64_t sequence;
+    std::uint64_t tsc;
+    std::uint64_t event;
+    std::uint64_t position;
+    std::uint64_t peerPosition;
+  };
+  static_assert(std::is_trivially_copyable_v<Slot>);
+
+  /// Offset for the first slot from memory buffer start
+  static constexpr std::size_t kSlotsStartPos = align_up(sizeof(MemoryHeader), kHardwareDestructiveInterferenceSize);
+
+  /// Check buffer points to valid recorder region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept;
+
+  /// Init recorder memory header
+  static void init(std::span<std::byte> buffer, std::size_t capacity, std::size_t sampleEvery) noexcept;
+};
+
+} // namespace detail
+
+/// Recording handle. Sampling state is per handle, so each thread (e.g.
+/// producer and consumer of the same queue) needs its own handle.
+/// Several handles could write to the same recorder concurrently.
+class FlightRecorderWriter {
+private:
+  using Detail = detail::FlightRecorderDetail;
+
+  Detail::MemoryHeader* header_ = nullptr;
+  Detail::Slot* slots_ = nullptr;
+  std::size_t sampleEvery_ = 0;
+  std::size_t countdown_ = 0;
+  FlightEvent lastEvent_ = {};
+
+public:
+  FlightRecorderWriter() = default;
+
+  explicit FlightRecorderWriter(std::span<std::byte> buffer) noexcept;
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return header_ != nullptr;
+  }
+
+  /// Record one in sampleEvery events. peerPosition() returns position of the
+  /// other side, it's invoked only for recorded events.
+  template <typename PeerPosition>
+  TURBOQ_FORCE_INLINE void sample(FlightEvent event, std::size_t position, PeerPosition&& peerPosition) noexcept {
+    lastEvent_ = event;
+    if (--countdown_ == 0) [[unlikely]] {
+      countdown_ = sampleEvery_;
+      record(event, position, peerPosition());
+    }
+  }
+
+  /// Record slow path event, the same event repeated without other events in
+  /// between (e.g. spinning on empty queue) is recorded once
+  /// \see sample
+  template <typename PeerPosition>
+  TURBOQ_FORCE_INLINE void slowPath(FlightEvent event, std::size_t position, PeerPosition&& peerPosition) noexcept {
+    if (event != lastEvent_) {
+      lastEvent_ = event;
+      record(event, position, peerPosition());
+    }
+  }
+
+  /// Record trigger event and notify readers waiting for trigger
+  void trigger() noexcept;
+
+  /// Record event unconditionally
+  void record(FlightEvent event, std::uint64_t position, std::uint64_t peerPosition) noexcept;
+};
+
+/// Shared memory ring of the last queue events for post-mortem of latency
+/// spikes. Queue producers and consumers record one in N operations and every
+/// slow path event with TSC stamp and positions. FlightRecorderReader dumps
+/// the ring from other process on demand or on trigger.
+///
+/// Layout:
+/// +--------------+---+--------+--------+-----+------------------+
+/// | MemoryHeader |xxx| Slot 0 | Slot 1 | ... | Slot capacity-1  |
+/// +--------------+---+--------+--------+-----+------------------+
+class FlightRecorder {
+private:
+  using Detail = detail::FlightRecorderDetail;
+
+  File file_;
+  MappedRegion storage_;
+
+public:
+  struct CreationOptions {
+    /// Records count, rounded up to power of two
+    std::size_t capacityHint;
+    /// Record one in sampleEvery sampled events
+    std::size_t sampleEvery = 1024;
+  };
+
+  FlightRecorder(FlightRecorder const&) = delete;
+  FlightRecorder& operator=(FlightRecorder const&) = delete;
+  FlightRecorder() = default;
+
+  FlightRecorder(FlightRecorder&& that) noexcept {
+    swap(that);
+  }
+
+  FlightRecorder& operator=(FlightRecorder&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only recorder. Throws on error.
+  explicit FlightRecorder(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : FlightRecorder(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create recorder. Throws on error.
+  FlightRecorder(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : FlightRecorder(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only recorder.
+  [[nodiscard]] static Result<FlightRecorder> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Open or create recorder.
+  [[nodiscard]] static Result<FlightRecorder> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on recorder intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create recording handle. Throws on error.
+  /// Handle is valid while recorder object is alive.
+  [[nodiscard]] FlightRecorderWriter createWriter() {
+    return valueOrThrow(tryCreateWriter());
+  }
+
+  /// Create recording handle.
+  /// \see createWriter
+  [[nodiscard]] Result<FlightRecorderWriter> tryCreateWriter() noexcept;
+
+  /// Swap resources with other recorder.
+  void swap(FlightRecorder& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+    swap(storage_, that.storage_);
+  }
+
+  /// \see FlightRecorder::swap
+  friend void swap(FlightRecorder& a, FlightRecorder& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.capacityHint == 0) {
+      return "capacity";
+    }
+    if (options.sampleEvery == 0) {
+      return "sampleEvery";
+    }
+    return nullptr;
+  }
+};
+
+/// Read-only access to flight recorder for dump tools
+class FlightRecorderReader {
+private:
+  using Detail = detail::FlightRecorderDetail;
+
+  MappedRegion storage_;
+  Detail::MemoryHeader* header_ = nullptr;
+  Detail::Slot* slots_ = nullptr;
+
+public:
+  FlightRecorderReader() = default;
+
+  /// Open recorder for reading. Throws on error.
+  explicit FlightRecorderReader(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : FlightRecorderReader(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open recorder for reading.
+  [[nodiscard]] static Result<FlightRecorderReader> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return number of triggers since creation
+  [[nodiscard]] std::uint64_t triggerCount() const noexcept {
+    return std::atomic_ref(header_->triggerCount).load(std::memory_order_acquire);
+  }
+
+  /// Return copy of the recorded events, oldest first.
+  /// Records being overwritten while copying are skipped.
+  [[nodiscard]] std::vector<FlightRecord> snapshot() const;
+};
+
+} // namespace turboq
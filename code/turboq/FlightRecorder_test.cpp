@@ -0,0 +1,183 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "FlightRecorder.h"
+#include "utils.h"
+
+namespace turboq::testing {
+
+TEST_CASE("FlightRecorder: basic") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  std::filesystem::remove(path / "turboq-flight");
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-flight");
+  };
+
+  FlightRecorder recorder("turboq-flight", FlightRecorder::CreationOptions(100, 4), memorySource);
+  REQUIRE_THROWS(FlightRecorder("turboq-flight", FlightRecorder::CreationOptions(1000, 4), memorySource));
+
+  auto writer = recorder.createWriter();
+  FlightRecorderReader reader("turboq-flight", memorySource);
+  REQUIRE(reader.snapshot().empty());
+  REQUIRE(reader.triggerCount() == 0);
+
+  std::size_t peer = 7;
+  auto const peerPosition = [&peer] {
+    return peer;
+  };
+
+  // one in 4 sampled events is recorded
+  for (std::size_t i = 1; i <= 10; ++i) {
+    writer.sample(FlightEvent::Commit, i, peerPosition);
+  }
+  auto records = reader.snapshot();
+  REQUIRE(records.size() == 2);
+  REQUIRE(records[0].event == FlightEvent::Commit);
+  REQUIRE(records[0].position == 4);
+  REQUIRE(records[0].peerPosition == 7);
+  REQUIRE(records[1].position == 8);
+  REQUIRE(records[0].tsc <= records[1].tsc);
+
+  // repeated slow path event is recorded once
+  for (std::size_t i = 0; i < 10; ++i) {
+    writer.slowPath(FlightEvent::Full, 10, peerPosition);
+  }
+  writer.sample(FlightEvent::Commit, 11, peerPosition);
+  writer.slowPath(FlightEvent::Full, 11, peerPosition);
+  writer.trigger();
+  REQUIRE(reader.triggerCount() == 1);
+
+  records = reader.snapshot();
+  REQUIRE(records.size() == 5);
+  REQUIRE(records[2].event == FlightEvent::Full);
+  REQUIRE(records[2].position == 10);
+  REQUIRE(records[3].event == FlightEvent::Full);
+  REQUIRE(records[3].position == 11);
+  REQUIRE(records[4].event == FlightEvent::Trigger);
+
+  // ring keeps the last capacity records
+  for (std::size_t i = 0; i < 1000; ++i) {
+    writer.record(FlightEvent::Wrap, i, 0);
+  }
+  records = reader.snapshot();
+  REQUIRE(records.size() == 128);
+  REQUIRE(records.front().position == 1000 - 128);
+  REQUIRE(records.back().position == 999);
+}
+
+TEST_CASE("FlightRecorder: queue") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  std::filesystem::remove(path / "turboq-flight");
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-flight");
+  };
+
+  FlightRecorder recorder("turboq-flight", FlightRecorder::CreationOptions(4096, 8), memorySource);
+  FlightRecorderReader reader("turboq-flight", memorySource);
+
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  auto producerRecorder = recorder.createWriter();
+  auto consumerRecorder = recorder.createWriter();
+  producer.setFlightRecorder(&producerRecorder);
+  consumer.setFlightRecorder(&consumerRecorder);
+
+  auto count = [&](FlightEvent event) {
+    auto const records = reader.snapshot();
+    return std::count_if(records.begin(), records.end(), [event](FlightRecord const& record) {
+      return record.event == event;
+    });
+  };
+
+  std::uint64_t value = 0;
+  REQUIRE(!dequeue(consumer, value));
+  REQUIRE(!dequeue(consumer, value));
+  REQUIRE(count(FlightEvent::Empty) == 1);
+
+  std::uint64_t sent = 0;
+  while (enqueue(producer, sent)) {
+    ++sent;
+  }
+  REQUIRE(!enqueue(producer, sent));
+  REQUIRE(count(FlightEvent::Full) == 1);
+  REQUIRE(count(FlightEvent::Commit) == std::ptrdiff_t(sent / 8));
+
+  // drain and refill a few laps
+  std::uint64_t received = 0;
+  for (std::size_t lap = 0; lap < 10; ++lap) {
+    while (dequeue(consumer, value)) {
+      REQUIRE(value == received++);
+    }
+    while (enqueue(producer, sent)) {
+      ++sent;
+    }
+  }
+  REQUIRE(count(FlightEvent::Wrap) >= 9);
+  REQUIRE(count(FlightEvent::Full) == 11);
+  REQUIRE(count(FlightEvent::Consume) == std::ptrdiff_t(received / 8));
+
+  auto const records = reader.snapshot();
+  auto const last = std::find_if(records.rbegin(), records.rend(), [](FlightRecord const& record) {
+    return record.event == FlightEvent::Consume;
+  });
+  REQUIRE(last != records.rend());
+  REQUIRE(last->position <= last->peerPosition);
+
+  // detached queue records nothing
+  producer.setFlightRecorder(nullptr);
+  consumer.setFlightRecorder(nullptr);
+  auto const size = reader.snapshot().size();
+  REQUIRE(dequeue(consumer, value));
+  REQUIRE(enqueue(producer, value));
+  REQUIRE(reader.snapshot().size() == size);
+}
+
+TEST_CASE("FlightRecorder: taken over consumer") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  std::filesystem::remove(path / "turboq-flight");
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-flight");
+  };
+
+  FlightRecorder recorder("turboq-flight", FlightRecorder::CreationOptions(64, 1), memorySource);
+  FlightRecorderReader reader("turboq-flight", memorySource);
+
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.tryTakeOverConsumer(std::chrono::milliseconds(1));
+  REQUIRE(consumer);
+
+  auto writer = recorder.createWriter();
+  producer.setFlightRecorder(&writer);
+
+  std::uint64_t value = 0;
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    REQUIRE(enqueue(producer, i));
+    REQUIRE(dequeue(consumer, value));
+  }
+  auto const consumed = *consumer.producerPosition();
+  // consumer position word keeps the takeover epoch
+  REQUIRE(*consumer.consumerPosition() != consumed);
+
+  REQUIRE(enqueue(producer, value));
+  auto const records = reader.snapshot();
+  REQUIRE(!records.empty());
+  REQUIRE(records.back().event == FlightEvent::Commit);
+  REQUIRE(records.back().peerPosition == consumed);
+}
+
+} // namespace turboq::testing
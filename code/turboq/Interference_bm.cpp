@@ -0,0 +1,240 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "Layout.h"
+#include "bm_utils.h"
+#include "utils.h"
+
+namespace turboq {
+namespace {
+
+/// Messages per iteration
+constexpr std::uint64_t kCount = 20000;
+/// Producer sends a message every kInterval
+constexpr std::chrono::nanoseconds kInterval(1000);
+
+/// Memory streamer buffer (per antagonist), well above LLC size
+constexpr std::size_t kStreamSize = std::size_t(64) << 20;
+/// LLC thrasher buffer (per antagonist), around LLC size
+constexpr std::size_t kThrashSize = std::size_t(32) << 20;
+
+using Clock = std::chrono::steady_clock;
+
+enum Antagonist : std::int64_t {
+  /// No interference (baseline)
+  kNone,
+  /// Sequential copy saturating memory bandwidth
+  kMemoryStreamer,
+  /// Random line writes evicting LLC
+  kLlcThrasher,
+  /// Tight loop of cheap syscalls (kernel entry/exit, mitigations flushes)
+  kSyscallStorm,
+};
+
+template <typename Layout>
+using SPSCQueue = BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, Layout>>;
+
+template <typename Layout>
+using MPSCQueue = BoundedMPSCRawQueueImpl<WithLayout<BoundedMPSCRawQueueDefaultTraits, Layout>>;
+
+template <typename Layout>
+SPSCQueue<Layout> createSPSCQueue() {
+  return SPSCQueue<Layout>("bm", {std::size_t(1) << 16}, AnonymousMemorySource());
+}
+
+template <typename Layout>
+MPSCQueue<Layout> createMPSCQueue() {
+  return MPSCQueue<Layout>("bm", {sizeof(std::int64_t), std::size_t(1) << 10}, AnonymousMemorySource());
+}
+
+/// Pin thread to cpu (modulo number of cpus), best effort
+void pinThread(pthread_t thread, unsigned cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &set);
+  ::pthread_setaffinity_np(thread, sizeof(set), &set);
+}
+
+/// Pin calling thread to cpu, previous affinity is restored on destruction
+class ScopedPin {
+private:
+  cpu_set_t saved_;
+  bool restore_ = false;
+
+public:
+  explicit ScopedPin(unsigned cpu) noexcept {
+    restore_ = ::pthread_getaffinity_np(::pthread_self(), sizeof(saved_), &saved_) == 0;
+    pinThread(::pthread_self(), cpu);
+  }
+
+  ~ScopedPin() {
+    if (restore_) {
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(saved_), &saved_);
+    }
+  }
+};
+
+/// Run antagonist until stop is set
+void runAntagonist(Antagonist kind, std::atomic<bool> const& stop) {
+  switch (kind) {
+  case kMemoryStreamer: {
+    std::vector<std::byte> buffer(kStreamSize, std::byte(1));
+    std::size_t const half = buffer.size() / 2;
+    while (!stop.load(std::memory_order_relaxed)) {
+      std::memcpy(buffer.data(), buffer.data() + half, half);
+      ::benchmark::ClobberMemory();
+      std::memcpy(buffer.data() + half, buffer.data(), half);
+      ::benchmark::ClobberMemory();
+    }
+    break;
+  }
+  case kLlcThrasher: {
+    std::vector<std::uint64_t> buffer(kThrashSize / sizeof(std::uint64_t));
+    std::size_t const lines = kThrashSize / kHardwareDestructiveInterferenceSize;
+    std::size_t const stride = kHardwareDestructiveInterferenceSize / sizeof(std::uint64_t);
+    std::uint64_t state = 0x9e3779b97f4a7c15;
+    while (!stop.load(std::memory_order_relaxed)) {
+      for (std::size_t i = 0; i < 4096; ++i) {
+        // xorshift, defeats hardware prefetchers
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        buffer[(state % lines) * stride] += 1;
+      }
+      ::benchmark::ClobberMemory();
+    }
+    break;
+  }
+  case kSyscallStorm:
+    while (!stop.load(std::memory_order_relaxed)) {
+      ::syscall(SYS_getppid);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/// Antagonist threads pinned to cpus after the ones used by producer and consumer
+class Antagonists {
+private:
+  std::atomic<bool> stop_ = false;
+  std::vector<std::thread> threads_;
+
+public:
+  Antagonists(Antagonist kind, std::size_t count) {
+    for (std::size_t i = 0; kind != kNone && i < count; ++i) {
+      threads_.emplace_back([this, kind] {
+        runAntagonist(kind, stop_);
+      });
+      pinThread(threads_.back().native_handle(), unsigned(2 + i));
+    }
+  }
+
+  ~Antagonists() {
+    stop_ = true;
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+};
+
+char const* label(Antagonist kind) noexcept {
+  switch (kind) {
+  case kMemoryStreamer:
+    return "memory-streamer";
+  case kLlcThrasher:
+    return "llc-thrasher";
+  case kSyscallStorm:
+    return "syscall-storm";
+  default:
+    return "none";
+  }
+}
+
+} // namespace
+
+/// One-way latency of paced messages while antagonists run on other cpus.
+/// Producer stamps each message with send time, consumer records receive - send.
+template <typename Queue, Queue (*create)()>
+static void BM_Interference(::benchmark::State& state) {
+  auto const kind = Antagonist(state.range(0));
+  std::size_t const antagonistCount = std::size_t(state.range(1));
+
+  auto queue = create();
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::vector<std::int64_t> samples;
+  samples.reserve(kCount * 64);
+
+  // consumer runs on the benchmark thread
+  ScopedPin pin(0);
+  Antagonists antagonists(kind, antagonistCount);
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      auto next = Clock::now();
+      for (std::uint64_t i = 0; i < kCount; ++i) {
+        while (Clock::now() < next) {}
+        next += kInterval;
+        while (!enqueue(producer, Clock::now().time_since_epoch().count())) {}
+      }
+    });
+    pinThread(thread.native_handle(), 1);
+
+    Clock::rep sent = 0;
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      while (!dequeue(consumer, sent)) {}
+      samples.push_back(Clock::now().time_since_epoch().count() - sent);
+    }
+
+    thread.join();
+  }
+
+  std::sort(samples.begin(), samples.end());
+  state.counters["p50_ns"] = percentile(samples, 0.5);
+  state.counters["p99_ns"] = percentile(samples, 0.99);
+  state.counters["p999_ns"] = percentile(samples, 0.999);
+  state.counters["max_ns"] = samples.empty() ? 0.0 : double(samples.back());
+  state.SetItemsProcessed(std::int64_t(state.iterations() * kCount));
+  state.SetLabel(label(kind));
+}
+
+/// Antagonist kind x antagonist threads
+static void InterferenceArgs(::benchmark::internal::Benchmark* b) {
+  b->Args({kNone, 0});
+  for (std::int64_t kind : {kMemoryStreamer, kLlcThrasher, kSyscallStorm}) {
+    for (std::int64_t count : {1, 2}) {
+      b->Args({kind, count});
+    }
+  }
+  b->ArgNames({"antagonist", "threads"});
+  b->UseRealTime();
+}
+
+BENCHMARK(BM_Interference<SPSCQueue<DefaultLayout>, createSPSCQueue<DefaultLayout>>)->Apply(InterferenceArgs);
+BENCHMARK(BM_Interference<SPSCQueue<X86AdjacentPrefetchLayout>, createSPSCQueue<X86AdjacentPrefetchLayout>>)
+    ->Apply(InterferenceArgs);
+BENCHMARK(BM_Interference<MPSCQueue<DefaultLayout>, createMPSCQueue<DefaultLayout>>)->Apply(InterferenceArgs);
+BENCHMARK(BM_Interference<MPSCQueue<X86AdjacentPrefetchLayout>, createMPSCQueue<X86AdjacentPrefetchLayout>>)
+    ->Apply(InterferenceArgs);
+
+} // namespace turboq
@@ -0,0 +1,50 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <cstddef>
+
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// x86-64 without adjacent-line prefetch: 64 bytes lines
+struct X86Layout {
+  static constexpr std::size_t kSegmentSize = 64;
+  static constexpr std::size_t kAlign = 64;
+};
+
+/// x86-64 with adjacent-line (spatial) prefetch: lines are pulled in 128 bytes pairs
+struct X86AdjacentPrefetchLayout {
+  static constexpr std::size_t kSegmentSize = 128;
+  static constexpr std::size_t kAlign = 128;
+};
+
+/// ARM64 with 64 bytes lines (Neoverse, Cortex-A)
+struct Arm64Layout {
+  static constexpr std::size_t kSegmentSize = 64;
+  static constexpr std::size_t kAlign = 64;
+};
+
+/// ARM64 with 128 bytes lines (Apple M-series)
+struct Arm128Layout {
+  static constexpr std::size_t kSegmentSize = 128;
+  static constexpr std::size_t kAlign = 128;
+};
+
+/// Layout used by default traits
+struct DefaultLayout {
+  static constexpr std::size_t kSegmentSize = kHardwareDestructiveInterferenceSize;
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+};
+
+/// Replace segment size and alignment of queue traits with layout preset.
+/// Example: BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, X86Layout>>
+template <typename Traits, typename Layout>
+struct WithLayout : Traits {
+  static constexpr std::size_t kSegmentSize = Layout::kSegmentSize;
+  static constexpr std::size_t kAlign = Layout::kAlign;
+};
+
+} // namespace turboq
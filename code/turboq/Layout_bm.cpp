@@ -0,0 +1,116 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "Layout.h"
+#include "utils.h"
+
+namespace turboq {
+
+template <typename Layout>
+struct SPSCQueue : BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, Layout>> {
+  static constexpr std::size_t kAlign = Layout::kAlign;
+
+  SPSCQueue()
+      : BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, Layout>>(
+            "bm", {std::size_t(1 << 20)}, AnonymousMemorySource()) {}
+};
+
+template <typename Layout>
+struct MPSCQueue : BoundedMPSCRawQueueImpl<WithLayout<BoundedMPSCRawQueueDefaultTraits, Layout>> {
+  static constexpr std::size_t kAlign = Layout::kAlign;
+
+  MPSCQueue()
+      : BoundedMPSCRawQueueImpl<WithLayout<BoundedMPSCRawQueueDefaultTraits, Layout>>(
+            "bm", {sizeof(std::uint64_t), std::size_t(1 << 14)}, AnonymousMemorySource()) {}
+};
+
+static void ApplyCustomArgs(::benchmark::internal::Benchmark* b) {
+  b->MeasureProcessCPUTime();
+  b->UseRealTime();
+}
+
+/// Enqueue and dequeue from the same thread (memory footprint per message)
+template <typename QueueT>
+static void BM_Layout_EnqueueDequeue_NoThreads(::benchmark::State& state) {
+  if (!detail::isCacheLineAligned(QueueT::kAlign)) {
+    state.SkipWithError("preset doesn't match CPU cache line size");
+    return;
+  }
+
+  auto queue = QueueT();
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::uint64_t counter = 0;
+  std::uint64_t value = 0;
+
+  for (auto _ : state) {
+    while (!enqueue(producer, counter++)) {}
+    while (!dequeue(consumer, value)) {}
+    ::benchmark::DoNotOptimize(value);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Producer and consumer on different threads (false sharing between positions and messages)
+template <typename QueueT>
+static void BM_Layout_EnqueueDequeue_Threads(::benchmark::State& state) {
+  if (!detail::isCacheLineAligned(QueueT::kAlign)) {
+    state.SkipWithError("preset doesn't match CPU cache line size");
+    return;
+  }
+
+  constexpr std::uint64_t kCount = 100000;
+
+  for (auto _ : state) {
+    auto queue = QueueT();
+    auto producer = queue.createProducer();
+    auto consumer = queue.createConsumer();
+
+    std::thread thread([&] {
+      for (std::uint64_t i = 0; i < kCount; ++i) {
+        while (!enqueue(producer, i)) {}
+      }
+    });
+
+    std::uint64_t value = 0;
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      while (!dequeue(consumer, value)) {}
+    }
+    ::benchmark::DoNotOptimize(value);
+
+    thread.join();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<SPSCQueue<X86Layout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<SPSCQueue<X86AdjacentPrefetchLayout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<SPSCQueue<Arm64Layout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<SPSCQueue<Arm128Layout>>);
+
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<MPSCQueue<X86Layout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<MPSCQueue<X86AdjacentPrefetchLayout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<MPSCQueue<Arm64Layout>>);
+BENCHMARK(BM_Layout_EnqueueDequeue_NoThreads<MPSCQueue<Arm128Layout>>);
+
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<SPSCQueue<X86Layout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<SPSCQueue<X86AdjacentPrefetchLayout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<SPSCQueue<Arm64Layout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<SPSCQueue<Arm128Layout>>)->Apply(ApplyCustomArgs);
+
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<MPSCQueue<X86Layout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<MPSCQueue<X86AdjacentPrefetchLayout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<MPSCQueue<Arm64Layout>>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Layout_EnqueueDequeue_Threads<MPSCQueue<Arm128Layout>>)->Apply(ApplyCustomArgs);
+
+} // namespace turboq
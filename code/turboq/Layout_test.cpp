@@ -0,0 +1,64 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <bit>
+#include <filesystem>
+
+#include <doctest/doctest.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPMCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "Layout.h"
+
+namespace turboq::testing {
+
+TEST_CASE("Layout: cache line size") {
+  auto const size = detail::cacheLineSize();
+  INFO("Cache line size is ", size);
+  REQUIRE((size == 0 || std::has_single_bit(size)));
+
+  // default traits fit both 64 and 128 bytes lines
+  REQUIRE(detail::isCacheLineAligned(DefaultLayout::kAlign));
+  REQUIRE(detail::isCacheLineAligned(2 * DefaultLayout::kAlign));
+}
+
+TEST_CASE("Layout: refuse to attach with different layout") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+
+  SUBCASE("SPSC") {
+    using Queue = BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, DefaultLayout>>;
+    using OtherQueue = BoundedSPSCRawQueueImpl<WithLayout<BoundedSPSCRawQueueDefaultTraits, X86Layout>>;
+
+    std::filesystem::remove(path / "turboq-layout-spsc");
+    Queue queue("turboq-layout-spsc", Queue::CreationOptions(4096), memorySource);
+    REQUIRE_NOTHROW(Queue("turboq-layout-spsc", memorySource));
+    REQUIRE_THROWS(OtherQueue("turboq-layout-spsc", memorySource));
+    std::filesystem::remove(path / "turboq-layout-spsc");
+  }
+
+  SUBCASE("SPMC") {
+    using Queue = BoundedSPMCRawQueueImpl<WithLayout<BoundedSPMCRawQueueDefaultTraits, DefaultLayout>>;
+    using OtherQueue = BoundedSPMCRawQueueImpl<WithLayout<BoundedSPMCRawQueueDefaultTraits, Arm64Layout>>;
+
+    std::filesystem::remove(path / "turboq-layout-spmc");
+    Queue queue("turboq-layout-spmc", Queue::CreationOptions(4096), memorySource);
+    REQUIRE_NOTHROW(Queue("turboq-layout-spmc", memorySource));
+    REQUIRE_THROWS(OtherQueue("turboq-layout-spmc", memorySource));
+    std::filesystem::remove(path / "turboq-layout-spmc");
+  }
+
+  SUBCASE("MPSC") {
+    using Queue = BoundedMPSCRawQueueImpl<WithLayout<BoundedMPSCRawQueueDefaultTraits, DefaultLayout>>;
+    using OtherQueue = BoundedMPSCRawQueueImpl<WithLayout<BoundedMPSCRawQueueDefaultTraits, X86Layout>>;
+
+    std::filesystem::remove(path / "turboq-layout-mpsc");
+    Queue queue("turboq-layout-mpsc", Queue::CreationOptions(64, 16), memorySource);
+    REQUIRE_NOTHROW(Queue("turboq-layout-mpsc", memorySource));
+    REQUIRE_THROWS(OtherQueue("turboq-layout-mpsc", memorySource));
+    std::filesystem::remove(path / "turboq-layout-mpsc");
+  }
+}
+
+} // namespace turboq::testing
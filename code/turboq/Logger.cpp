@@ -0,0 +1,204 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "Logger.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace turboq {
+namespace {
+
+/// Unique logger id for thread-local producer cache, zero is never used
+std::atomic<std::uint64_t> gLoggerId = 0;
+
+constexpr std::string_view kLevelNames[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+/// Format record timestamp, date and time are cached per second
+class TimestampFormatter {
+private:
+  std::int64_t seconds_ = -1;
+  char prefix_[32] = {};
+  std::size_t prefixSize_ = 0;
+
+public:
+  void formatTo(fmt::memory_buffer& out, std::int64_t timestamp) {
+    std::int64_t const seconds = timestamp / 1000000000;
+    if (seconds != seconds_) {
+      std::time_t const time = seconds;
+      std::tm tm;
+      ::gmtime_r(&time, &tm);
+      prefixSize_ = std::strftime(prefix_, sizeof(prefix_), "%Y-%m-%d %H:%M:%S", &tm);
+      seconds_ = seconds;
+    }
+    out.append(prefix_, prefix_ + prefixSize_);
+    fmt::format_to(std::back_inserter(out), ".{:09}", timestamp % 1000000000);
+  }
+};
+
+thread_local TimestampFormatter gTimestampFormatter;
+
+} // namespace
+
+Logger::Logger(std::filesystem::path const& path)
+    : Logger(path, Options{std::size_t(1) << 20, std::size_t(64) << 10, std::chrono::microseconds(100)}) {}
+
+Logger::Logger(std::filesystem::path const& path, Options const& options)
+    : file_(kOpenOrCreate, path, OpenMode::ReadWrite, 0644), options_(options), id_(++gLoggerId) {
+  if (options_.queueCapacity == 0) {
+    throwError(Error::InvalidArgument, "queue capacity");
+  }
+  if (::lseek(file_.get(), 0, SEEK_END) == -1) {
+    throwError(std::error_code(errno, getPosixErrorCategory()), "lseek(...)");
+  }
+  backend_ = std::thread([this] {
+    run();
+  });
+}
+
+Logger::~Logger() {
+  stop_.store(true, std::memory_order_release);
+  backend_.join();
+}
+
+BoundedSPSCRawQueue::Producer& Logger::registerThread() {
+  /// Queues of calling thread, retired on thread exit
+  struct ThreadChannels {
+    // thread could alternate between loggers, keep every queue it was given
+    std::vector<std::pair<std::uint64_t, std::weak_ptr<Channel>>> entries;
+
+    ~ThreadChannels() {
+      for (auto const& [id, entry] : entries) {
+        if (auto channel = entry.lock()) {
+          // records committed by the thread are visible to backend reading the flag
+          channel->retired.store(true, std::memory_order_release);
+        }
+      }
+    }
+  };
+  thread_local ThreadChannels thread;
+
+  // forget queues of destroyed loggers
+  std::erase_if(thread.entries, [](auto const& entry) {
+    return entry.second.expired();
+  });
+  for (auto const& [id, entry] : thread.entries) {
+    if (id == id_) {
+      return entry.lock()->producer;
+    }
+  }
+
+  auto channel = std::make_shared<Channel>();
+  channel->queue = BoundedSPSCRawQueue(
+      "turboq-log", BoundedSPSCRawQueue::CreationOptions(options_.queueCapacity), AnonymousMemorySource());
+  channel->producer = channel->queue.createProducer();
+  channel->consumer = channel->queue.createConsumer();
+  thread.entries.emplace_back(id_, channel);
+  auto& producer = channel->producer;
+
+  {
+    std::lock_guard lock(mutex_);
+    channels_.push_back(std::move(channel));
+  }
+  channelsVersion_.fetch_add(1, std::memory_order_release);
+
+  return producer;
+}
+
+void Logger::removeChannels(std::vector<Channel*> const& retired) {
+  {
+    std::lock_guard lock(mutex_);
+    std::erase_if(channels_, [&](auto const& channel) {
+      return std::find(retired.begin(), retired.end(), channel.get()) != retired.end();
+    });
+  }
+  channelsVersion_.fetch_add(1, std::memory_order_release);
+}
+
+void Logger::run() {
+  fmt::memory_buffer out;
+  std::vector<std::shared_ptr<Channel>> channels;
+  std::vector<Channel*> retired;
+  std::uint64_t version = 0;
+
+  while (true) {
+    // read stop flag before draining, so records committed before stop are written
+    bool const stop = stop_.load(std::memory_order_acquire);
+
+    if (auto const current = channelsVersion_.load(std::memory_order_acquire); current != version) {
+      std::lock_guard lock(mutex_);
+      channels = channels_;
+      version = current;
+    }
+
+    bool busy = false;
+    for (auto const& channel : channels) {
+      // read retired flag before draining, so the last records are written
+      bool const last = channel->retired.load(std::memory_order_acquire);
+      busy |= drain(*channel, out);
+      if (last) {
+        retired.push_back(channel.get());
+      }
+    }
+
+    if (!retired.empty()) [[unlikely]] {
+      removeChannels(retired);
+      retired.clear();
+    }
+
+    if (!busy) {
+      write(out);
+      if (stop) {
+        return;
+      }
+      std::this_thread::sleep_for(options_.idleSleep);
+    }
+  }
+}
+
+bool Logger::drain(Channel& channel, fmt::memory_buffer& out) {
+  bool any = false;
+  for (auto buffer = channel.consumer.fetch(); !buffer.empty(); buffer = channel.consumer.fetch()) {
+    detail::LogRecordHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    auto const& metadata = *header.metadata;
+
+    auto const file = metadata.file.substr(metadata.file.rfind('/') + 1);
+    gTimestampFormatter.formatTo(out, header.timestamp);
+    fmt::format_to(std::back_inserter(out), " {} {}:{} ", kLevelNames[std::size_t(metadata.level)], file,
+        metadata.line);
+    metadata.formatTo(out, metadata.format, buffer.data() + sizeof(header));
+    out.push_back('\n');
+
+    channel.consumer.consume();
+    any = true;
+
+    if (out.size() >= options_.writeBatchSize) {
+      write(out);
+    }
+  }
+  return any;
+}
+
+void Logger::write(fmt::memory_buffer& out) {
+  std::size_t written = 0;
+  while (written < out.size()) {
+    auto const rc = ::write(file_.get(), out.data() + written, out.size() - written);
+    if (rc == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fmt::print(stderr, "turboq: failed to write log: {}\n", std::strerror(errno));
+      break;
+    }
+    written += std::size_t(rc);
+  }
+  out.clear();
+}
+
+} // namespace turboq
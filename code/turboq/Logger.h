@@ -0,0 +1,269 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <turboq/BoundedSPSCRawQueue.h>
+#include <turboq/File.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Log record severity
+enum class LogLevel : std::uint8_t { Debug, Info, Warning, Error };
+
+namespace detail {
+
+/// String literal usable as template argument
+template <std::size_t N>
+struct LogString {
+  char value[N];
+
+  consteval LogString(char const (&str)[N]) noexcept {
+    std::copy_n(str, N, value);
+  }
+
+  [[nodiscard]] constexpr std::string_view view() const noexcept {
+    return {value, N - 1};
+  }
+};
+
+/// Strings are copied into record as length and bytes
+template <typename T>
+inline constexpr bool kLogStringArg = std::is_convertible_v<T const&, std::string_view>;
+
+/// Values are copied into record as is
+template <typename T>
+concept LogArgument = kLogStringArg<T> || std::is_arithmetic_v<T> || std::is_pointer_v<T>;
+
+/// Argument type the backend formats
+template <typename T>
+using LogDecoded = std::conditional_t<kLogStringArg<T>, std::string_view, T>;
+
+/// Return encoded argument size
+template <typename T>
+[[nodiscard]] TURBOQ_FORCE_INLINE std::size_t logArgSize(T const& value) noexcept {
+  if constexpr (kLogStringArg<T>) {
+    return sizeof(std::uint32_t) + std::string_view(value).size();
+  } else {
+    return sizeof(T);
+  }
+}
+
+/// Encode argument and advance out
+template <typename T>
+TURBOQ_FORCE_INLINE void logArgEncode(std::byte*& out, T const& value) noexcept {
+  if constexpr (kLogStringArg<T>) {
+    std::string_view const str(value);
+    auto const size = static_cast<std::uint32_t>(str.size());
+    std::memcpy(out, &size, sizeof(size));
+    std::memcpy(out + sizeof(size), str.data(), size);
+    out += sizeof(size) + size;
+  } else {
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+  }
+}
+
+/// Decode argument and advance in
+template <typename T>
+[[nodiscard]] TURBOQ_FORCE_INLINE LogDecoded<T> logArgDecode(std::byte const*& in) noexcept {
+  if constexpr (kLogStringArg<T>) {
+    std::uint32_t size;
+    std::memcpy(&size, in, sizeof(size));
+    std::string_view const str(std::bit_cast<char const*>(in + sizeof(size)), size);
+    in += sizeof(size) + size;
+    return str;
+  } else {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+}
+
+/// Format string checked by fmt against argument types at compile time
+template <typename... Args>
+consteval bool checkLogFormat(std::string_view format) {
+  [[maybe_unused]] fmt::format_string<Args...> const checked(format);
+  return true;
+}
+
+/// Call site description, address is the format id stored in records
+struct LogMetadata {
+  LogLevel level;
+  std::string_view format;
+  std::string_view file;
+  std::uint32_t line;
+  /// Decode record arguments and append formatted message
+  void (*formatTo)(fmt::memory_buffer& out, std::string_view format, std::byte const* args);
+};
+
+/// Call site registered at compile time
+template <LogLevel Level, LogString Format, LogString File, std::uint32_t Line, typename... Args>
+struct LogSite {
+  static_assert(checkLogFormat<LogDecoded<Args>...>(Format.view()));
+
+  static void formatTo(fmt::memory_buffer& out, std::string_view format, [[maybe_unused]] std::byte const* args) {
+    // braced init list evaluates decoders left to right
+    std::tuple<LogDecoded<Args>...> const values{logArgDecode<Args>(args)...};
+    std::apply(
+        [&](auto const&... values) {
+          fmt::vformat_to(std::back_inserter(out), format, fmt::make_format_args(values...));
+        },
+        values);
+  }
+
+  static constexpr LogMetadata kMetadata = {Level, Format.view(), File.view(), Line, &formatTo};
+};
+
+/// Log record header, encoded arguments follow
+struct LogRecordHeader {
+  LogMetadata const* metadata;
+  /// System clock time in nanoseconds
+  std::int64_t timestamp;
+};
+
+} // namespace detail
+
+/// Asynchronous logger: hot threads copy format id and raw arguments into per-thread
+/// SPSC queues, backend thread formats records with fmt and writes them in batches.
+class Logger {
+public:
+  struct Options {
+    /// Per-thread queue capacity
+    std::size_t queueCapacity;
+    /// Backend writes to file once buffer exceeds this size or queues are empty
+    std::size_t writeBatchSize;
+    /// Backend sleep time when queues are empty
+    std::chrono::microseconds idleSleep;
+  };
+
+private:
+  struct Channel {
+    BoundedSPSCRawQueue queue;
+    BoundedSPSCRawQueue::Producer producer;
+    BoundedSPSCRawQueue::Consumer consumer;
+    /// Set on producer thread exit, backend drains and removes the channel
+    std::atomic<bool> retired = false;
+  };
+
+  File file_;
+  Options options_;
+  std::uint64_t id_ = 0;
+  std::atomic<LogLevel> level_ = LogLevel::Info;
+  std::atomic<std::uint64_t> dropped_ = 0;
+  std::atomic<std::uint64_t> channelsVersion_ = 0;
+  std::atomic<bool> stop_ = false;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Channel>> channels_;
+  std::thread backend_;
+
+public:
+  Logger(Logger const&) = delete;
+  Logger& operator=(Logger const&) = delete;
+
+  /// Open file for appending and start backend thread. Throws on error.
+  explicit Logger(std::filesystem::path const& path);
+
+  /// \overload
+  Logger(std::filesystem::path const& path, Options const& options);
+
+  /// Stop backend thread, records committed before are written
+  ~Logger();
+
+  /// Return min level of records to log
+  [[nodiscard]] TURBOQ_FORCE_INLINE LogLevel level() const noexcept {
+    return level_.load(std::memory_order_relaxed);
+  }
+
+  /// Set min level of records to log
+  TURBOQ_FORCE_INLINE void setLevel(LogLevel level) noexcept {
+    level_.store(level, std::memory_order_relaxed);
+  }
+
+  /// Return count of records dropped on full queue
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::uint64_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  /// Enqueue record, no formatting is done on calling thread. Use TURBOQ_LOG macro.
+  /// Return false in case of record filtered out or dropped.
+  template <LogLevel Level, detail::LogString Format, detail::LogString File, std::uint32_t Line,
+      detail::LogArgument... Args>
+  TURBOQ_FORCE_INLINE bool log(Args const&... args) {
+    if (Level < level()) {
+      return false;
+    }
+
+    using Site = detail::LogSite<Level, Format, File, Line, std::decay_t<Args>...>;
+
+    auto& producer = this->producer();
+    auto buffer = producer.prepare(sizeof(detail::LogRecordHeader) + (std::size_t(0) + ... + detail::logArgSize(args)));
+    if (buffer.empty()) [[unlikely]] {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    detail::LogRecordHeader const header = {&Site::kMetadata,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count()};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    [[maybe_unused]] std::byte* out = buffer.data() + sizeof(header);
+    (detail::logArgEncode(out, args), ...);
+    producer.commit();
+
+    return true;
+  }
+
+private:
+  /// Return calling thread queue producer
+  [[nodiscard]] TURBOQ_FORCE_INLINE BoundedSPSCRawQueue::Producer& producer() {
+    // the last logger used by the thread
+    thread_local std::uint64_t cachedId = 0;
+    thread_local BoundedSPSCRawQueue::Producer* cachedProducer = nullptr;
+    if (cachedId != id_) [[unlikely]] {
+      cachedProducer = &registerThread();
+      cachedId = id_;
+    }
+    return *cachedProducer;
+  }
+
+  /// Find or create queue for calling thread, queue is retired on thread exit
+  BoundedSPSCRawQueue::Producer& registerThread();
+
+  /// Remove drained retired channels
+  void removeChannels(std::vector<Channel*> const& retired);
+
+  /// Backend thread loop
+  void run();
+
+  /// Drain queue into buffer, return true in case of any record
+  bool drain(Channel& channel, fmt::memory_buffer& out);
+
+  /// Write buffer to file
+  void write(fmt::memory_buffer& out);
+};
+
+} // namespace turboq
+
+/// Log record with compile-time registered format
+#define TURBOQ_LOG(logger, level, format, ...) \
+  (logger).log<turboq::LogLevel::level, format, __FILE__, __LINE__>(__VA_ARGS__)
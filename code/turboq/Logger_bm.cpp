@@ -0,0 +1,52 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <iterator>
+#include <string_view>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include "Logger.h"
+
+namespace turboq {
+
+/// Hot thread cost: copy format id and arguments into the thread queue
+static void BM_Logger_Log(::benchmark::State& state) {
+  Logger logger("/dev/null", {std::size_t(16) << 20, std::size_t(64) << 10, std::chrono::microseconds(100)});
+
+  std::string_view const symbol = "EURUSD";
+  std::uint64_t id = 0;
+  for (auto _ : state) {
+    while (!TURBOQ_LOG(logger, Info, "order {} {} qty {} price {:.5f}", id, symbol, 1000000, 1.08543)) {
+      // let backend drain the queue, measure enqueue cost only
+      state.PauseTiming();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      state.ResumeTiming();
+    }
+    id++;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Synchronous formatting on the hot thread for comparison
+static void BM_Logger_Format(::benchmark::State& state) {
+  fmt::memory_buffer out;
+
+  std::string_view const symbol = "EURUSD";
+  std::uint64_t id = 0;
+  for (auto _ : state) {
+    out.clear();
+    fmt::format_to(std::back_inserter(out), "order {} {} qty {} price {:.5f}\n", id++, symbol, 1000000, 1.08543);
+    ::benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Logger_Log);
+BENCHMARK(BM_Logger_Format);
+
+} // namespace turboq
@@ -0,0 +1,148 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "Logger.h"
+
+namespace turboq::testing {
+namespace {
+
+std::vector<std::string> readLines(std::filesystem::path const& path) {
+  std::vector<std::string> lines;
+  std::ifstream stream(path);
+  for (std::string line; std::getline(stream, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+bool endsWith(std::string_view str, std::string_view suffix) {
+  return str.size() >= suffix.size() && str.substr(str.size() - suffix.size()) == suffix;
+}
+
+} // namespace
+
+TEST_CASE("Logger: format") {
+  auto const path = std::filesystem::temp_directory_path() / "turboq-logger-test.log";
+  std::filesystem::remove(path);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path);
+  };
+
+  {
+    Logger logger(path);
+    std::string const name = "world";
+    REQUIRE(TURBOQ_LOG(logger, Info, "hello"));
+    REQUIRE(TURBOQ_LOG(logger, Warning, "hello {} {} {:.2f} {}", name, 42, 3.14159, "literal"));
+    REQUIRE_FALSE(TURBOQ_LOG(logger, Debug, "filtered {}", 1));
+    logger.setLevel(LogLevel::Debug);
+    REQUIRE(TURBOQ_LOG(logger, Debug, "{:>5}|{}", 7, 'c'));
+  }
+
+  auto const lines = readLines(path);
+  REQUIRE(lines.size() == 3);
+  REQUIRE(lines[0].find(" INFO Logger_test.cpp:") != std::string::npos);
+  REQUIRE(endsWith(lines[0], " hello"));
+  REQUIRE(lines[1].find(" WARN ") != std::string::npos);
+  REQUIRE(endsWith(lines[1], " hello world 42 3.14 literal"));
+  REQUIRE(lines[2].find(" DEBUG ") != std::string::npos);
+  REQUIRE(endsWith(lines[2], "    7|c"));
+  // timestamp: YYYY-mm-dd HH:MM:SS.nnnnnnnnn
+  REQUIRE(lines[0].size() > 30);
+  REQUIRE(lines[0][4] == '-');
+  REQUIRE(lines[0][10] == ' ');
+  REQUIRE(lines[0][19] == '.');
+  REQUIRE(lines[0][29] == ' ');
+}
+
+TEST_CASE("Logger: threads") {
+  constexpr int kThreads = 3;
+  constexpr int kCount = 2000;
+
+  auto const path = std::filesystem::temp_directory_path() / "turboq-logger-test.log";
+  std::filesystem::remove(path);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path);
+  };
+
+  std::uint64_t dropped = 0;
+  {
+    Logger logger(path, {1 << 20, 4096, std::chrono::microseconds(10)});
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kThreads; ++thread) {
+      threads.emplace_back([&logger, thread] {
+        for (int i = 0; i < kCount; ++i) {
+          while (!TURBOQ_LOG(logger, Info, "thread {} message {}", thread, i)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    dropped = logger.dropped();
+  }
+
+  // per-thread order is preserved
+  std::vector<int> next(kThreads, 0);
+  auto const lines = readLines(path);
+  REQUIRE(lines.size() == kThreads * kCount);
+  for (auto const& line : lines) {
+    auto const pos = line.find("thread ");
+    REQUIRE(pos != std::string::npos);
+    int thread = 0;
+    int message = 0;
+    REQUIRE(std::sscanf(line.c_str() + pos, "thread %d message %d", &thread, &message) == 2);
+    REQUIRE(message == next[thread]++);
+  }
+  REQUIRE(dropped == 0);
+}
+
+TEST_CASE("Logger: thread churn") {
+  constexpr int kThreads = 200;
+
+  auto const path = std::filesystem::temp_directory_path() / "turboq-logger-test.log";
+  std::filesystem::remove(path);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path);
+  };
+
+  {
+    Logger logger(path, {1 << 16, 4096, std::chrono::microseconds(10)});
+    // queue of exited thread is drained and released by backend
+    for (int thread = 0; thread < kThreads; ++thread) {
+      std::thread([&logger, thread] {
+        REQUIRE(TURBOQ_LOG(logger, Info, "thread {}", thread));
+      }).join();
+    }
+    REQUIRE(TURBOQ_LOG(logger, Info, "main"));
+  }
+
+  // logger destroyed before thread exit
+  std::thread([&] {
+    {
+      Logger logger(path, {1 << 16, 4096, std::chrono::microseconds(10)});
+      REQUIRE(TURBOQ_LOG(logger, Info, "short-lived"));
+    }
+    Logger logger(path, {1 << 16, 4096, std::chrono::microseconds(10)});
+    REQUIRE(TURBOQ_LOG(logger, Info, "next"));
+  }).join();
+
+  auto const lines = readLines(path);
+  REQUIRE(lines.size() == kThreads + 3);
+  for (int thread = 0; thread < kThreads; ++thread) {
+    REQUIRE(endsWith(lines[thread], fmt::format("thread {}", thread)));
+  }
+  REQUIRE(endsWith(lines[kThreads + 2], "next"));
+}
+
+} // namespace turboq::testing
@@ -99,7 +99,7 @@ std::vector<MemoryMountPoint> readProcMounts() {
 
   auto handle = ::setmntent("/proc/mounts", "r");
   if (!handle) {
-    throw std::system_error(ENOENT, getPosixErrorCategory(), "setmntent(...)");
+    throwError(std::error_code(ENOENT, getPosixErrorCategory()), "setmntent(...)");
   }
 
   BOOST_SCOPE_EXIT_ALL(&) {
@@ -233,12 +233,12 @@ DefaultMemorySource::DefaultMemorySource(HugePagesOption hugePagesOpt) {
     result = getMountEntry1G(getProcMounts());
   } break;
   default: {
-    throw std::system_error(EINVAL, getPosixErrorCategory(), "invalid hugePagesOpt value");
+    throwError(std::error_code(EINVAL, getPosixErrorCategory()), "invalid hugePagesOpt value");
   } break;
   }
 
   if (!result) {
-    throw std::system_error(result.error());
+    throwError(result.error());
   }
 
   path_ = result.value().path;
@@ -248,10 +248,10 @@ DefaultMemorySource::DefaultMemorySource(HugePagesOption hugePagesOpt) {
 DefaultMemorySource::DefaultMemorySource(std::filesystem::path const& path, std::size_t pageSize)
     : path_(path), pageSize_(pageSize) {
   if (!exists(path)) {
-    throw std::system_error(ENOENT, getPosixErrorCategory(), "directory not exists");
+    throwError(std::error_code(ENOENT, getPosixErrorCategory()), "directory not exists");
   }
   if (!std::has_single_bit(pageSize)) {
-    throw std::system_error(EINVAL, getPosixErrorCategory(), "page size must be power of two");
+    throwError(std::error_code(EINVAL, getPosixErrorCategory()), "page size must be power of two");
   }
 }
 
@@ -260,14 +260,13 @@ Result<std::tuple<File, std::size_t>> DefaultMemorySource::open(std::string_view
     return makePosixErrorCode(EINVAL);
   }
 
-  try {
-    auto const filePath = path_ / name;
-    auto file = (flags == OpenFlags::OpenOnly) ? File(kOpenOnly, filePath, OpenMode::ReadWrite)
-                                               : File(kOpenOrCreate, filePath, OpenMode::ReadWrite);
-    return std::make_tuple(std::move(file), pageSize_);
-  } catch (...) {
-    return makePosixErrorCode(EFAULT);
+  auto const filePath = path_ / name;
+  auto file = (flags == OpenFlags::OpenOnly) ? File::openNoThrow(kOpenOnly, filePath, OpenMode::ReadWrite)
+                                             : File::openNoThrow(kOpenOrCreate, filePath, OpenMode::ReadWrite);
+  if (!file) {
+    return failure(file.error());
   }
+  return std::make_tuple(std::move(file).value(), pageSize_);
 }
 
 Result<std::tuple<File, std::size_t>> AnonymousMemorySource::open(
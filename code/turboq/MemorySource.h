@@ -45,6 +45,16 @@ public:
   /// Throws on error
   DefaultMemorySource(std::filesystem::path const& path, std::size_t pageSize);
 
+  /// Return directory the memory source creates files in
+  [[nodiscard]] std::filesystem::path const& path() const noexcept {
+    return path_;
+  }
+
+  /// Return page size the memory source rounds up to
+  [[nodiscard]] std::size_t pageSize() const noexcept {
+    return pageSize_;
+  }
+
   /// \see MemorySource::open
   Result<std::tuple<File, std::size_t>> open(std::string_view name, OpenFlags flags) const noexcept override;
 };
@@ -0,0 +1,236 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "MetricsRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <boost/scope_exit.hpp>
+
+#include <turboq/detail/memory.h>
+
+namespace turboq {
+namespace detail {
+
+bool MetricsRegistryDetail::check(std::span<std::byte const> buffer) noexcept {
+  if (buffer.size() < kCatalogStartPos) {
+    return false;
+  }
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+    return false;
+  }
+  if (header->capacity == 0 || header->size > buffer.size() || cellsStartPos(header->capacity) > header->size) {
+    return false;
+  }
+  return true;
+}
+
+void MetricsRegistryDetail::init(std::span<std::byte> buffer, std::size_t capacity) noexcept {
+  auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+  std::copy(kTag.begin(), kTag.end(), header->tag);
+  header->capacity = capacity;
+  header->size = buffer.size();
+  header->count = 0;
+  header->cellsEnd = cellsStartPos(capacity);
+}
+
+std::span<MetricsRegistryDetail::Descriptor> MetricsRegistryDetail::catalog(std::span<std::byte> buffer) noexcept {
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  return {std::bit_cast<Descriptor*>(buffer.data() + kCatalogStartPos), header->capacity};
+}
+
+} // namespace detail
+
+std::uint64_t HistogramSnapshot::quantile(double q) const noexcept {
+  if (count == 0) {
+    return 0;
+  }
+  auto const rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * double(count)));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= std::max<std::uint64_t>(rank, 1)) {
+      return LogLinearBuckets::upperBound(i);
+    }
+  }
+  return LogLinearBuckets::upperBound(buckets.size() - 1);
+}
+
+HistogramSnapshot MetricView::histogram() const {
+  auto const cell = std::bit_cast<Detail::HistogramCell*>(cell_);
+
+  HistogramSnapshot snapshot;
+  snapshot.count = std::atomic_ref(cell->count).load(std::memory_order_relaxed);
+  snapshot.sum = std::atomic_ref(cell->sum).load(std::memory_order_relaxed);
+  snapshot.buckets.resize(LogLinearBuckets::kBuckets);
+  for (std::size_t i = 0; i < LogLinearBuckets::kBuckets; ++i) {
+    snapshot.buckets[i] = std::atomic_ref(cell->buckets[i]).load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+Result<MetricsRegistry> MetricsRegistry::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  MetricsRegistry registry;
+  std::size_t pageSize;
+  std::tie(registry.file_, pageSize) = std::move(result).value();
+
+  auto storage = detail::tryMapFile(registry.file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  registry.storage_ = std::move(storage).value();
+  return registry;
+}
+
+Result<MetricsRegistry> MetricsRegistry::create(
+    std::string_view name, CreationOptions const& options, MemorySource const& memorySource) noexcept {
+  if (invalidOption(options)) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  MetricsRegistry registry;
+  std::size_t pageSize;
+  std::tie(registry.file_, pageSize) = std::move(result).value();
+
+  // round-up requested size to page size, keep room for at least one cell
+  std::size_t const capacity = detail::align_up(
+      std::max(options.sizeHint, Detail::cellsStartPos(options.maxMetrics) + sizeof(Detail::ValueCell)), pageSize);
+
+  // init registry or check registry's options is the same as requested,
+  // the lock is released before the registry is returned
+  {
+    if (auto locked = registry.file_.lockNoThrow(); !locked) {
+      return failure(locked.error());
+    }
+    BOOST_SCOPE_EXIT_ALL(&) {
+      std::ignore = registry.file_.unlockNoThrow();
+    };
+    auto const fileSize = registry.file_.tryGetFileSize();
+    if (!fileSize) {
+      return failure(fileSize.error());
+    }
+    if (fileSize.value() != 0) {
+      if (fileSize.value() != capacity) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(registry.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!Detail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+      registry.storage_ = std::move(storage).value();
+    } else {
+      if (auto truncated = registry.file_.tryTruncate(capacity); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(registry.file_, capacity);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      Detail::init(storage.value().content(), options.maxMetrics);
+      registry.storage_ = std::move(storage).value();
+    }
+  }
+  return registry;
+}
+
+Result<std::byte*> MetricsRegistry::tryRegisterMetric(std::string_view name, MetricKind kind) noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  if (name.empty() || name.size() >= Detail::kMaxNameSize) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+
+  // registration is rare, serialize writers with the file lock
+  if (auto locked = file_.lockNoThrow(); !locked) {
+    return failure(locked.error());
+  }
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::ignore = file_.unlockNoThrow();
+  };
+
+  auto const header = std::bit_cast<Detail::MemoryHeader*>(storage_.data());
+  auto const catalog = Detail::catalog(storage_.content());
+  std::size_t const count = std::atomic_ref(header->count).load(std::memory_order_acquire);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    if (name != std::string_view(catalog[i].name)) {
+      continue;
+    }
+    if (catalog[i].kind != kind) {
+      // registered with different kind
+      return makeErrorCode(Error::InvalidArgument);
+    }
+    return storage_.data() + catalog[i].offset;
+  }
+
+  if (count == header->capacity || header->cellsEnd + Detail::cellSize(kind) > header->size) {
+    return makeErrorCode(Error::NoSpace);
+  }
+  std::size_t const offset = header->cellsEnd;
+
+  auto& descriptor = catalog[count];
+  std::fill(std::begin(descriptor.name), std::end(descriptor.name), '\0');
+  std::copy(name.begin(), name.end(), descriptor.name);
+  descriptor.kind = kind;
+  descriptor.offset = offset;
+  header->cellsEnd = offset + Detail::cellSize(kind);
+
+  // publish descriptor for readers
+  std::atomic_ref(header->count).store(count + 1, std::memory_order_release);
+
+  return storage_.data() + offset;
+}
+
+Result<MetricsReader> MetricsReader::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  auto [file, pageSize] = std::move(result).value();
+
+  auto storage = detail::tryMapFileReadOnly(file);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+
+  MetricsReader reader;
+  reader.storage_ = std::move(storage).value();
+  reader.header_ = std::bit_cast<Detail::MemoryHeader*>(reader.storage_.data());
+  reader.catalog_ = Detail::catalog(reader.storage_.content());
+  return reader;
+}
+
+std::optional<MetricView> MetricsReader::find(std::string_view name) {
+  std::size_t const count = size();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (name == std::string_view(catalog_[i].name)) {
+      return view(i);
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace turboq
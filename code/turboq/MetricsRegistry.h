@@ -0,0 +1,459 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <turboq/File.h>
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/math.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Metric type
+enum class MetricKind : std::uint32_t { Counter = 1, Gauge = 2, Histogram = 3 };
+
+/// Log-linear buckets: values below 2^kSubBucketBits are exact, each next power
+/// of two range is split into 2^kSubBucketBits linear buckets (relative error
+/// is below 1/2^kSubBucketBits).
+struct LogLinearBuckets {
+  static constexpr std::size_t kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = std::size_t(1) << kSubBucketBits;
+  /// Total buckets count to cover std::uint64_t range
+  static constexpr std::size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  /// Return bucket index for value
+  [[nodiscard]] static constexpr std::size_t index(std::uint64_t value) noexcept {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    std::size_t const exponent = std::bit_width(value) - 1;
+    std::size_t const shift = exponent - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + ((value >> shift) & (kSubBuckets - 1));
+  }
+
+  /// Return the smallest value of bucket
+  [[nodiscard]] static constexpr std::uint64_t lowerBound(std::size_t index) noexcept {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    std::size_t const shift = index / kSubBuckets - 1;
+    return (kSubBuckets + index % kSubBuckets) << shift;
+  }
+
+  /// Return the largest value of bucket
+  [[nodiscard]] static constexpr std::uint64_t upperBound(std::size_t index) noexcept {
+    if (index + 1 == kBuckets) {
+      return ~std::uint64_t(0);
+    }
+    return lowerBound(index + 1) - 1;
+  }
+};
+
+namespace detail {
+
+/// Metrics registry detail
+struct MetricsRegistryDetail {
+  /// Registry tag
+  static constexpr std::string_view kTag = "turboq/Metrics";
+  /// Max metric name size including terminating zero
+  static constexpr std::size_t kMaxNameSize = 48;
+  /// Cell alignment (metric cells never share cache lines)
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+
+  /// Control struct for registry buffer
+  struct MemoryHeader {
+    /// Placeholder for tag
+    char tag[kTag.size()];
+    /// Max metrics count
+    std::size_t capacity;
+    /// Registry size (bytes)
+    std::size_t size;
+    /// Published metrics count
+    std::size_t count;
+    /// End of the allocated cells
+    std::size_t cellsEnd;
+
+    static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Catalog entry
+  struct Descriptor {
+    /// Zero terminated metric name
+    char name[kMaxNameSize];
+    /// Metric kind
+    MetricKind kind;
+    /// Padding
+    std::uint32_t reserved;
+    /// Cell offset from buffer start
+    std::size_t offset;
+  };
+  static_assert(std::is_trivially_copyable_v<Descriptor>);
+
+  /// Counter and gauge cell
+  struct alignas(kAlign) ValueCell {
+    std::uint64_t value;
+  };
+
+  /// Histogram cell
+  struct alignas(kAlign) HistogramCell {
+    std::uint64_t count;
+    std::uint64_t sum;
+    alignas(kAlign) std::uint64_t buckets[LogLinearBuckets::kBuckets];
+  };
+
+  /// Offset for the first descriptor from memory buffer start
+  static constexpr std::size_t kCatalogStartPos = align_up(sizeof(MemoryHeader), kAlign);
+
+  /// Return offset of the first cell
+  static constexpr std::size_t cellsStartPos(std::size_t capacity) noexcept {
+    return align_up(kCatalogStartPos + capacity * sizeof(Descriptor), kAlign);
+  }
+
+  /// Return cell size for metric kind
+  static constexpr std::size_t cellSize(MetricKind kind) noexcept {
+    return (kind == MetricKind::Histogram) ? sizeof(HistogramCell) : sizeof(ValueCell);
+  }
+
+  /// Check buffer points to valid registry region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept;
+
+  /// Init registry memory header
+  static void init(std::span<std::byte> buffer, std::size_t capacity) noexcept;
+
+  /// Return catalog
+  [[nodiscard]] static std::span<Descriptor> catalog(std::span<std::byte> buffer) noexcept;
+};
+
+} // namespace detail
+
+/// Monotonic counter. Single writer, relaxed updates.
+class Counter {
+private:
+  std::uint64_t* value_ = nullptr;
+
+public:
+  Counter() = default;
+
+  explicit Counter(std::uint64_t* value) noexcept : value_(value) {}
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return value_ != nullptr;
+  }
+
+  /// Increment counter
+  TURBOQ_FORCE_INLINE void inc(std::uint64_t delta = 1) noexcept {
+    auto ref = std::atomic_ref(*value_);
+    ref.store(ref.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+  /// Return current value
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::uint64_t value() const noexcept {
+    return std::atomic_ref(*value_).load(std::memory_order_relaxed);
+  }
+};
+
+/// Gauge. Single writer, relaxed updates.
+class Gauge {
+private:
+  std::uint64_t* value_ = nullptr;
+
+public:
+  Gauge() = default;
+
+  explicit Gauge(std::uint64_t* value) noexcept : value_(value) {}
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return value_ != nullptr;
+  }
+
+  /// Set gauge value
+  TURBOQ_FORCE_INLINE void set(std::int64_t value) noexcept {
+    std::atomic_ref(*value_).store(std::uint64_t(value), std::memory_order_relaxed);
+  }
+
+  /// Add delta to gauge value
+  TURBOQ_FORCE_INLINE void add(std::int64_t delta) noexcept {
+    set(value() + delta);
+  }
+
+  /// Return current value
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::int64_t value() const noexcept {
+    return std::int64_t(std::atomic_ref(*value_).load(std::memory_order_relaxed));
+  }
+};
+
+/// Log-linear histogram. Single writer, relaxed updates.
+class Histogram {
+private:
+  using Cell = detail::MetricsRegistryDetail::HistogramCell;
+
+  Cell* cell_ = nullptr;
+
+public:
+  Histogram() = default;
+
+  explicit Histogram(Cell* cell) noexcept : cell_(cell) {}
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return cell_ != nullptr;
+  }
+
+  /// Record value
+  TURBOQ_FORCE_INLINE void record(std::uint64_t value) noexcept {
+    auto bucket = std::atomic_ref(cell_->buckets[LogLinearBuckets::index(value)]);
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    auto sum = std::atomic_ref(cell_->sum);
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    auto count = std::atomic_ref(cell_->count);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+};
+
+/// Copy of histogram state
+struct HistogramSnapshot {
+  std::uint64_t count = 0;
+  std::uint64_t sum = 0;
+  std::vector<std::uint64_t> buckets;
+
+  /// Return upper bound of the bucket containing quantile q (0..1)
+  [[nodiscard]] std::uint64_t quantile(double q) const noexcept;
+};
+
+/// Read-only view of a metric
+class MetricView {
+private:
+  using Detail = detail::MetricsRegistryDetail;
+
+  Detail::Descriptor const* descriptor_ = nullptr;
+  std::byte* cell_ = nullptr;
+
+public:
+  MetricView(Detail::Descriptor const* descriptor, std::byte* cell) noexcept
+      : descriptor_(descriptor), cell_(cell) {}
+
+  /// Return metric name
+  [[nodiscard]] std::string_view name() const noexcept {
+    return descriptor_->name;
+  }
+
+  /// Return metric kind
+  [[nodiscard]] MetricKind kind() const noexcept {
+    return descriptor_->kind;
+  }
+
+  /// Return counter value
+  /// pre: kind() == MetricKind::Counter
+  [[nodiscard]] std::uint64_t counter() const noexcept {
+    return std::atomic_ref(std::bit_cast<Detail::ValueCell*>(cell_)->value).load(std::memory_order_relaxed);
+  }
+
+  /// Return gauge value
+  /// pre: kind() == MetricKind::Gauge
+  [[nodiscard]] std::int64_t gauge() const noexcept {
+    return std::int64_t(counter());
+  }
+
+  /// Return histogram copy
+  /// pre: kind() == MetricKind::Histogram
+  [[nodiscard]] HistogramSnapshot histogram() const;
+};
+
+/// Shared memory registry of named metrics.
+/// Writers register metrics by name (cold path, under file lock) and update
+/// their cells with plain relaxed stores. Exporter processes read the catalog
+/// and cells through MetricsReader without any coordination with writers.
+///
+/// Layout:
+/// +---------------+---+--------------------------+---+--------+-------------+-----
+/// | MemoryHeader  |xxx| Descriptor[capacity]     |xxx| Cell 0 | Cell 1      | ...
+/// +---------------+---+--------------------------+---+--------+-------------+-----
+class MetricsRegistry {
+private:
+  using Detail = detail::MetricsRegistryDetail;
+
+  File file_;
+  MappedRegion storage_;
+
+public:
+  struct CreationOptions {
+    /// Max metrics count
+    std::size_t maxMetrics;
+    /// Registry size (bytes)
+    std::size_t sizeHint;
+  };
+
+  MetricsRegistry(MetricsRegistry const&) = delete;
+  MetricsRegistry& operator=(MetricsRegistry const&) = delete;
+  MetricsRegistry() = default;
+
+  MetricsRegistry(MetricsRegistry&& that) noexcept {
+    swap(that);
+  }
+
+  MetricsRegistry& operator=(MetricsRegistry&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only registry. Throws on error.
+  explicit MetricsRegistry(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : MetricsRegistry(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create registry. Throws on error.
+  MetricsRegistry(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : MetricsRegistry(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only registry.
+  [[nodiscard]] static Result<MetricsRegistry> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Open or create registry.
+  [[nodiscard]] static Result<MetricsRegistry> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on registry intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Register counter or attach to existing one. Throws on error.
+  /// Handle is valid while registry object is alive.
+  [[nodiscard]] Counter counter(std::string_view name) {
+    return valueOrThrow(tryCounter(name), kInvalidMetric);
+  }
+
+  /// Register counter or attach to existing one.
+  /// \see counter
+  [[nodiscard]] Result<Counter> tryCounter(std::string_view name) noexcept {
+    auto const cell = tryRegisterMetric(name, MetricKind::Counter);
+    if (!cell) {
+      return failure(cell.error());
+    }
+    return Counter(&std::bit_cast<Detail::ValueCell*>(cell.value())->value);
+  }
+
+  /// Register gauge or attach to existing one. Throws on error.
+  /// Handle is valid while registry object is alive.
+  [[nodiscard]] Gauge gauge(std::string_view name) {
+    return valueOrThrow(tryGauge(name), kInvalidMetric);
+  }
+
+  /// Register gauge or attach to existing one.
+  /// \see gauge
+  [[nodiscard]] Result<Gauge> tryGauge(std::string_view name) noexcept {
+    auto const cell = tryRegisterMetric(name, MetricKind::Gauge);
+    if (!cell) {
+      return failure(cell.error());
+    }
+    return Gauge(&std::bit_cast<Detail::ValueCell*>(cell.value())->value);
+  }
+
+  /// Register histogram or attach to existing one. Throws on error.
+  /// Handle is valid while registry object is alive.
+  [[nodiscard]] Histogram histogram(std::string_view name) {
+    return valueOrThrow(tryHistogram(name), kInvalidMetric);
+  }
+
+  /// Register histogram or attach to existing one.
+  /// \see histogram
+  [[nodiscard]] Result<Histogram> tryHistogram(std::string_view name) noexcept {
+    auto const cell = tryRegisterMetric(name, MetricKind::Histogram);
+    if (!cell) {
+      return failure(cell.error());
+    }
+    return Histogram(std::bit_cast<Detail::HistogramCell*>(cell.value()));
+  }
+
+  /// Swap resources with other registry.
+  void swap(MetricsRegistry& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+    swap(storage_, that.storage_);
+  }
+
+  /// \see MetricsRegistry::swap
+  friend void swap(MetricsRegistry& a, MetricsRegistry& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Description of Error::InvalidArgument for metric registration
+  static constexpr char const* kInvalidMetric = "metric name or kind";
+
+  /// Return cell of the metric, register metric on missing
+  Result<std::byte*> tryRegisterMetric(std::string_view name, MetricKind kind) noexcept;
+
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    return options.maxMetrics == 0 ? "maxMetrics" : nullptr;
+  }
+};
+
+/// Read-only access to metrics registry for exporter processes
+class MetricsReader {
+private:
+  using Detail = detail::MetricsRegistryDetail;
+
+  MappedRegion storage_;
+  Detail::MemoryHeader* header_ = nullptr;
+  std::span<Detail::Descriptor> catalog_;
+
+public:
+  MetricsReader() = default;
+
+  /// Open registry for reading. Throws on error.
+  explicit MetricsReader(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : MetricsReader(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open registry for reading.
+  [[nodiscard]] static Result<MetricsReader> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return registered metrics count
+  [[nodiscard]] std::size_t size() const noexcept {
+    return std::atomic_ref(header_->count).load(std::memory_order_acquire);
+  }
+
+  /// Invoke fn(MetricView) for each registered metric
+  template <typename Fn>
+  void forEach(Fn&& fn) {
+    std::size_t const count = size();
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(view(i));
+    }
+  }
+
+  /// Find metric by name
+  [[nodiscard]] std::optional<MetricView> find(std::string_view name);
+
+private:
+  [[nodiscard]] MetricView view(std::size_t index) noexcept {
+    return MetricView(&catalog_[index], storage_.data() + catalog_[index].offset);
+  }
+};
+
+} // namespace turboq
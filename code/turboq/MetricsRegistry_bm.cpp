@@ -0,0 +1,108 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "MetricsRegistry.h"
+
+namespace turboq {
+namespace {
+
+struct Registry {
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource{path, 4096};
+  MetricsRegistry registry{"turboq-metrics-bm", {64, 1 << 20}, memorySource};
+
+  ~Registry() {
+    std::filesystem::remove(path / "turboq-metrics-bm");
+  }
+};
+
+} // namespace
+
+static void BM_Metrics_CounterInc(::benchmark::State& state) {
+  Registry registry;
+  auto counter = registry.registry.counter("counter");
+
+  for (auto _ : state) {
+    counter.inc();
+  }
+  ::benchmark::DoNotOptimize(counter.value());
+}
+
+static void BM_Metrics_GaugeSet(::benchmark::State& state) {
+  Registry registry;
+  auto gauge = registry.registry.gauge("gauge");
+
+  std::int64_t value = 0;
+  for (auto _ : state) {
+    gauge.set(value++);
+  }
+  ::benchmark::DoNotOptimize(gauge.value());
+}
+
+static void BM_Metrics_HistogramRecord(::benchmark::State& state) {
+  Registry registry;
+  auto histogram = registry.registry.histogram("histogram");
+
+  std::uint64_t value = 1;
+  for (auto _ : state) {
+    histogram.record(value);
+    value = value * 6364136223846793005ull + 1442695040888963407ull;
+  }
+}
+
+/// Reading all metrics from exporter process
+static void BM_Metrics_ReaderScan(::benchmark::State& state) {
+  Registry registry;
+  for (int i = 0; i < 32; ++i) {
+    registry.registry.counter("counter" + std::to_string(i)).inc();
+  }
+
+  MetricsReader reader("turboq-metrics-bm", registry.memorySource);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    reader.forEach([&](MetricView const& metric) {
+      sum += metric.counter();
+    });
+    ::benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 32);
+}
+
+/// Baseline: stats update sent as datagram over unix socket
+static void BM_Metrics_SocketBaseline(::benchmark::State& state) {
+  int fds[2];
+  if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+
+  struct Update {
+    std::uint64_t id;
+    std::uint64_t delta;
+  } update{1, 1};
+
+  for (auto _ : state) {
+    ::send(fds[0], &update, sizeof(update), 0);
+    ::recv(fds[1], &update, sizeof(update), 0);
+  }
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+} // namespace turboq
+
+BENCHMARK(turboq::BM_Metrics_CounterInc);
+BENCHMARK(turboq::BM_Metrics_GaugeSet);
+BENCHMARK(turboq::BM_Metrics_HistogramRecord);
+BENCHMARK(turboq::BM_Metrics_ReaderScan);
+BENCHMARK(turboq::BM_Metrics_SocketBaseline);
@@ -0,0 +1,92 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <filesystem>
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include "MetricsRegistry.h"
+
+namespace turboq::testing {
+
+TEST_CASE("MetricsRegistry: log-linear buckets") {
+  for (std::size_t i = 0; i < LogLinearBuckets::kBuckets; ++i) {
+    REQUIRE(LogLinearBuckets::index(LogLinearBuckets::lowerBound(i)) == i);
+    REQUIRE(LogLinearBuckets::index(LogLinearBuckets::upperBound(i)) == i);
+  }
+  REQUIRE(LogLinearBuckets::index(0) == 0);
+  REQUIRE(LogLinearBuckets::index(~std::uint64_t(0)) == LogLinearBuckets::kBuckets - 1);
+
+  // relative error is bounded by sub-buckets count
+  for (std::uint64_t value : {100ull, 12345ull, 1000000007ull}) {
+    auto const index = LogLinearBuckets::index(value);
+    auto const width = LogLinearBuckets::upperBound(index) - LogLinearBuckets::lowerBound(index) + 1;
+    REQUIRE(width * LogLinearBuckets::kSubBuckets <= value);
+  }
+}
+
+TEST_CASE("MetricsRegistry: basic") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  std::filesystem::remove(path / "turboq-metrics");
+
+  MetricsRegistry registry("turboq-metrics", MetricsRegistry::CreationOptions(16, 64 * 1024), memorySource);
+
+  auto requests = registry.counter("requests");
+  auto inflight = registry.gauge("inflight");
+  auto latency = registry.histogram("latency_ns");
+  REQUIRE(requests);
+  REQUIRE(inflight);
+  REQUIRE(latency);
+
+  requests.inc();
+  requests.inc(41);
+  inflight.set(10);
+  inflight.add(-13);
+  for (std::uint64_t i = 1; i <= 100; ++i) {
+    latency.record(i * 1000);
+  }
+
+  // same name attaches to the same cell
+  REQUIRE(registry.counter("requests").value() == 42);
+  REQUIRE_THROWS(registry.gauge("requests"));
+  REQUIRE_THROWS(registry.counter(std::string(64, 'x')));
+
+  MetricsReader reader("turboq-metrics", memorySource);
+  REQUIRE(reader.size() == 3);
+
+  std::size_t visited = 0;
+  reader.forEach([&](MetricView const& metric) {
+    visited++;
+    if (metric.name() == "requests") {
+      REQUIRE(metric.kind() == MetricKind::Counter);
+      REQUIRE(metric.counter() == 42);
+    } else if (metric.name() == "inflight") {
+      REQUIRE(metric.kind() == MetricKind::Gauge);
+      REQUIRE(metric.gauge() == -3);
+    }
+  });
+  REQUIRE(visited == 3);
+
+  auto metric = reader.find("latency_ns");
+  REQUIRE(metric);
+  REQUIRE(metric->kind() == MetricKind::Histogram);
+  auto const histogram = metric->histogram();
+  REQUIRE(histogram.count == 100);
+  REQUIRE(histogram.sum == 5050 * 1000);
+  // log-linear buckets keep quantiles within 1/8 relative error
+  REQUIRE(histogram.quantile(0.5) >= 50000);
+  REQUIRE(histogram.quantile(0.5) <= 50000 + 50000 / 8);
+  REQUIRE(histogram.quantile(1.0) >= 100000);
+
+  REQUIRE(!reader.find("missing"));
+
+  // metrics survive writer restart
+  registry = MetricsRegistry("turboq-metrics", memorySource);
+  REQUIRE(registry.counter("requests").value() == 42);
+
+  std::filesystem::remove(path / "turboq-metrics");
+}
+
+} // namespace turboq::testing
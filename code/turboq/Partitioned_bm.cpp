@@ -0,0 +1,94 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedPartitionedRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "utils.h"
+
+namespace turboq {
+namespace {
+
+struct Message {
+  std::uint64_t key;
+  std::uint64_t payload[3];
+};
+
+} // namespace
+
+/// Producers hash key straight into partition ring
+static void BM_Partitioned_Direct(::benchmark::State& state) {
+  std::size_t const partitions = state.range(0);
+
+  BoundedPartitionedRawQueue queue(
+      "bm", BoundedPartitionedRawQueue::CreationOptions(partitions, sizeof(Message), 1024), AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  std::vector<BoundedPartitionedRawQueue::Consumer> consumers;
+  for (std::size_t partition = 0; partition < partitions; ++partition) {
+    consumers.push_back(queue.createConsumer(partition));
+  }
+
+  Message message = {};
+  for (auto _ : state) {
+    message.key++;
+    auto buffer = producer.prepare(message.key, sizeof(message));
+    std::memcpy(buffer.data(), &message, sizeof(message));
+    producer.commit();
+
+    auto& consumer = consumers[producer.partitionOf(message.key)];
+    auto received = consumer.fetch();
+    ::benchmark::DoNotOptimize(received.data());
+    consumer.consume();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// MPSC queue drained by router which copies messages into per-consumer SPSC queues
+static void BM_Partitioned_Router(::benchmark::State& state) {
+  std::size_t const partitions = state.range(0);
+
+  BoundedMPSCRawQueue input("bm", BoundedMPSCRawQueue::CreationOptions(sizeof(Message), 1024), AnonymousMemorySource());
+  auto producer = input.createProducer();
+  auto router = input.createConsumer();
+
+  std::vector<BoundedSPSCRawQueue> outputs;
+  std::vector<BoundedSPSCRawQueue::Producer> routerProducers;
+  std::vector<BoundedSPSCRawQueue::Consumer> consumers;
+  for (std::size_t partition = 0; partition < partitions; ++partition) {
+    auto& output = outputs.emplace_back("bm", BoundedSPSCRawQueue::CreationOptions(64 * 1024), AnonymousMemorySource());
+    routerProducers.push_back(output.createProducer());
+    consumers.push_back(output.createConsumer());
+  }
+
+  Message message = {};
+  for (auto _ : state) {
+    message.key++;
+    enqueue(producer, message);
+
+    auto routed = router.fetch();
+    Message const* const in = std::bit_cast<Message const*>(routed.data());
+    std::size_t const partition = in->key % partitions;
+    auto buffer = routerProducers[partition].prepare(routed.size());
+    std::memcpy(buffer.data(), routed.data(), routed.size());
+    routerProducers[partition].commit();
+    router.consume();
+
+    auto received = consumers[partition].fetch();
+    ::benchmark::DoNotOptimize(received.data());
+    consumers[partition].consume();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Partitioned_Direct)->Arg(4)->Arg(16);
+BENCHMARK(BM_Partitioned_Router)->Arg(4)->Arg(16);
+
+} // namespace turboq
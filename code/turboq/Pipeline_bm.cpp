@@ -0,0 +1,93 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedPipelineRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+
+namespace turboq {
+namespace {
+
+constexpr std::size_t kStages = 3;
+
+/// Stage work: read every word of the message
+TURBOQ_FORCE_INLINE std::uint64_t digest(std::span<std::byte const> buffer) noexcept {
+  auto const words = std::bit_cast<std::uint64_t const*>(buffer.data());
+  std::uint64_t result = 0;
+  for (std::size_t i = 0; i < buffer.size() / sizeof(std::uint64_t); ++i) {
+    result = result * 31 + words[i];
+  }
+  return result;
+}
+
+} // namespace
+
+/// Message written once, every stage processes it in place
+static void BM_Pipeline_InPlace(::benchmark::State& state) {
+  std::size_t const size = state.range(0);
+
+  BoundedPipelineRawQueue queue("bm", {kStages, size, 1024}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  std::vector<BoundedPipelineRawQueue::Stage> stages;
+  for (std::size_t index = 0; index < kStages; ++index) {
+    stages.push_back(queue.createStage(index));
+  }
+
+  for (auto _ : state) {
+    auto buffer = producer.prepare(size);
+    std::memset(buffer.data(), 1, size);
+    producer.commit();
+
+    for (auto& stage : stages) {
+      ::benchmark::DoNotOptimize(digest(stage.fetch()));
+      stage.consume();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+/// Every stage copies message into the next SPSC queue
+static void BM_Pipeline_QueueChain(::benchmark::State& state) {
+  std::size_t const size = state.range(0);
+
+  std::vector<BoundedSPSCRawQueue> queues;
+  std::vector<BoundedSPSCRawQueue::Producer> producers;
+  std::vector<BoundedSPSCRawQueue::Consumer> consumers;
+  for (std::size_t index = 0; index < kStages; ++index) {
+    auto& queue = queues.emplace_back("bm", BoundedSPSCRawQueue::CreationOptions(1024 * size), AnonymousMemorySource());
+    producers.push_back(queue.createProducer());
+    consumers.push_back(queue.createConsumer());
+  }
+
+  for (auto _ : state) {
+    auto buffer = producers[0].prepare(size);
+    std::memset(buffer.data(), 1, size);
+    producers[0].commit();
+
+    for (std::size_t index = 0; index < kStages; ++index) {
+      auto const received = consumers[index].fetch();
+      ::benchmark::DoNotOptimize(digest(received));
+      if (index + 1 < kStages) {
+        auto next = producers[index + 1].prepare(received.size());
+        std::memcpy(next.data(), received.data(), received.size());
+        producers[index + 1].commit();
+      }
+      consumers[index].consume();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_Pipeline_InPlace)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_Pipeline_QueueChain)->Arg(64)->Arg(512)->Arg(4096);
+
+} // namespace turboq
@@ -0,0 +1,183 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "utils.h"
+
+namespace turboq {
+namespace {
+
+struct SPSCWaitTraits : BoundedSPSCRawQueueDefaultTraits {
+  static constexpr bool kProducerWait = true;
+};
+
+struct MPSCWaitTraits : BoundedMPSCRawQueueDefaultTraits {
+  static constexpr bool kProducerWait = true;
+};
+
+using SPSCWaitQueue = BoundedSPSCRawQueueImpl<SPSCWaitTraits>;
+using MPSCWaitQueue = BoundedMPSCRawQueueImpl<MPSCWaitTraits>;
+
+template <typename Queue>
+Queue createQueue() {
+  if constexpr (std::is_same_v<Queue, MPSCWaitQueue>) {
+    return Queue("bm", typename Queue::CreationOptions(sizeof(std::uint64_t), 64), AnonymousMemorySource());
+  } else {
+    return Queue("bm", typename Queue::CreationOptions(4096), AnonymousMemorySource());
+  }
+}
+
+using Clock = std::chrono::steady_clock;
+
+/// Emulate consumer's work per message
+void busyWait(std::chrono::nanoseconds duration) {
+  auto const deadline = Clock::now() + duration;
+  while (Clock::now() < deadline) {}
+}
+
+} // namespace
+
+/// Time between consumer freeing a slot and sleeping producer resuming
+template <typename Queue>
+static void BM_ProducerWait_WakeLatency(::benchmark::State& state) {
+  auto queue = createQueue<Queue>();
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  while (!producer.prepare(sizeof(std::uint64_t)).empty()) {
+    producer.commit();
+  }
+
+  std::atomic<bool> stop = false;
+  std::atomic<std::uint64_t> wakeups = 0;
+  std::atomic<Clock::rep> wakeTime = 0;
+
+  std::thread thread([&] {
+    while (!stop.load(std::memory_order_relaxed)) {
+      auto buffer = producer.prepareWait(sizeof(std::uint64_t), std::chrono::milliseconds(10));
+      if (buffer.empty()) {
+        continue;
+      }
+      wakeTime.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+      producer.commit();
+      wakeups.fetch_add(1, std::memory_order_release);
+    }
+  });
+
+  for (auto _ : state) {
+    // let producer fall asleep on full queue
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+    // consume until producer wakes up, SPSC producer may need more than one message worth of space
+    auto const expected = wakeups.load(std::memory_order_relaxed) + 1;
+    auto start = Clock::now();
+    while (wakeups.load(std::memory_order_acquire) < expected) {
+      if (!consumer.fetch().empty()) {
+        start = Clock::now();
+        consumer.consume();
+      }
+    }
+    auto const end = Clock::time_point(Clock::duration(wakeTime.load(std::memory_order_relaxed)));
+
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+
+  stop = true;
+  thread.join();
+}
+
+/// CPU burnt by the process while spinning producer feeds slow consumer
+template <typename Queue>
+static void BM_ProducerWait_SlowConsumer_Spin(::benchmark::State& state) {
+  auto queue = createQueue<Queue>();
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  constexpr std::uint64_t kCount = 10000;
+  std::chrono::nanoseconds const work(state.range(0));
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      for (std::uint64_t i = 0; i < kCount; ++i) {
+        while (!enqueue(producer, i)) {}
+      }
+    });
+
+    std::uint64_t value;
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      while (!dequeue(consumer, value)) {}
+      busyWait(work);
+    }
+
+    thread.join();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+/// CPU burnt by the process while sleeping producer feeds slow consumer
+template <typename Queue>
+static void BM_ProducerWait_SlowConsumer_Wait(::benchmark::State& state) {
+  auto queue = createQueue<Queue>();
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  constexpr std::uint64_t kCount = 10000;
+  std::chrono::nanoseconds const work(state.range(0));
+  // larger threshold batches wakeups
+  std::size_t const wakeThreshold = state.range(1);
+
+  for (auto _ : state) {
+    std::thread thread([&] {
+      for (std::uint64_t i = 0; i < kCount; ++i) {
+        auto buffer = producer.prepareWait(sizeof(i), std::chrono::nanoseconds::max(), wakeThreshold);
+        std::memcpy(buffer.data(), &i, sizeof(i));
+        producer.commit();
+      }
+    });
+
+    std::uint64_t value;
+    for (std::uint64_t i = 0; i < kCount; ++i) {
+      while (!dequeue(consumer, value)) {}
+      busyWait(work);
+    }
+
+    thread.join();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+} // namespace turboq
+
+BENCHMARK(turboq::BM_ProducerWait_WakeLatency<turboq::SPSCWaitQueue>)->UseManualTime();
+BENCHMARK(turboq::BM_ProducerWait_WakeLatency<turboq::MPSCWaitQueue>)->UseManualTime();
+
+BENCHMARK(turboq::BM_ProducerWait_SlowConsumer_Spin<turboq::SPSCWaitQueue>)
+    ->Arg(1000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(turboq::BM_ProducerWait_SlowConsumer_Wait<turboq::SPSCWaitQueue>)
+    ->Args({1000, 0})
+    ->Args({1000, 1024})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(turboq::BM_ProducerWait_SlowConsumer_Spin<turboq::MPSCWaitQueue>)
+    ->Arg(1000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+BENCHMARK(turboq::BM_ProducerWait_SlowConsumer_Wait<turboq::MPSCWaitQueue>)
+    ->Args({1000, 0})
+    ->Args({1000, 16})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
@@ -0,0 +1,174 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "ReadinessBitmap.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <turboq/detail/memory.h>
+
+namespace turboq {
+namespace detail {
+
+bool ReadinessBitmapDetail::check(std::span<std::byte const> buffer) noexcept {
+  if (buffer.size() < kDataStartPos) {
+    return false;
+  }
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+    return false;
+  }
+  if (header->size == 0 || header->size % kBlockBits != 0 || bufferSize(header->size) > buffer.size()) {
+    return false;
+  }
+  return true;
+}
+
+void ReadinessBitmapDetail::init(std::span<std::byte> buffer, std::size_t size) noexcept {
+  auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+  std::copy(kTag.begin(), kTag.end(), header->tag);
+  header->size = size;
+}
+
+std::span<std::uint64_t> ReadinessBitmapDetail::words(std::span<std::byte> buffer) noexcept {
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  return {std::bit_cast<std::uint64_t*>(buffer.data() + kDataStartPos), header->size / 64};
+}
+
+ReadinessBitmapNotifier::ReadinessBitmapNotifier(MappedRegion&& storage, std::size_t index)
+    : storage_(std::move(storage)) {
+  auto content = storage_.content();
+
+  if (!ReadinessBitmapDetail::check(content)) {
+    throwError(Error::InvalidQueue);
+  }
+
+  auto const words = ReadinessBitmapDetail::words(content);
+  if (index >= words.size() * 64) {
+    throwError(Error::InvalidArgument, "index");
+  }
+
+  word_ = &words[index / 64];
+  mask_ = std::uint64_t(1) << (index % 64);
+}
+
+ReadinessBitmapPoller::ReadinessBitmapPoller(MappedRegion&& storage) : storage_(std::move(storage)) {
+  auto content = storage_.content();
+
+  if (!Detail::check(content)) {
+    throwError(Error::InvalidQueue);
+  }
+
+  words_ = Detail::words(content);
+}
+
+} // namespace detail
+
+Result<ReadinessBitmap> ReadinessBitmap::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  ReadinessBitmap bitmap;
+  std::size_t pageSize;
+  std::tie(bitmap.file_, pageSize) = std::move(result).value();
+
+  auto storage = detail::tryMapFile(bitmap.file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  return bitmap;
+}
+
+Result<ReadinessBitmap> ReadinessBitmap::create(
+    std::string_view name, CreationOptions const& options, MemorySource const& memorySource) noexcept {
+  if (invalidOption(options)) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  ReadinessBitmap bitmap;
+  std::size_t pageSize;
+  std::tie(bitmap.file_, pageSize) = std::move(result).value();
+
+  std::size_t const size = detail::align_up(options.sizeHint, Detail::kBlockBits);
+  // round-up requested size to page size
+  std::size_t const capacity = detail::align_up(Detail::bufferSize(size), pageSize);
+
+  // init bitmap or check bitmap's options is the same as requested
+  auto const fileSize = bitmap.file_.tryGetFileSize();
+  if (!fileSize) {
+    return failure(fileSize.error());
+  }
+  if (fileSize.value() != 0) {
+    if (fileSize.value() != capacity) {
+      return makeErrorCode(Error::SizeMismatch);
+    }
+    auto storage = detail::tryMapFile(bitmap.file_);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    if (!Detail::check(storage.value().content())) {
+      return makeErrorCode(Error::InvalidQueue);
+    }
+  } else {
+    if (auto truncated = bitmap.file_.tryTruncate(capacity); !truncated) {
+      return failure(truncated.error());
+    }
+    auto storage = detail::tryMapFile(bitmap.file_, capacity);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    Detail::init(storage.value().content(), size);
+  }
+  return bitmap;
+}
+
+Result<ReadinessBitmap::Notifier> ReadinessBitmap::tryCreateNotifier(std::size_t index) noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  auto storage = detail::tryMapFile(file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  auto const content = storage.value().content();
+  if (!Detail::check(content)) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  if (index >= std::bit_cast<Detail::MemoryHeader const*>(content.data())->size) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  return Notifier(std::move(storage).value(), index);
+}
+
+Result<ReadinessBitmap::Poller> ReadinessBitmap::tryCreatePoller() noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  auto const locked = file_.tryLockNoThrow();
+  if (!locked) {
+    return failure(locked.error());
+  }
+  if (!locked.value()) {
+    return makeErrorCode(Error::ConsumerExists);
+  }
+  auto storage = detail::tryMapFile(file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  return Poller(std::move(storage).value());
+}
+
+} // namespace turboq
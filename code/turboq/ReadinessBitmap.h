@@ -0,0 +1,319 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <turboq/File.h>
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/math.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+namespace detail {
+
+/// Readiness bitmap detail
+struct ReadinessBitmapDetail {
+  /// Bitmap tag
+  static constexpr std::string_view kTag = "turboq/ReadinessBitmap";
+  /// Bits scanned at once by poller (one 64 bytes line)
+  static constexpr std::size_t kBlockBits = 512;
+  /// Words in block
+  static constexpr std::size_t kBlockWords = kBlockBits / 64;
+
+  /// Control struct for bitmap buffer
+  struct MemoryHeader {
+    /// Placeholder for tag
+    char tag[kTag.size()];
+    /// Bitmap size (bits)
+    std::size_t size;
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Offset for the first bitmap word from memory buffer start
+  static constexpr std::size_t kDataStartPos = align_up(sizeof(MemoryHeader), kHardwareDestructiveInterferenceSize);
+
+  /// Return buffer size required for bitmap of size bits
+  static constexpr std::size_t bufferSize(std::size_t size) noexcept {
+    return kDataStartPos + size / 8;
+  }
+
+  /// Check buffer points to valid bitmap region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept;
+
+  /// Init bitmap memory header
+  static void init(std::span<std::byte> buffer, std::size_t size) noexcept;
+
+  /// Return bitmap words
+  [[nodiscard]] static std::span<std::uint64_t> words(std::span<std::byte> buffer) noexcept;
+
+  /// Return true in case of any bit in block is set
+  [[nodiscard]] static TURBOQ_FORCE_INLINE bool anyBitSet(std::uint64_t* block) noexcept {
+#if defined(__AVX512F__)
+    __m512i const value = _mm512_load_si512(block);
+    return _mm512_test_epi64_mask(value, value) != 0;
+#elif defined(__AVX2__)
+    __m256i const value = _mm256_or_si256(_mm256_load_si256(std::bit_cast<__m256i const*>(block)),
+        _mm256_load_si256(std::bit_cast<__m256i const*>(block + 4)));
+    return _mm256_testz_si256(value, value) == 0;
+#else
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < kBlockWords; ++i) {
+      value |= std::atomic_ref(block[i]).load(std::memory_order_relaxed);
+    }
+    return value != 0;
+#endif
+  }
+};
+
+/// Implements readiness bitmap notifier (producer side)
+class ReadinessBitmapNotifier {
+private:
+  MappedRegion storage_;
+  std::uint64_t* word_ = nullptr;
+  std::uint64_t mask_ = 0;
+
+public:
+  ReadinessBitmapNotifier() = default;
+  ~ReadinessBitmapNotifier() = default;
+
+  ReadinessBitmapNotifier(ReadinessBitmapNotifier&& that) noexcept {
+    swap(that);
+  }
+
+  ReadinessBitmapNotifier& operator=(ReadinessBitmapNotifier&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Construct notifier for bit index. Throws on error.
+  ReadinessBitmapNotifier(MappedRegion&& storage, std::size_t index);
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Flag queue as ready. Queue producers call it on commit to the queue
+  /// drained by consumer (see setReadinessNotifier()), call after commit() otherwise.
+  /// Writes shared bitmap only in case of the flag was cleared by poller.
+  TURBOQ_FORCE_INLINE void notify() noexcept {
+    // Order commit before reading the flag, pairs with fence in ReadinessBitmapPoller::poll
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((std::atomic_ref(*word_).load(std::memory_order_relaxed) & mask_) == 0) [[unlikely]] {
+      std::atomic_ref(*word_).fetch_or(mask_, std::memory_order_release);
+    }
+  }
+
+  /// Swap resources with other notifier
+  void swap(ReadinessBitmapNotifier& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(word_, that.word_);
+    swap(mask_, that.mask_);
+  }
+
+  /// \see ReadinessBitmapNotifier::swap
+  friend void swap(ReadinessBitmapNotifier& a, ReadinessBitmapNotifier& b) noexcept {
+    a.swap(b);
+  }
+};
+
+/// Implements readiness bitmap poller (consumer side)
+class ReadinessBitmapPoller {
+private:
+  using Detail = ReadinessBitmapDetail;
+
+  MappedRegion storage_;
+  std::span<std::uint64_t> words_;
+
+public:
+  ReadinessBitmapPoller() = default;
+  ~ReadinessBitmapPoller() = default;
+
+  ReadinessBitmapPoller(ReadinessBitmapPoller&& that) noexcept {
+    swap(that);
+  }
+
+  ReadinessBitmapPoller& operator=(ReadinessBitmapPoller&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Construct poller. Throws on error.
+  explicit ReadinessBitmapPoller(MappedRegion&& storage);
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return bitmap size (bits)
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t size() const noexcept {
+    return words_.size() * 64;
+  }
+
+  /// Clear flags and invoke fn(index) for each flagged queue.
+  /// In case of fn returns bool, queue is flagged again on true (messages were
+  /// consumed), so poller looks at it once more on the next poll: producer
+  /// checks consumer position without fence and could miss consumer draining
+  /// the queue concurrently with commit.
+  /// Return number of flagged queues.
+  template <typename Fn>
+  TURBOQ_FORCE_INLINE std::size_t poll(Fn&& fn) {
+    std::size_t count = 0;
+    for (std::size_t block = 0; block < words_.size(); block += Detail::kBlockWords) {
+      if (!Detail::anyBitSet(words_.data() + block)) [[likely]] {
+        continue;
+      }
+      for (std::size_t i = block; i < block + Detail::kBlockWords; ++i) {
+        if (std::atomic_ref(words_[i]).load(std::memory_order_relaxed) == 0) {
+          continue;
+        }
+        auto word = std::atomic_ref(words_[i]).exchange(0, std::memory_order_acq_rel);
+        // Order clearing before reading queues, pairs with fence in ReadinessBitmapNotifier::notify
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (word != 0) {
+          std::size_t const index = i * 64 + std::countr_zero(word);
+          word &= word - 1;
+          if constexpr (std::is_same_v<std::invoke_result_t<Fn&, std::size_t>, bool>) {
+            if (fn(index)) {
+              notify(index);
+            }
+          } else {
+            fn(index);
+          }
+          count++;
+        }
+      }
+    }
+    return count;
+  }
+
+  /// Flag queue as ready again (e.g. queue wasn't drained)
+  TURBOQ_FORCE_INLINE void notify(std::size_t index) noexcept {
+    std::atomic_ref(words_[index / 64]).fetch_or(std::uint64_t(1) << (index % 64), std::memory_order_release);
+  }
+
+  /// Swap resources with other poller
+  void swap(ReadinessBitmapPoller& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(words_, that.words_);
+  }
+
+  /// \see ReadinessBitmapPoller::swap
+  friend void swap(ReadinessBitmapPoller& a, ReadinessBitmapPoller& b) noexcept {
+    a.swap(b);
+  }
+};
+
+} // namespace detail
+
+/// Shared "doorbell" bitmap for polling many queues.
+/// Producers of registered queues set their bit on commit to the empty queue,
+/// poller scans the bitmap 512 bits at a time and visits only flagged queues.
+///
+/// Layout:
+/// +---------------+---+-----------------------+-----------------------+-----
+/// | MemoryHeader  |xxx| 512 bits (block 0)    | 512 bits (block 1)    | ...
+/// +---------------+---+-----------------------+-----------------------+-----
+class ReadinessBitmap {
+private:
+  using Detail = detail::ReadinessBitmapDetail;
+
+  File file_;
+
+public:
+  using Notifier = detail::ReadinessBitmapNotifier;
+  using Poller = detail::ReadinessBitmapPoller;
+
+  struct CreationOptions {
+    /// Number of queues
+    std::size_t sizeHint;
+  };
+
+  ReadinessBitmap(ReadinessBitmap const&) = delete;
+  ReadinessBitmap& operator=(ReadinessBitmap const&) = delete;
+  ReadinessBitmap() = default;
+
+  ReadinessBitmap(ReadinessBitmap&& that) noexcept {
+    swap(that);
+  }
+
+  ReadinessBitmap& operator=(ReadinessBitmap&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only bitmap. Throws on error.
+  explicit ReadinessBitmap(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : ReadinessBitmap(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create bitmap. Throws on error.
+  ReadinessBitmap(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : ReadinessBitmap(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only bitmap.
+  [[nodiscard]] static Result<ReadinessBitmap> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Open or create bitmap.
+  [[nodiscard]] static Result<ReadinessBitmap> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on bitmap intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create notifier for queue with index. Throws on error.
+  [[nodiscard]] Notifier createNotifier(std::size_t index) {
+    return valueOrThrow(tryCreateNotifier(index), "index");
+  }
+
+  /// Create notifier for queue with index.
+  [[nodiscard]] Result<Notifier> tryCreateNotifier(std::size_t index) noexcept;
+
+  /// Create poller for the bitmap. Throws on error.
+  [[nodiscard]] Poller createPoller() {
+    return valueOrThrow(tryCreatePoller());
+  }
+
+  /// Create poller for the bitmap.
+  [[nodiscard]] Result<Poller> tryCreatePoller() noexcept;
+
+  /// Swap resources with other bitmap.
+  void swap(ReadinessBitmap& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+  }
+
+  /// \see ReadinessBitmap::swap
+  friend void swap(ReadinessBitmap& a, ReadinessBitmap& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    return options.sizeHint == 0 ? "size" : nullptr;
+  }
+};
+
+} // namespace turboq
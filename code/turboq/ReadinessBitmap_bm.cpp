@@ -0,0 +1,107 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "ReadinessBitmap.h"
+#include "utils.h"
+
+namespace turboq {
+
+/// Sweep over idle consumers touching each producer position
+static void BM_PollIdle_Consumers(::benchmark::State& state) {
+  std::size_t const count = state.range(0);
+
+  std::vector<BoundedSPSCRawQueue::Consumer> consumers;
+  for (std::size_t i = 0; i < count; ++i) {
+    consumers.push_back(BoundedSPSCRawQueue("bm", {4096}, AnonymousMemorySource()).createConsumer());
+  }
+
+  for (auto _ : state) {
+    std::size_t ready = 0;
+    for (auto& consumer : consumers) {
+      ready += consumer.fetch().empty() ? 0 : 1;
+    }
+    ::benchmark::DoNotOptimize(ready);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Sweep over idle queues through readiness bitmap
+static void BM_PollIdle_Bitmap(::benchmark::State& state) {
+  std::size_t const count = state.range(0);
+
+  ReadinessBitmap bitmap("bm", {count}, AnonymousMemorySource());
+  auto poller = bitmap.createPoller();
+
+  for (auto _ : state) {
+    auto const ready = poller.poll([](std::size_t) {});
+    ::benchmark::DoNotOptimize(ready);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Sweep with one ready queue through readiness bitmap
+static void BM_PollOneReady_Bitmap(::benchmark::State& state) {
+  std::size_t const count = state.range(0);
+
+  ReadinessBitmap bitmap("bm", {count}, AnonymousMemorySource());
+  auto poller = bitmap.createPoller();
+  auto notifier = bitmap.createNotifier(count / 2);
+
+  for (auto _ : state) {
+    notifier.notify();
+    auto const ready = poller.poll([](std::size_t index) {
+      ::benchmark::DoNotOptimize(index);
+    });
+    ::benchmark::DoNotOptimize(ready);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Notify cost when flag is already set
+static void BM_Notify(::benchmark::State& state) {
+  ReadinessBitmap bitmap("bm", {512}, AnonymousMemorySource());
+  auto notifier = bitmap.createNotifier(0);
+
+  for (auto _ : state) {
+    notifier.notify();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Commit cost with notifier attached, queue is never drained (no transitions)
+static void BM_Commit_Notifier(::benchmark::State& state) {
+  ReadinessBitmap bitmap("bm", {512}, AnonymousMemorySource());
+  auto notifier = bitmap.createNotifier(0);
+
+  BoundedSPSCRawQueue queue("bm", {4096}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  producer.setReadinessNotifier(&notifier);
+
+  std::uint64_t value = 0;
+  enqueue(producer, value);
+  for (auto _ : state) {
+    enqueue(producer, value);
+    dequeue(consumer, value);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PollIdle_Consumers)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_PollIdle_Bitmap)->RangeMultiplier(8)->Range(64, 4096)->Arg(65536);
+BENCHMARK(BM_PollOneReady_Bitmap)->RangeMultiplier(8)->Range(64, 4096)->Arg(65536);
+BENCHMARK(BM_Notify);
+BENCHMARK(BM_Commit_Notifier);
+
+} // namespace turboq
@@ -0,0 +1,135 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+#include "ReadinessBitmap.h"
+#include "utils.h"
+
+namespace turboq::testing {
+
+TEST_CASE("ReadinessBitmap: basic") {
+  ReadinessBitmap bitmap("test", ReadinessBitmap::CreationOptions(1000), AnonymousMemorySource());
+
+  auto poller = bitmap.createPoller();
+  REQUIRE(poller);
+  REQUIRE(poller.size() >= 1000);
+
+  auto notifier0 = bitmap.createNotifier(3);
+  auto notifier1 = bitmap.createNotifier(700);
+  auto notifier2 = bitmap.createNotifier(999);
+  REQUIRE(notifier0);
+  REQUIRE(notifier1);
+  REQUIRE(notifier2);
+
+  std::vector<std::size_t> flagged;
+  auto const collect = [&](std::size_t index) {
+    flagged.push_back(index);
+  };
+
+  REQUIRE(poller.poll(collect) == 0);
+
+  notifier2.notify();
+  notifier0.notify();
+  notifier1.notify();
+  notifier1.notify();
+
+  REQUIRE(poller.poll(collect) == 3);
+  REQUIRE(flagged == std::vector<std::size_t>{3, 700, 999});
+
+  flagged.clear();
+  REQUIRE(poller.poll(collect) == 0);
+
+  poller.notify(700);
+  REQUIRE(poller.poll(collect) == 1);
+  REQUIRE(flagged == std::vector<std::size_t>{700});
+
+  REQUIRE_THROWS(bitmap.createNotifier(poller.size()));
+  REQUIRE(!bitmap.tryCreateNotifier(poller.size()));
+}
+
+TEST_CASE("ReadinessBitmap: queues") {
+  ReadinessBitmap bitmap("test", ReadinessBitmap::CreationOptions(64), AnonymousMemorySource());
+  auto poller = bitmap.createPoller();
+
+  constexpr std::size_t kQueues = 16;
+
+  std::vector<BoundedSPSCRawQueue::Producer> producers;
+  std::vector<BoundedSPSCRawQueue::Consumer> consumers;
+  std::vector<ReadinessBitmap::Notifier> notifiers;
+  for (std::size_t i = 0; i < kQueues; ++i) {
+    BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+    producers.push_back(queue.createProducer());
+    consumers.push_back(queue.createConsumer());
+    notifiers.push_back(bitmap.createNotifier(i));
+  }
+  for (std::size_t i = 0; i < kQueues; ++i) {
+    producers[i].setReadinessNotifier(&notifiers[i]);
+  }
+
+  for (std::uint64_t i = 0; i < kQueues; i += 3) {
+    REQUIRE(enqueue(producers[i], i));
+    REQUIRE(enqueue(producers[i], i));
+  }
+
+  std::size_t received = 0;
+  auto const drain = [&](std::size_t index) {
+    std::uint64_t value;
+    bool consumed = false;
+    while (dequeue(consumers[index], value)) {
+      REQUIRE(value == index);
+      received++;
+      consumed = true;
+    }
+    return consumed;
+  };
+
+  REQUIRE(poller.poll(drain) == (kQueues + 2) / 3);
+  REQUIRE(received == 2 * ((kQueues + 2) / 3));
+
+  // drained queues are looked at once more
+  REQUIRE(poller.poll(drain) == (kQueues + 2) / 3);
+  REQUIRE(poller.poll(drain) == 0);
+
+  // commit to drained queue flags it again
+  REQUIRE(enqueue(producers[1], std::uint64_t(1)));
+  REQUIRE(poller.poll(drain) == 1);
+  REQUIRE(received == 2 * ((kQueues + 2) / 3) + 1);
+}
+
+TEST_CASE("ReadinessBitmap: MPSC queue") {
+  ReadinessBitmap bitmap("test", ReadinessBitmap::CreationOptions(64), AnonymousMemorySource());
+  auto poller = bitmap.createPoller();
+  auto notifier = bitmap.createNotifier(5);
+
+  BoundedMPSCRawQueue queue("test", BoundedMPSCRawQueue::CreationOptions(64, 16), AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  producer.setReadinessNotifier(&notifier);
+
+  std::vector<std::size_t> flagged;
+  auto const collect = [&](std::size_t index) {
+    flagged.push_back(index);
+  };
+
+  REQUIRE(enqueue(producer, std::uint64_t(1)));
+  REQUIRE(enqueue(producer, std::uint64_t(2)));
+  REQUIRE(poller.poll(collect) == 1);
+  REQUIRE(flagged == std::vector<std::size_t>{5});
+
+  // consumer hasn't reached the slot, no flag
+  REQUIRE(enqueue(producer, std::uint64_t(3)));
+  REQUIRE(poller.poll(collect) == 0);
+
+  std::uint64_t value;
+  while (dequeue(consumer, value)) {}
+  REQUIRE(enqueue(producer, std::uint64_t(4)));
+  REQUIRE(poller.poll(collect) == 1);
+}
+
+} // namespace turboq::testing
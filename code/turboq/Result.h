@@ -4,11 +4,13 @@
 #pragma once
 
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <system_error>
+#include <utility>
 
-#include <boost/outcome.hpp>
+#include <boost/outcome/std_result.hpp>
 
 #include <turboq/platform.h>
 
@@ -35,6 +37,81 @@ TURBOQ_FORCE_INLINE std::error_category const& getPosixErrorCategory() noexcept
   return errorCategory;
 }
 
+/// Library errors
+enum class Error {
+  /// Memory source failed to open the file
+  MemorySourceOpen = 1,
+  /// Memory doesn't contain valid queue
+  InvalidQueue,
+  /// Invalid argument
+  InvalidArgument,
+  /// Queue alignment is not multiple of CPU cache line size
+  Alignment,
+  /// Existing queue created with other options
+  SizeMismatch,
+  /// Queue is not initialized
+  NotInitialized,
+  /// Producer already exists
+  ProducerExists,
+  /// Consumer already exists
+  ConsumerExists,
+  /// Pipeline stage already exists
+  StageExists,
+  /// Requested size greater max message size
+  MessageTooLarge,
+  /// All named cursor slots are taken
+  NoFreeCursor,
+  /// No room left for new entry
+  NoSpace,
+};
+
+/// Error category for library errors
+struct ErrorCategory final : public std::error_category {
+  constexpr ErrorCategory() noexcept = default;
+
+  /// \see std::error_category
+  char const* name() const noexcept override {
+    return "turboq";
+  }
+
+  /// \see std::error_category
+  std::string message(int error) const override {
+    switch (Error(error)) {
+    case Error::MemorySourceOpen:
+      return "failed to open memory source";
+    case Error::InvalidQueue:
+      return "invalid queue";
+    case Error::InvalidArgument:
+      return "invalid argument";
+    case Error::Alignment:
+      return "queue alignment is not multiple of CPU cache line size";
+    case Error::SizeMismatch:
+      return "size mismatch";
+    case Error::NotInitialized:
+      return "queue not initialized";
+    case Error::ProducerExists:
+      return "can't create producer (already exists?)";
+    case Error::ConsumerExists:
+      return "can't create consumer (already exists?)";
+    case Error::StageExists:
+      return "can't create stage (already exists?)";
+    case Error::MessageTooLarge:
+      return "buffer exceed max message size";
+    case Error::NoFreeCursor:
+      return "no free cursor slots";
+    case Error::NoSpace:
+      return "no space left";
+    }
+    return "unknown error";
+  }
+};
+
+/// Return const reference to ErrorCategory
+TURBOQ_FORCE_INLINE std::error_category const& getErrorCategory() noexcept {
+  static ErrorCategory errorCategory;
+  return errorCategory;
+}
+
 /// @see boost::outcome
 /// mimic: std::expected from c++23
 template <class T = void, class E = std::error_code>
@@ -51,4 +128,56 @@ TURBOQ_FORCE_INLINE decltype(auto) makePosixErrorCode(int ec) noexcept {
   return failure(std::error_code(ec, getPosixErrorCategory()));
 }
 
+/// Return ErrorCode with library error
+TURBOQ_FORCE_INLINE decltype(auto) makeErrorCode(Error error) noexcept {
+  return failure(std::error_code(int(error), getErrorCategory()));
+}
+
+/// Throw std::system_error, terminate in builds without exceptions.
+/// Throwing API is a thin wrapper over Result-returning one.
+[[noreturn]] TURBOQ_COLD inline void throwError(std::error_code const& ec, char const* what = nullptr) {
+#if defined(__cpp_exceptions)
+  if (what == nullptr) {
+    throw std::system_error(ec);
+  }
+  throw std::system_error(ec, what);
+#else
+  (void)ec;
+  (void)what;
+  std::abort();
+#endif
+}
+
+/// \overload
+[[noreturn]] TURBOQ_COLD inline void throwError(Error error, char const* what = nullptr) {
+  throwError(std::error_code(int(error), getErrorCategory()), what);
+}
+
+/// Return result value or throw its error
+template <typename T>
+TURBOQ_FORCE_INLINE T valueOrThrow(Result<T>&& result) {
+  if (!result) [[unlikely]] {
+    throwError(result.error());
+  }
+  return std::move(result).value();
+}
+
+/// \overload
+TURBOQ_FORCE_INLINE void valueOrThrow(Result<>&& result) {
+  if (!result) [[unlikely]] {
+    throwError(result.error());
+  }
+}
+
+/// Return result value or throw its error. Error::InvalidArgument is described
+/// with what (nullptr for no description).
+template <typename T>
+TURBOQ_FORCE_INLINE T valueOrThrow(Result<T>&& result, char const* what) {
+  if (!result) [[unlikely]] {
+    bool const invalidArgument = result.error() == std::error_code(int(Error::InvalidArgument), getErrorCategory());
+    throwError(result.error(), invalidArgument ? what : nullptr);
+  }
+  return std::move(result).value();
+}
+
 } // namespace turboq
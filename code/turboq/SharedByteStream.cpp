@@ -0,0 +1,181 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "SharedByteStream.h"
+
+#include <bit>
+#include <tuple>
+
+#include <turboq/detail/math.h>
+#include <turboq/detail/memory.h>
+
+namespace turboq {
+namespace detail {
+
+bool SharedByteStreamDetail::check(std::span<std::byte const> buffer) noexcept {
+  if (buffer.size() < sizeof(MemoryHeader)) {
+    return false;
+  }
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+    return false;
+  }
+  if (header->headerSize < sizeof(MemoryHeader) || !std::has_single_bit(header->capacity) ||
+      header->headerSize + 2 * header->capacity != buffer.size()) {
+    return false;
+  }
+  return true;
+}
+
+void SharedByteStreamDetail::init(std::span<std::byte> buffer, std::size_t headerSize, std::size_t capacity) noexcept {
+  auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+  std::copy(kTag.begin(), kTag.end(), header->tag);
+  header->headerSize = headerSize;
+  header->capacity = capacity;
+  std::atomic_ref(header->writerPos).store(0, std::memory_order_relaxed);
+  std::atomic_ref(header->closed).store(0, std::memory_order_relaxed);
+  std::atomic_ref(header->readerPos).store(0, std::memory_order_relaxed);
+}
+
+SharedByteStreamWriter::SharedByteStreamWriter(MappedRegion&& storage) : storage_(std::move(storage)) {
+  if (!SharedByteStreamDetail::check(storage_.content())) {
+    throwError(Error::InvalidQueue);
+  }
+
+  header_ = std::bit_cast<SharedByteStreamDetail::MemoryHeader*>(storage_.data());
+  data_ = storage_.data() + header_->headerSize;
+  capacity_ = header_->capacity;
+  writerPos_ = std::atomic_ref(header_->writerPos).load(std::memory_order_relaxed);
+  readerPosCache_ = std::atomic_ref(header_->readerPos).load(std::memory_order_acquire);
+}
+
+SharedByteStreamReader::SharedByteStreamReader(MappedRegion&& storage) : storage_(std::move(storage)) {
+  if (!SharedByteStreamDetail::check(storage_.content())) {
+    throwError(Error::InvalidQueue);
+  }
+
+  header_ = std::bit_cast<SharedByteStreamDetail::MemoryHeader*>(storage_.data());
+  data_ = storage_.data() + header_->headerSize;
+  capacity_ = header_->capacity;
+  readerPos_ = std::atomic_ref(header_->readerPos).load(std::memory_order_relaxed);
+  writerPosCache_ = std::atomic_ref(header_->writerPos).load(std::memory_order_acquire);
+}
+
+} // namespace detail
+
+Result<SharedByteStream> SharedByteStream::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  SharedByteStream stream;
+  std::tie(stream.file_, stream.pageSize_) = std::move(result).value();
+
+  auto const fileSize = stream.file_.tryGetFileSize();
+  if (!fileSize) {
+    return failure(fileSize.error());
+  }
+  if (fileSize.value() <= stream.pageSize_) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  if (auto storage = stream.tryMap(); !storage) {
+    return failure(storage.error());
+  }
+  return stream;
+}
+
+Result<SharedByteStream> SharedByteStream::create(
+    std::string_view name, CreationOptions const& options, MemorySource const& memorySource) noexcept {
+  if (invalidOption(options)) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  SharedByteStream stream;
+  std::tie(stream.file_, stream.pageSize_) = std::move(result).value();
+
+  // header takes the first page, so data could be mapped at page boundary
+  std::size_t const capacity = detail::upper_pow_2(std::max(options.capacityHint, stream.pageSize_));
+  std::size_t const fileSize = stream.pageSize_ + capacity;
+
+  // init stream or check stream's options is the same as requested
+  auto const currentSize = stream.file_.tryGetFileSize();
+  if (!currentSize) {
+    return failure(currentSize.error());
+  }
+  if (currentSize.value() != 0) {
+    if (currentSize.value() != fileSize) {
+      return makeErrorCode(Error::SizeMismatch);
+    }
+    if (auto storage = stream.tryMap(); !storage) {
+      return failure(storage.error());
+    }
+  } else {
+    if (auto truncated = stream.file_.tryTruncate(fileSize); !truncated) {
+      return failure(truncated.error());
+    }
+    auto storage = detail::tryMapFile(stream.file_, fileSize);
+    if (!storage) {
+      return failure(storage.error());
+    }
+    Detail::init(storage.value().content(), stream.pageSize_, capacity);
+  }
+  return stream;
+}
+
+Result<SharedByteStream::Writer> SharedByteStream::tryCreateWriter() noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  auto const locked = file_.tryLockRangeNoThrow(0, 1);
+  if (!locked) {
+    return failure(locked.error());
+  }
+  if (!locked.value()) {
+    return makeErrorCode(Error::ProducerExists);
+  }
+  auto storage = tryMap();
+  if (!storage) {
+    return failure(storage.error());
+  }
+  return Writer(std::move(storage).value());
+}
+
+Result<SharedByteStream::Reader> SharedByteStream::tryCreateReader() noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  auto const locked = file_.tryLockRangeNoThrow(1, 1);
+  if (!locked) {
+    return failure(locked.error());
+  }
+  if (!locked.value()) {
+    return makeErrorCode(Error::ConsumerExists);
+  }
+  auto storage = tryMap();
+  if (!storage) {
+    return failure(storage.error());
+  }
+  return Reader(std::move(storage).value());
+}
+
+Result<MappedRegion> SharedByteStream::tryMap() noexcept {
+  auto const fileSize = file_.tryGetFileSize();
+  if (!fileSize) {
+    return failure(fileSize.error());
+  }
+  auto storage = detail::tryMapFileMirrored(file_, pageSize_, fileSize.value() - pageSize_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  return storage;
+}
+
+} // namespace turboq
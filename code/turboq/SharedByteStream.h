@@ -0,0 +1,334 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include <turboq/File.h>
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+namespace detail {
+
+/// Byte stream detail
+struct SharedByteStreamDetail {
+  /// Stream tag
+  static constexpr std::string_view kTag = "turboq/ByteStream";
+
+  /// Control struct for stream buffer, occupies the first page.
+  /// Positions are monotonic, offset in data is position & (capacity - 1).
+  struct MemoryHeader {
+    /// Placeholder for stream tag
+    char tag[kTag.size()];
+    /// Header size (page size the stream was created with)
+    std::size_t headerSize;
+    /// Data size
+    std::size_t capacity;
+    /// Writer position
+    alignas(kHardwareDestructiveInterferenceSize) std::size_t writerPos;
+    /// Writer closed the stream
+    std::uint32_t closed;
+    /// Reader position
+    alignas(kHardwareDestructiveInterferenceSize) std::size_t readerPos;
+
+    static_assert(std::atomic_ref<std::size_t>::is_always_lock_free);
+    static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Check buffer points to valid mirrored stream region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept;
+
+  /// Init stream memory header
+  static void init(std::span<std::byte> buffer, std::size_t headerSize, std::size_t capacity) noexcept;
+};
+
+/// Implements byte stream writer
+class SharedByteStreamWriter {
+private:
+  MappedRegion storage_;
+  SharedByteStreamDetail::MemoryHeader* header_ = nullptr;
+  std::byte* data_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t writerPos_ = 0;
+  std::size_t readerPosCache_ = 0;
+
+public:
+  SharedByteStreamWriter() = default;
+  ~SharedByteStreamWriter() = default;
+
+  SharedByteStreamWriter(SharedByteStreamWriter&& that) noexcept {
+    swap(that);
+  }
+
+  SharedByteStreamWriter& operator=(SharedByteStreamWriter&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Construct writer over mirrored mapping. Throws on error.
+  explicit SharedByteStreamWriter(MappedRegion&& storage);
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return stream capacity (bytes)
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  /// Return contiguous free space for writing, all free space is contiguous.
+  /// Reader position is re-read only when less than minSize bytes are known free.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> writableSpan(std::size_t minSize = 1) noexcept {
+    std::size_t free = capacity_ - (writerPos_ - readerPosCache_);
+    if (free < minSize) {
+      readerPosCache_ = std::atomic_ref(header_->readerPos).load(std::memory_order_acquire);
+      free = capacity_ - (writerPos_ - readerPosCache_);
+    }
+    return {data_ + (writerPos_ & (capacity_ - 1)), free};
+  }
+
+  /// Make size bytes written to writableSpan() visible to reader
+  /// pre: size <= writableSpan().size()
+  TURBOQ_FORCE_INLINE void commitWrite(std::size_t size) noexcept {
+    writerPos_ += size;
+    std::atomic_ref(header_->writerPos).store(writerPos_, std::memory_order_release);
+  }
+
+  /// Copy as many bytes as fit and commit them. Return number of bytes written.
+  TURBOQ_FORCE_INLINE std::size_t write(std::span<std::byte const> buffer) noexcept {
+    auto span = writableSpan(buffer.size());
+    std::size_t const size = std::min(span.size(), buffer.size());
+    if (size != 0) {
+      std::memcpy(span.data(), buffer.data(), size);
+      commitWrite(size);
+    }
+    return size;
+  }
+
+  /// Mark end of stream, reader reaches eof() after reading committed bytes
+  TURBOQ_FORCE_INLINE void close() noexcept {
+    std::atomic_ref(header_->closed).store(1, std::memory_order_release);
+  }
+
+  /// Swap resources with other writer
+  void swap(SharedByteStreamWriter& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(data_, that.data_);
+    swap(capacity_, that.capacity_);
+    swap(writerPos_, that.writerPos_);
+    swap(readerPosCache_, that.readerPosCache_);
+  }
+
+  /// \see SharedByteStreamWriter::swap
+  friend void swap(SharedByteStreamWriter& a, SharedByteStreamWriter& b) noexcept {
+    a.swap(b);
+  }
+};
+
+/// Implements byte stream reader
+class SharedByteStreamReader {
+private:
+  MappedRegion storage_;
+  SharedByteStreamDetail::MemoryHeader* header_ = nullptr;
+  std::byte const* data_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t readerPos_ = 0;
+  std::size_t writerPosCache_ = 0;
+
+public:
+  SharedByteStreamReader() = default;
+  ~SharedByteStreamReader() = default;
+
+  SharedByteStreamReader(SharedByteStreamReader&& that) noexcept {
+    swap(that);
+  }
+
+  SharedByteStreamReader& operator=(SharedByteStreamReader&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Construct reader over mirrored mapping. Throws on error.
+  explicit SharedByteStreamReader(MappedRegion&& storage);
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return stream capacity (bytes)
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  /// Return contiguous committed bytes for reading, all committed bytes are contiguous.
+  /// Writer position is re-read only when less than minSize bytes are known available.
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte const> readableSpan(std::size_t minSize = 1) noexcept {
+    std::size_t available = writerPosCache_ - readerPos_;
+    if (available < minSize) {
+      writerPosCache_ = std::atomic_ref(header_->writerPos).load(std::memory_order_acquire);
+      available = writerPosCache_ - readerPos_;
+    }
+    return {data_ + (readerPos_ & (capacity_ - 1)), available};
+  }
+
+  /// Release size bytes read from readableSpan() to writer
+  /// pre: size <= readableSpan().size()
+  TURBOQ_FORCE_INLINE void commitRead(std::size_t size) noexcept {
+    readerPos_ += size;
+    std::atomic_ref(header_->readerPos).store(readerPos_, std::memory_order_release);
+  }
+
+  /// Copy as many bytes as available and commit them. Return number of bytes read.
+  TURBOQ_FORCE_INLINE std::size_t read(std::span<std::byte> buffer) noexcept {
+    auto span = readableSpan(buffer.size());
+    std::size_t const size = std::min(span.size(), buffer.size());
+    if (size != 0) {
+      std::memcpy(buffer.data(), span.data(), size);
+      commitRead(size);
+    }
+    return size;
+  }
+
+  /// Return true in case of writer closed the stream and all bytes were read
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool eof() const noexcept {
+    if (std::atomic_ref(header_->closed).load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    return std::atomic_ref(header_->writerPos).load(std::memory_order_acquire) == readerPos_;
+  }
+
+  /// Swap resources with other reader
+  void swap(SharedByteStreamReader& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(data_, that.data_);
+    swap(capacity_, that.capacity_);
+    swap(readerPos_, that.readerPos_);
+    swap(writerPosCache_, that.writerPosCache_);
+  }
+
+  /// \see SharedByteStreamReader::swap
+  friend void swap(SharedByteStreamReader& a, SharedByteStreamReader& b) noexcept {
+    a.swap(b);
+  }
+};
+
+} // namespace detail
+
+/// Shared memory SPSC byte stream with pipe-like semantics and no framing.
+/// Data is mapped twice back to back, so free and committed bytes are always
+/// a single contiguous span, even across the ring end.
+///
+/// Layout (memory):
+/// +--------------+-------------------------+-------------------------+
+/// | MemoryHeader | data                    | data (same pages again) |
+/// +--------------+-------------------------+-------------------------+
+class SharedByteStream {
+private:
+  using Detail = detail::SharedByteStreamDetail;
+
+  File file_;
+  std::size_t pageSize_ = 0;
+
+public:
+  using Writer = detail::SharedByteStreamWriter;
+  using Reader = detail::SharedByteStreamReader;
+
+  struct CreationOptions {
+    /// Data size, rounded up to power of two multiple of page size
+    std::size_t capacityHint;
+  };
+
+  SharedByteStream(SharedByteStream const&) = delete;
+  SharedByteStream& operator=(SharedByteStream const&) = delete;
+  SharedByteStream() = default;
+
+  SharedByteStream(SharedByteStream&& that) noexcept {
+    swap(that);
+  }
+
+  SharedByteStream& operator=(SharedByteStream&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only stream. Throws on error.
+  explicit SharedByteStream(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : SharedByteStream(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create stream. Throws on error.
+  SharedByteStream(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : SharedByteStream(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only stream.
+  [[nodiscard]] static Result<SharedByteStream> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Open or create stream.
+  [[nodiscard]] static Result<SharedByteStream> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on stream intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create writer for the stream. Throws on error.
+  [[nodiscard]] Writer createWriter() {
+    return valueOrThrow(tryCreateWriter());
+  }
+
+  /// Create writer for the stream.
+  [[nodiscard]] Result<Writer> tryCreateWriter() noexcept;
+
+  /// Create reader for the stream. Throws on error.
+  [[nodiscard]] Reader createReader() {
+    return valueOrThrow(tryCreateReader());
+  }
+
+  /// Create reader for the stream.
+  [[nodiscard]] Result<Reader> tryCreateReader() noexcept;
+
+  /// Swap resources with other stream.
+  void swap(SharedByteStream& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+    swap(pageSize_, that.pageSize_);
+  }
+
+  /// \see SharedByteStream::swap
+  friend void swap(SharedByteStream& a, SharedByteStream& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Map header and mirrored data
+  [[nodiscard]] Result<MappedRegion> tryMap() noexcept;
+
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    return options.capacityHint == 0 ? "capacity" : nullptr;
+  }
+};
+
+} // namespace turboq
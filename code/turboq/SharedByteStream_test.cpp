@@ -0,0 +1,141 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "SharedByteStream.h"
+
+namespace turboq::testing {
+
+TEST_CASE("SharedByteStream: mirror") {
+  SharedByteStream stream("test", SharedByteStream::CreationOptions(4096), AnonymousMemorySource());
+
+  auto writer = stream.createWriter();
+  auto reader = stream.createReader();
+  REQUIRE(writer.capacity() == reader.capacity());
+  REQUIRE(writer.writableSpan().size() == writer.capacity());
+  REQUIRE(reader.readableSpan().empty());
+
+  // chunks of odd sizes cross the ring end as a single span
+  std::uint8_t next = 0;
+  std::uint8_t expected = 0;
+  for (std::size_t round = 0; round < 1000; ++round) {
+    std::size_t const size = (round * 37) % writer.capacity() + 1;
+    auto span = writer.writableSpan(size);
+    REQUIRE(span.size() >= size);
+    for (std::size_t i = 0; i < size; ++i) {
+      span[i] = std::byte(next++);
+    }
+    writer.commitWrite(size);
+
+    auto data = reader.readableSpan();
+    REQUIRE(data.size() == size);
+    for (auto value : data) {
+      REQUIRE(value == std::byte(expected++));
+    }
+    reader.commitRead(data.size());
+  }
+}
+
+TEST_CASE("SharedByteStream: full and eof") {
+  SharedByteStream stream("test", SharedByteStream::CreationOptions(4096), AnonymousMemorySource());
+
+  auto writer = stream.createWriter();
+  auto reader = stream.createReader();
+
+  std::vector<std::byte> buffer(writer.capacity() + 100, std::byte(1));
+  REQUIRE(writer.write(buffer) == writer.capacity());
+  REQUIRE(writer.write(buffer) == 0);
+  REQUIRE(writer.writableSpan().empty());
+
+  REQUIRE(reader.read(std::span(buffer).first(100)) == 100);
+  REQUIRE(writer.writableSpan(100).size() == 100);
+  REQUIRE(writer.write(buffer) == 100);
+
+  writer.close();
+  REQUIRE(!reader.eof());
+  REQUIRE(reader.read(buffer) == writer.capacity());
+  REQUIRE(reader.eof());
+  REQUIRE(reader.read(buffer) == 0);
+}
+
+TEST_CASE("SharedByteStream: open") {
+  auto const path = std::filesystem::temp_directory_path();
+  DefaultMemorySource memorySource(path, 4096);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-stream-test");
+  };
+
+  SharedByteStream stream0("turboq-stream-test", SharedByteStream::CreationOptions(10000), memorySource);
+  SharedByteStream stream1("turboq-stream-test", memorySource);
+  REQUIRE_THROWS(SharedByteStream("turboq-stream-test", SharedByteStream::CreationOptions(100000), memorySource));
+
+  auto writer = stream0.createWriter();
+  REQUIRE(writer.capacity() == 16384);
+  REQUIRE_THROWS(stream1.createWriter());
+
+  auto reader = stream1.createReader();
+  REQUIRE_THROWS(stream0.createReader());
+
+  std::string_view const data = "hello";
+  REQUIRE(writer.write(std::as_bytes(std::span(data))) == data.size());
+  auto span = reader.readableSpan();
+  REQUIRE(std::string_view(std::bit_cast<char const*>(span.data()), span.size()) == data);
+}
+
+TEST_CASE("SharedByteStream: threads") {
+  constexpr std::size_t kSize = std::size_t(4) << 20;
+
+  SharedByteStream stream("test", SharedByteStream::CreationOptions(65536), AnonymousMemorySource());
+
+  auto writer = stream.createWriter();
+  auto reader = stream.createReader();
+
+  std::thread thread([&writer] {
+    std::uint64_t value = 0;
+    std::size_t written = 0;
+    while (written < kSize) {
+      auto span = writer.writableSpan(sizeof(value));
+      if (span.size() < sizeof(value)) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::size_t const count = std::min(span.size(), kSize - written) / sizeof(value);
+      for (std::size_t i = 0; i < count; ++i, ++value) {
+        std::memcpy(span.data() + i * sizeof(value), &value, sizeof(value));
+      }
+      writer.commitWrite(count * sizeof(value));
+      written += count * sizeof(value);
+    }
+    writer.close();
+  });
+
+  std::uint64_t expected = 0;
+  while (!reader.eof()) {
+    auto span = reader.readableSpan(sizeof(expected));
+    if (span.size() < sizeof(expected)) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::size_t const count = span.size() / sizeof(expected);
+    for (std::size_t i = 0; i < count; ++i, ++expected) {
+      std::uint64_t value;
+      std::memcpy(&value, span.data() + i * sizeof(value), sizeof(value));
+      REQUIRE(value == expected);
+    }
+    reader.commitRead(count * sizeof(expected));
+  }
+  thread.join();
+
+  REQUIRE(expected * sizeof(expected) == kSize);
+}
+
+} // namespace turboq::testing
@@ -0,0 +1,224 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedMPSCRawQueue.h"
+#include "BoundedSPMCRawQueue.h"
+#include "BoundedSPSCRawQueue.h"
+
+namespace turboq {
+namespace {
+
+/// Memory source selector (benchmark argument)
+enum SourceKind : std::int64_t { Tmpfs, HugePages2M, HugePages1G, Memfd };
+
+constexpr char const* kSourceNames[] = {"tmpfs", "hugetlbfs-2M", "hugetlbfs-1G", "memfd"};
+
+/// Memory source with the directory its files live in (empty for memfd)
+struct Source {
+  std::unique_ptr<MemorySource> memorySource;
+  std::filesystem::path path;
+};
+
+Source makeSource(SourceKind kind) {
+  switch (kind) {
+  case Tmpfs: {
+    auto source = std::make_unique<DefaultMemorySource>(HugePagesOption::None);
+    auto path = source->path();
+    return {std::move(source), std::move(path)};
+  }
+  case HugePages2M: {
+    auto source = std::make_unique<DefaultMemorySource>(HugePagesOption::HugePages2M);
+    auto path = source->path();
+    return {std::move(source), std::move(path)};
+  }
+  case HugePages1G: {
+    auto source = std::make_unique<DefaultMemorySource>(HugePagesOption::HugePages1G);
+    auto path = source->path();
+    return {std::move(source), std::move(path)};
+  }
+  default: {
+    return {std::make_unique<AnonymousMemorySource>(), {}};
+  }
+  }
+}
+
+std::string const gQueueName = "turboq-startup-bm-" + std::to_string(::getpid());
+
+template <typename Queue>
+Queue createQueue(std::size_t capacity, MemorySource const& memorySource) {
+  if constexpr (std::is_same_v<Queue, BoundedMPSCRawQueue>) {
+    return Queue(gQueueName, typename Queue::CreationOptions(64, capacity / 128), memorySource);
+  } else {
+    return Queue(gQueueName, typename Queue::CreationOptions(capacity), memorySource);
+  }
+}
+
+void removeQueue(Source const& source) {
+  if (!source.path.empty()) {
+    std::filesystem::remove(source.path / gQueueName);
+  }
+}
+
+/// Prepare memory source, return false and skip benchmark if it's not usable
+bool setup(::benchmark::State& state, Source& source) {
+  auto const kind = SourceKind(state.range(1));
+  state.SetLabel(kSourceNames[kind]);
+
+  // MAP_POPULATE touches every page, don't let the benchmark push the host into swap
+  std::size_t const available = std::size_t(::sysconf(_SC_AVPHYS_PAGES)) * std::size_t(::sysconf(_SC_PAGESIZE));
+  if (std::size_t(state.range(0)) > available / 2) {
+    state.SkipWithError("not enough free memory");
+    return false;
+  }
+
+  try {
+    source = makeSource(kind);
+  } catch (std::exception const& e) {
+    state.SkipWithError(e.what());
+    return false;
+  }
+  return true;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+/// Create new queue: open, truncate, map and init
+template <typename Queue>
+static void BM_Startup_Create(::benchmark::State& state) {
+  Source source;
+  if (!setup(state, source)) {
+    return;
+  }
+  std::size_t const capacity = state.range(0);
+
+  for (auto _ : state) {
+    try {
+      auto const start = Clock::now();
+      auto queue = createQueue<Queue>(capacity, *source.memorySource);
+      state.SetIterationTime(elapsed(start));
+    } catch (std::exception const& e) {
+      state.SkipWithError(e.what());
+      break;
+    }
+    removeQueue(source);
+  }
+}
+
+/// Open existing queue: open, map and check
+template <typename Queue>
+static void BM_Startup_Open(::benchmark::State& state) {
+  Source source;
+  if (!setup(state, source)) {
+    return;
+  }
+  if (source.path.empty()) {
+    state.SkipWithError("memory source can't be reopened by name");
+    return;
+  }
+  std::size_t const capacity = state.range(0);
+
+  try {
+    auto queue = createQueue<Queue>(capacity, *source.memorySource);
+
+    for (auto _ : state) {
+      auto const start = Clock::now();
+      auto opened = Queue(gQueueName, *source.memorySource);
+      state.SetIterationTime(elapsed(start));
+    }
+  } catch (std::exception const& e) {
+    state.SkipWithError(e.what());
+  }
+  removeQueue(source);
+}
+
+/// Attach producer to existing queue
+template <typename Queue>
+static void BM_Startup_CreateProducer(::benchmark::State& state) {
+  Source source;
+  if (!setup(state, source)) {
+    return;
+  }
+  std::size_t const capacity = state.range(0);
+
+  try {
+    auto queue = createQueue<Queue>(capacity, *source.memorySource);
+
+    for (auto _ : state) {
+      auto const start = Clock::now();
+      auto producer = queue.createProducer();
+      state.SetIterationTime(elapsed(start));
+    }
+  } catch (std::exception const& e) {
+    state.SkipWithError(e.what());
+  }
+  removeQueue(source);
+}
+
+/// Attach consumer to existing queue
+template <typename Queue>
+static void BM_Startup_CreateConsumer(::benchmark::State& state) {
+  Source source;
+  if (!setup(state, source)) {
+    return;
+  }
+  std::size_t const capacity = state.range(0);
+
+  try {
+    auto queue = createQueue<Queue>(capacity, *source.memorySource);
+
+    for (auto _ : state) {
+      auto const start = Clock::now();
+      auto consumer = queue.createConsumer();
+      state.SetIterationTime(elapsed(start));
+    }
+  } catch (std::exception const& e) {
+    state.SkipWithError(e.what());
+  }
+  removeQueue(source);
+}
+
+static void ApplyCustomArgs(::benchmark::internal::Benchmark* b) {
+  for (std::int64_t capacity : {64ll << 10, 1ll << 20, 16ll << 20, 256ll << 20, 4ll << 30}) {
+    for (std::int64_t source : {Tmpfs, HugePages2M, HugePages1G, Memfd}) {
+      b->Args({capacity, source});
+    }
+  }
+  b->ArgNames({"capacity", "source"});
+  b->UseManualTime();
+  b->Unit(::benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_Startup_Create<BoundedSPSCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_Create<BoundedSPMCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_Create<BoundedMPSCRawQueue>)->Apply(ApplyCustomArgs);
+
+BENCHMARK(BM_Startup_Open<BoundedSPSCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_Open<BoundedSPMCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_Open<BoundedMPSCRawQueue>)->Apply(ApplyCustomArgs);
+
+BENCHMARK(BM_Startup_CreateProducer<BoundedSPSCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_CreateProducer<BoundedSPMCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_CreateProducer<BoundedMPSCRawQueue>)->Apply(ApplyCustomArgs);
+
+BENCHMARK(BM_Startup_CreateConsumer<BoundedSPSCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_CreateConsumer<BoundedSPMCRawQueue>)->Apply(ApplyCustomArgs);
+BENCHMARK(BM_Startup_CreateConsumer<BoundedMPSCRawQueue>)->Apply(ApplyCustomArgs);
+
+} // namespace turboq
@@ -0,0 +1,103 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include <turboq/concepts.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Append-only writer for messages of unknown length. Starts with small
+/// reservation and grows it through producer's extend().
+/// Example:
+///   StreamWriter writer(producer);
+///   if (writer.begin()) {
+///     writer.write(header);
+///     writer.write(body);
+///     writer.commit();
+///   }
+template <typename ProducerT>
+  requires GrowableProducer<ProducerT>
+class StreamWriter {
+private:
+  ProducerT* producer_ = nullptr;
+  std::span<std::byte> buffer_;
+  std::size_t size_ = 0;
+
+public:
+  explicit StreamWriter(ProducerT& producer) noexcept : producer_(&producer) {}
+
+  /// Start new message reserving initialSize bytes. Return false on error
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool begin(std::size_t initialSize = 64) noexcept {
+    buffer_ = producer_->prepare(initialSize);
+    size_ = 0;
+    return !buffer_.empty();
+  }
+
+  /// Return buffer of size bytes after written data, growing reservation when
+  /// required. Return empty buffer on error, written data is kept.
+  /// pre: begin() -> true
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> reserve(std::size_t size) noexcept {
+    if (size_ + size > buffer_.size()) [[unlikely]] {
+      if (!grow(size_ + size)) {
+        return {};
+      }
+    }
+    return buffer_.subspan(size_, size);
+  }
+
+  /// Mark size bytes of the reserved buffer as written
+  TURBOQ_FORCE_INLINE void advance(std::size_t size) noexcept {
+    size_ += size;
+  }
+
+  /// Append data. Return false on error, written data is kept.
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool write(void const* data, std::size_t size) noexcept {
+    auto buffer = reserve(size);
+    if (buffer.size() != size) [[unlikely]] {
+      return false;
+    }
+    std::memcpy(buffer.data(), data, size);
+    advance(size);
+    return true;
+  }
+
+  /// \overload
+  template <typename T>
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool write(T const& value) noexcept {
+    return write(&value, sizeof(value));
+  }
+
+  /// Return written size
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Make written data visible for consumers
+  TURBOQ_FORCE_INLINE void commit() {
+    producer_->commit(size_);
+    buffer_ = {};
+  }
+
+private:
+  /// Double reservation, fall back to exact size when doubled doesn't fit
+  TURBOQ_NO_INLINE bool grow(std::size_t size) noexcept {
+    auto buffer = producer_->extend(std::max(size, 2 * buffer_.size()));
+    if (buffer.empty()) {
+      buffer = producer_->extend(size);
+    }
+    if (buffer.empty()) {
+      return false;
+    }
+    buffer_ = buffer;
+    return true;
+  }
+};
+
+} // namespace turboq
@@ -0,0 +1,64 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "StreamWriter.h"
+
+namespace turboq::testing {
+
+TEST_CASE("StreamWriter: basic") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  StreamWriter writer(producer);
+
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    // length prefixed string of unknown length
+    std::string const str(i % 500, char('a' + i % 26));
+
+    REQUIRE(writer.begin(8));
+    REQUIRE(writer.write(std::uint64_t(str.size())));
+    for (char c : str) {
+      REQUIRE(writer.write(c));
+    }
+    REQUIRE(writer.size() == sizeof(std::uint64_t) + str.size());
+    writer.commit();
+
+    auto buffer = consumer.fetch();
+    REQUIRE(buffer.size() == sizeof(std::uint64_t) + str.size());
+    std::uint64_t size;
+    std::memcpy(&size, buffer.data(), sizeof(size));
+    REQUIRE(size == str.size());
+    REQUIRE(std::string(reinterpret_cast<char const*>(buffer.data()) + sizeof(size), size) == str);
+    consumer.consume();
+  }
+}
+
+TEST_CASE("StreamWriter: no space") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(4096), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  StreamWriter writer(producer);
+  REQUIRE(writer.begin());
+  REQUIRE(writer.write(std::uint64_t(42)));
+  REQUIRE(writer.reserve(8192).empty());
+  writer.commit();
+
+  auto buffer = consumer.fetch();
+  REQUIRE(buffer.size() == sizeof(std::uint64_t));
+  std::uint64_t value;
+  std::memcpy(&value, buffer.data(), sizeof(value));
+  REQUIRE(value == 42);
+}
+
+} // namespace turboq::testing
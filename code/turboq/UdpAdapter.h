@@ -0,0 +1,147 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <turboq/Result.h>
+#include <turboq/concepts.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Receive datagrams from UDP socket straight into queue buffers with recvmmsg(2),
+/// one queue message per datagram. Socket is not owned.
+/// Datagrams longer than maxDatagramSize are truncated.
+template <typename ProducerT, std::size_t kBatchSize = 32>
+  requires BatchProducer<ProducerT>
+class UdpIngest {
+private:
+  ProducerT* producer_ = nullptr;
+  int fd_ = -1;
+  std::size_t maxDatagramSize_ = 0;
+  std::size_t truncated_ = 0;
+  std::array<std::span<std::byte>, kBatchSize> buffers_;
+  std::array<std::size_t, kBatchSize> sizes_;
+  std::array<::iovec, kBatchSize> iovecs_;
+  std::array<::mmsghdr, kBatchSize> messages_;
+
+public:
+  /// Construct ingest adapter
+  /// \param[in] producer is queue producer
+  /// \param[in] fd is UDP socket
+  /// \param[in] maxDatagramSize is space reserved for each datagram
+  UdpIngest(ProducerT& producer, int fd, std::size_t maxDatagramSize = 2048) noexcept
+      : producer_(&producer), fd_(fd), maxDatagramSize_(maxDatagramSize) {
+    std::memset(messages_.data(), 0, sizeof(messages_));
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+      messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  /// Return number of datagrams truncated to maxDatagramSize
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t truncated() const noexcept {
+    return truncated_;
+  }
+
+  /// Receive pending datagrams. Return number of received datagrams, zero in
+  /// case of no data or queue is full. Throws std::system_error on socket error.
+  std::size_t poll(int flags = MSG_DONTWAIT) {
+    std::size_t const count = producer_->prepareBatch(maxDatagramSize_, buffers_);
+    if (count == 0) [[unlikely]] {
+      return 0;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      iovecs_[i].iov_base = buffers_[i].data();
+      iovecs_[i].iov_len = buffers_[i].size();
+    }
+
+    int const rc = ::recvmmsg(fd_, messages_.data(), count, flags, nullptr);
+    if (rc < 0) [[unlikely]] {
+      producer_->commitBatch({});
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+      }
+      throwError(std::error_code(errno, getPosixErrorCategory()), "recvmmsg(...)");
+    }
+
+    for (int i = 0; i < rc; ++i) {
+      sizes_[i] = messages_[i].msg_len;
+      if (messages_[i].msg_hdr.msg_flags & MSG_TRUNC) [[unlikely]] {
+        ++truncated_;
+      }
+    }
+    producer_->commitBatch(std::span(sizes_.data(), rc));
+
+    return rc;
+  }
+};
+
+/// Send queue messages to UDP socket with sendmmsg(2), one datagram per queue
+/// message. Messages are sent straight from the queue buffer and consumed once
+/// the kernel accepted them. Socket is not owned.
+template <typename ConsumerT, std::size_t kBatchSize = 32>
+  requires BatchConsumer<ConsumerT>
+class UdpEgress {
+private:
+  ConsumerT* consumer_ = nullptr;
+  int fd_ = -1;
+  std::array<std::span<std::byte const>, kBatchSize> buffers_;
+  std::array<::iovec, kBatchSize> iovecs_;
+  std::array<::mmsghdr, kBatchSize> messages_;
+
+public:
+  /// Construct egress adapter
+  /// \param[in] consumer is queue consumer
+  /// \param[in] fd is UDP socket
+  /// \param[in] address is destination address, nullptr for connected socket
+  /// \param[in] addressLen is destination address size
+  UdpEgress(ConsumerT& consumer, int fd, ::sockaddr const* address = nullptr, ::socklen_t addressLen = 0) noexcept
+      : consumer_(&consumer), fd_(fd) {
+    std::memset(messages_.data(), 0, sizeof(messages_));
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      messages_[i].msg_hdr.msg_name = const_cast<::sockaddr*>(address);
+      messages_[i].msg_hdr.msg_namelen = addressLen;
+      messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+      messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  /// Send pending messages. Return number of sent datagrams, zero in case of no
+  /// data or socket buffer is full. Throws std::system_error on socket error.
+  std::size_t poll(int flags = MSG_DONTWAIT) {
+    std::size_t const count = consumer_->fetchBatch(buffers_);
+    if (count == 0) {
+      return 0;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      iovecs_[i].iov_base = const_cast<std::byte*>(buffers_[i].data());
+      iovecs_[i].iov_len = buffers_[i].size();
+    }
+
+    int const rc = ::sendmmsg(fd_, messages_.data(), count, flags);
+    if (rc < 0) [[unlikely]] {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+      }
+      throwError(std::error_code(errno, getPosixErrorCategory()), "sendmmsg(...)");
+    }
+    consumer_->consumeBatch(rc);
+
+    return rc;
+  }
+};
+
+} // namespace turboq
@@ -0,0 +1,182 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "UdpAdapter.h"
+
+namespace turboq {
+namespace {
+
+constexpr std::size_t kBatchSize = 32;
+
+/// Loopback UDP socket pair, sender connected to receiver
+struct SocketPair {
+  File sender;
+  File receiver;
+
+  SocketPair() : sender(::socket(AF_INET, SOCK_DGRAM, 0), true), receiver(::socket(AF_INET, SOCK_DGRAM, 0), true) {
+    ::sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::socklen_t addressLen = sizeof(address);
+    ::bind(receiver.get(), reinterpret_cast<::sockaddr*>(&address), addressLen);
+    ::getsockname(receiver.get(), reinterpret_cast<::sockaddr*>(&address), &addressLen);
+    ::connect(sender.get(), reinterpret_cast<::sockaddr*>(&address), addressLen);
+  }
+};
+
+/// Send batch of datagrams (untimed part of ingest benchmarks)
+void sendBatch(int fd, std::vector<std::byte> const& payload) {
+  std::array<::iovec, kBatchSize> iovecs;
+  std::array<::mmsghdr, kBatchSize> messages = {};
+  for (std::size_t i = 0; i < kBatchSize; ++i) {
+    iovecs[i] = {const_cast<std::byte*>(payload.data()), payload.size()};
+    messages[i].msg_hdr.msg_iov = &iovecs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  for (std::size_t sent = 0; sent < kBatchSize;) {
+    sent += std::max(0, ::sendmmsg(fd, messages.data() + sent, kBatchSize - sent, 0));
+  }
+}
+
+/// Drain socket (untimed part of egress benchmarks)
+void receiveBatch(int fd, std::vector<std::byte>& scratch) {
+  for (std::size_t received = 0; received < kBatchSize;) {
+    if (::recv(fd, scratch.data(), scratch.size(), 0) > 0) {
+      ++received;
+    }
+  }
+}
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+/// recvfrom(2) into stack buffer and memcpy into queue, one syscall per datagram
+static void BM_UdpIngest_RecvFrom(::benchmark::State& state) {
+  BoundedSPSCRawQueue queue("bm", {std::size_t(4 << 20)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  SocketPair sockets;
+
+  std::vector<std::byte> payload(state.range(0));
+  std::array<std::byte, 2048> packet;
+
+  for (auto _ : state) {
+    sendBatch(sockets.sender.get(), payload);
+
+    auto const start = Clock::now();
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      auto const size = ::recvfrom(sockets.receiver.get(), packet.data(), packet.size(), 0, nullptr, nullptr);
+      auto buffer = producer.prepare(size);
+      std::memcpy(buffer.data(), packet.data(), size);
+      producer.commit();
+    }
+    state.SetIterationTime(std::chrono::duration<double>(Clock::now() - start).count());
+
+    consumer.reset();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/// recvmmsg(2) straight into reserved queue buffers
+static void BM_UdpIngest_RecvMMsg(::benchmark::State& state) {
+  BoundedSPSCRawQueue queue("bm", {std::size_t(4 << 20)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  SocketPair sockets;
+
+  std::vector<std::byte> payload(state.range(0));
+  UdpIngest<BoundedSPSCRawQueue::Producer, kBatchSize> ingest(producer, sockets.receiver.get());
+
+  for (auto _ : state) {
+    sendBatch(sockets.sender.get(), payload);
+
+    auto const start = Clock::now();
+    for (std::size_t received = 0; received < kBatchSize;) {
+      received += ingest.poll(0);
+    }
+    state.SetIterationTime(std::chrono::duration<double>(Clock::now() - start).count());
+
+    consumer.reset();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/// send(2) per queue message
+static void BM_UdpEgress_Send(::benchmark::State& state) {
+  BoundedSPSCRawQueue queue("bm", {std::size_t(4 << 20)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  SocketPair sockets;
+
+  std::size_t const size = state.range(0);
+  std::vector<std::byte> scratch(2048);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      std::ignore = producer.prepare(size);
+      producer.commit();
+    }
+
+    auto const start = Clock::now();
+    for (auto buffer = consumer.fetch(); !buffer.empty(); buffer = consumer.fetch()) {
+      ::send(sockets.sender.get(), buffer.data(), buffer.size(), 0);
+      consumer.consume();
+    }
+    state.SetIterationTime(std::chrono::duration<double>(Clock::now() - start).count());
+
+    receiveBatch(sockets.receiver.get(), scratch);
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/// sendmmsg(2) straight from queue buffers
+static void BM_UdpEgress_SendMMsg(::benchmark::State& state) {
+  BoundedSPSCRawQueue queue("bm", {std::size_t(4 << 20)}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+  SocketPair sockets;
+
+  std::size_t const size = state.range(0);
+  std::vector<std::byte> scratch(2048);
+  UdpEgress<BoundedSPSCRawQueue::Consumer, kBatchSize> egress(consumer, sockets.sender.get());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      std::ignore = producer.prepare(size);
+      producer.commit();
+    }
+
+    auto const start = Clock::now();
+    for (std::size_t sent = 0; sent < kBatchSize;) {
+      sent += egress.poll(0);
+    }
+    state.SetIterationTime(std::chrono::duration<double>(Clock::now() - start).count());
+
+    receiveBatch(sockets.receiver.get(), scratch);
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK(BM_UdpIngest_RecvFrom)->Arg(64)->Arg(512)->Arg(1400)->UseManualTime();
+BENCHMARK(BM_UdpIngest_RecvMMsg)->Arg(64)->Arg(512)->Arg(1400)->UseManualTime();
+BENCHMARK(BM_UdpEgress_Send)->Arg(64)->Arg(512)->Arg(1400)->UseManualTime();
+BENCHMARK(BM_UdpEgress_SendMMsg)->Arg(64)->Arg(512)->Arg(1400)->UseManualTime();
+
+} // namespace turboq
@@ -0,0 +1,120 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "UdpAdapter.h"
+#include "utils.h"
+
+namespace turboq::testing {
+namespace {
+
+/// Bound to loopback UDP socket
+File makeSocket() {
+  File socket(::socket(AF_INET, SOCK_DGRAM, 0), true);
+  REQUIRE(socket);
+
+  ::sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  REQUIRE(::bind(socket.get(), reinterpret_cast<::sockaddr*>(&address), sizeof(address)) == 0);
+
+  return socket;
+}
+
+/// Connect socket to address of other socket
+void connect(File const& socket, File const& to) {
+  ::sockaddr_in address = {};
+  ::socklen_t addressLen = sizeof(address);
+  REQUIRE(::getsockname(to.get(), reinterpret_cast<::sockaddr*>(&address), &addressLen) == 0);
+  REQUIRE(::connect(socket.get(), reinterpret_cast<::sockaddr*>(&address), addressLen) == 0);
+}
+
+} // namespace
+
+TEST_CASE("UdpAdapter: loopback") {
+  BoundedSPSCRawQueue egressQueue("test", BoundedSPSCRawQueue::CreationOptions(1 << 20), AnonymousMemorySource());
+  BoundedSPSCRawQueue ingestQueue("test", BoundedSPSCRawQueue::CreationOptions(1 << 20), AnonymousMemorySource());
+
+  auto egressProducer = egressQueue.createProducer();
+  auto egressConsumer = egressQueue.createConsumer();
+  auto ingestProducer = ingestQueue.createProducer();
+  auto ingestConsumer = ingestQueue.createConsumer();
+
+  auto sender = makeSocket();
+  auto receiver = makeSocket();
+  connect(sender, receiver);
+
+  UdpEgress egress(egressConsumer, sender.get());
+  UdpIngest ingest(ingestProducer, receiver.get(), 256);
+
+  constexpr std::uint64_t kCount = 1000;
+
+  std::uint64_t sent = 0;
+  std::uint64_t received = 0;
+  while (received < kCount) {
+    // variable sized messages, size and content derived from the sequence number
+    for (std::size_t i = 0; i < 16 && sent < kCount; ++i, ++sent) {
+      std::string const payload(sent % 200 + sizeof(sent) + 1, char('a' + sent % 26));
+      auto buffer = egressProducer.prepare(payload.size());
+      REQUIRE(!buffer.empty());
+      std::memcpy(buffer.data(), payload.data(), payload.size());
+      std::memcpy(buffer.data(), &sent, sizeof(sent));
+      egressProducer.commit();
+    }
+
+    egress.poll();
+    ingest.poll();
+
+    for (auto buffer = ingestConsumer.fetch(); !buffer.empty(); buffer = ingestConsumer.fetch()) {
+      std::uint64_t sequence;
+      std::memcpy(&sequence, buffer.data(), sizeof(sequence));
+      // loopback doesn't reorder, but could drop on receive buffer overflow
+      REQUIRE(sequence >= received);
+      REQUIRE(buffer.size() == sequence % 200 + sizeof(sequence) + 1);
+      REQUIRE(buffer.back() == std::byte('a' + sequence % 26));
+      received = sequence + 1;
+      ingestConsumer.consume();
+    }
+  }
+
+  REQUIRE(ingest.truncated() == 0);
+}
+
+TEST_CASE("UdpAdapter: truncated") {
+  BoundedSPSCRawQueue queue("test", BoundedSPSCRawQueue::CreationOptions(1 << 16), AnonymousMemorySource());
+
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  auto sender = makeSocket();
+  auto receiver = makeSocket();
+  connect(sender, receiver);
+
+  std::string const payload(100, 'x');
+  REQUIRE(::send(sender.get(), payload.data(), payload.size(), 0) == ssize_t(payload.size()));
+
+  UdpIngest ingest(producer, receiver.get(), 64);
+  while (ingest.poll() == 0) {}
+
+  auto buffer = consumer.fetch();
+  REQUIRE(buffer.size() == 64);
+  REQUIRE(ingest.truncated() == 1);
+  consumer.consume();
+
+  // unused reservations of the batch are returned to the queue
+  REQUIRE(consumer.fetch().empty());
+  REQUIRE(ingest.poll() == 0);
+  REQUIRE(consumer.fetch().empty());
+}
+
+} // namespace turboq::testing
@@ -0,0 +1,149 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <boost/scope_exit.hpp>
+
+#include <turboq/detail/memory.h>
+
+namespace turboq {
+namespace detail {
+
+bool WorkStealingPoolDetail::check(std::span<std::byte const> buffer) noexcept {
+  if (buffer.size() < kDequesStartPos) {
+    return false;
+  }
+  auto const header = std::bit_cast<MemoryHeader const*>(buffer.data());
+  if (!std::equal(kTag.begin(), kTag.end(), header->tag)) {
+    return false;
+  }
+  if (header->workers == 0 || !std::has_single_bit(header->capacity) ||
+      arenaStartPos(header->workers, header->capacity) + header->arenaSize > buffer.size()) {
+    return false;
+  }
+  return true;
+}
+
+void WorkStealingPoolDetail::init(
+    std::span<std::byte> buffer, std::size_t workers, std::size_t capacity, std::size_t arenaSize) noexcept {
+  auto header = std::bit_cast<MemoryHeader*>(buffer.data());
+  std::copy(kTag.begin(), kTag.end(), header->tag);
+  header->workers = workers;
+  header->capacity = capacity;
+  header->arenaSize = arenaSize;
+  for (std::size_t i = 0; i < workers; ++i) {
+    auto deque = std::bit_cast<DequeHeader*>(buffer.data() + kDequesStartPos + i * dequeSize(capacity));
+    std::atomic_ref(deque->top).store(0, std::memory_order_relaxed);
+    std::atomic_ref(deque->bottom).store(0, std::memory_order_relaxed);
+  }
+}
+
+WorkStealingPoolWorker::WorkStealingPoolWorker(MappedRegion&& storage, std::size_t index) noexcept
+    : storage_(std::move(storage)), header_(std::bit_cast<Detail::MemoryHeader*>(storage_.data())), index_(index),
+      victim_(index) {}
+
+} // namespace detail
+
+Result<WorkStealingPool> WorkStealingPool::open(std::string_view name, MemorySource const& memorySource) noexcept {
+  auto result = memorySource.open(name, MemorySource::OpenOnly);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  WorkStealingPool pool;
+  std::size_t pageSize;
+  std::tie(pool.file_, pageSize) = std::move(result).value();
+
+  auto storage = detail::tryMapFile(pool.file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (!Detail::check(storage.value().content())) {
+    return makeErrorCode(Error::InvalidQueue);
+  }
+  return pool;
+}
+
+Result<WorkStealingPool> WorkStealingPool::create(
+    std::string_view name, CreationOptions const& options, MemorySource const& memorySource) noexcept {
+  if (invalidOption(options)) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  auto result = memorySource.open(name, MemorySource::OpenOrCreate);
+  if (!result) {
+    return makeErrorCode(Error::MemorySourceOpen);
+  }
+
+  WorkStealingPool pool;
+  std::size_t pageSize;
+  std::tie(pool.file_, pageSize) = std::move(result).value();
+
+  std::size_t const capacity = detail::upper_pow_2(options.capacityHint);
+  std::size_t const fileSize =
+      detail::align_up(Detail::arenaStartPos(options.workers, capacity) + options.arenaSize, pageSize);
+
+  // init pool or check pool's options is the same as requested,
+  // the lock is released before the pool is returned
+  {
+    if (auto locked = pool.file_.lockNoThrow(); !locked) {
+      return failure(locked.error());
+    }
+    BOOST_SCOPE_EXIT_ALL(&) {
+      std::ignore = pool.file_.unlockNoThrow();
+    };
+    auto const currentSize = pool.file_.tryGetFileSize();
+    if (!currentSize) {
+      return failure(currentSize.error());
+    }
+    if (currentSize.value() != 0) {
+      if (currentSize.value() != fileSize) {
+        return makeErrorCode(Error::SizeMismatch);
+      }
+      auto storage = detail::tryMapFile(pool.file_);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      if (!Detail::check(storage.value().content())) {
+        return makeErrorCode(Error::InvalidQueue);
+      }
+    } else {
+      if (auto truncated = pool.file_.tryTruncate(fileSize); !truncated) {
+        return failure(truncated.error());
+      }
+      auto storage = detail::tryMapFile(pool.file_, fileSize);
+      if (!storage) {
+        return failure(storage.error());
+      }
+      Detail::init(storage.value().content(), options.workers, capacity, options.arenaSize);
+    }
+  }
+  return pool;
+}
+
+Result<WorkStealingPool::Worker> WorkStealingPool::tryCreateWorker(std::size_t index) noexcept {
+  if (!operator bool()) {
+    return makeErrorCode(Error::NotInitialized);
+  }
+  auto storage = detail::tryMapFile(file_);
+  if (!storage) {
+    return failure(storage.error());
+  }
+  if (index >= std::bit_cast<Detail::MemoryHeader const*>(storage.value().data())->workers) {
+    return makeErrorCode(Error::InvalidArgument);
+  }
+  // one byte lock per worker, slot of crashed process could be claimed again
+  auto const locked = file_.tryLockRangeNoThrow(index, 1);
+  if (!locked) {
+    return failure(locked.error());
+  }
+  if (!locked.value()) {
+    return makeErrorCode(Error::ConsumerExists);
+  }
+  return Worker(std::move(storage).value(), index);
+}
+
+} // namespace turboq
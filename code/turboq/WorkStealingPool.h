@@ -0,0 +1,363 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include <turboq/File.h>
+#include <turboq/MappedRegion.h>
+#include <turboq/MemorySource.h>
+#include <turboq/Result.h>
+#include <turboq/detail/math.h>
+#include <turboq/platform.h>
+
+namespace turboq {
+
+/// Task descriptor. Payload (if any) lives in the pool arena or in other
+/// shared region, the descriptor only refers to it.
+struct WorkStealingTask {
+  /// Application defined task kind
+  std::uint64_t kind = 0;
+  /// Payload offset (e.g. in WorkStealingPool arena)
+  std::uint64_t offset = 0;
+  /// Payload size
+  std::uint64_t size = 0;
+  /// Application defined argument
+  std::uint64_t arg = 0;
+};
+static_assert(std::is_trivially_copyable_v<WorkStealingTask>);
+
+namespace detail {
+
+/// Work-stealing pool detail
+struct WorkStealingPoolDetail {
+  /// Pool tag
+  static constexpr std::string_view kTag = "turboq/WorkStealingPool";
+  /// Alignment
+  static constexpr std::size_t kAlign = kHardwareDestructiveInterferenceSize;
+
+  /// Control struct for pool buffer
+  struct MemoryHeader {
+    /// Placeholder for pool tag
+    char tag[kTag.size()];
+    /// Workers count
+    std::size_t workers;
+    /// Deque capacity (tasks, power of two)
+    std::size_t capacity;
+    /// Arena size (bytes)
+    std::size_t arenaSize;
+  };
+  static_assert(std::is_trivially_copyable_v<MemoryHeader>);
+
+  /// Chase-Lev deque indices. Owner pushes and pops at bottom, thieves steal
+  /// at top. Tasks follow the header.
+  struct DequeHeader {
+    /// Next task to steal
+    alignas(kAlign) std::int64_t top;
+    /// Next free slot
+    alignas(kAlign) std::int64_t bottom;
+
+    static_assert(std::atomic_ref<std::int64_t>::is_always_lock_free);
+  };
+  static_assert(std::is_trivially_copyable_v<DequeHeader>);
+
+  /// Offset for the first deque from memory buffer start
+  static constexpr std::size_t kDequesStartPos = align_up(sizeof(MemoryHeader), kAlign);
+
+  /// Return size of deque with its tasks
+  static constexpr std::size_t dequeSize(std::size_t capacity) noexcept {
+    return align_up(sizeof(DequeHeader) + capacity * sizeof(WorkStealingTask), kAlign);
+  }
+
+  /// Return offset of the arena
+  static constexpr std::size_t arenaStartPos(std::size_t workers, std::size_t capacity) noexcept {
+    return kDequesStartPos + workers * dequeSize(capacity);
+  }
+
+  /// Check buffer points to valid pool region
+  /// Return true on success and false otherwise.
+  [[nodiscard]] static bool check(std::span<std::byte const> buffer) noexcept;
+
+  /// Init pool memory header and deques
+  static void init(
+      std::span<std::byte> buffer, std::size_t workers, std::size_t capacity, std::size_t arenaSize) noexcept;
+};
+
+/// Implements a pool worker: owner of one deque and thief of the others
+class WorkStealingPoolWorker {
+private:
+  using Detail = WorkStealingPoolDetail;
+
+  MappedRegion storage_;
+  Detail::MemoryHeader* header_ = nullptr;
+  std::size_t index_ = 0;
+  std::size_t victim_ = 0;
+
+public:
+  WorkStealingPoolWorker() = default;
+  ~WorkStealingPoolWorker() = default;
+
+  WorkStealingPoolWorker(WorkStealingPoolWorker&& that) noexcept {
+    swap(that);
+  }
+
+  WorkStealingPoolWorker& operator=(WorkStealingPoolWorker&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Construct worker owning deque index
+  WorkStealingPoolWorker(MappedRegion&& storage, std::size_t index) noexcept;
+
+  /// Return true on initialized
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(storage_);
+  }
+
+  /// Return worker index
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t index() const noexcept {
+    return index_;
+  }
+
+  /// Return shared arena for task payloads
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::span<std::byte> arena() noexcept {
+    return storage_.content().subspan(Detail::arenaStartPos(header_->workers, header_->capacity), header_->arenaSize);
+  }
+
+  /// Push task to own deque. Return false in case of deque is full.
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool push(WorkStealingTask const& task) noexcept {
+    auto deque = dequeAt(index_);
+    auto const bottom = std::atomic_ref(deque->bottom).load(std::memory_order_relaxed);
+    auto const top = std::atomic_ref(deque->top).load(std::memory_order_acquire);
+    if (bottom - top >= std::int64_t(header_->capacity)) [[unlikely]] {
+      return false;
+    }
+    store(slot(deque, bottom), task);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref(deque->bottom).store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Pop the most recently pushed task from own deque. Return false in case of
+  /// deque is empty.
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool pop(WorkStealingTask& task) noexcept {
+    auto deque = dequeAt(index_);
+    auto const bottom = std::atomic_ref(deque->bottom).load(std::memory_order_relaxed) - 1;
+    std::atomic_ref(deque->bottom).store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = std::atomic_ref(deque->top).load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      // empty
+      std::atomic_ref(deque->bottom).store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    task = load(slot(deque, bottom));
+    if (top == bottom) {
+      // the last task, race with thieves
+      bool const won = std::atomic_ref(deque->top).compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      std::atomic_ref(deque->bottom).store(bottom + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /// Steal the oldest task from other workers' deques, one pass over victims.
+  /// Return false in case of nothing was stolen.
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool steal(WorkStealingTask& task) noexcept {
+    std::size_t const workers = header_->workers;
+    for (std::size_t i = 0; i < workers; ++i) {
+      if (++victim_ == workers) {
+        victim_ = 0;
+      }
+      if (victim_ != index_ && stealFrom(victim_, task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Get next task: own deque first, steal otherwise
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool next(WorkStealingTask& task) noexcept {
+    return pop(task) || steal(task);
+  }
+
+  /// Return approximate number of tasks in own deque
+  [[nodiscard]] TURBOQ_FORCE_INLINE std::size_t size() const noexcept {
+    auto deque = dequeAt(index_);
+    auto const bottom = std::atomic_ref(deque->bottom).load(std::memory_order_relaxed);
+    auto const top = std::atomic_ref(deque->top).load(std::memory_order_relaxed);
+    return bottom > top ? std::size_t(bottom - top) : 0;
+  }
+
+  /// Swap resources with other worker
+  void swap(WorkStealingPoolWorker& that) noexcept {
+    using std::swap;
+    swap(storage_, that.storage_);
+    swap(header_, that.header_);
+    swap(index_, that.index_);
+    swap(victim_, that.victim_);
+  }
+
+  /// \see WorkStealingPoolWorker::swap
+  friend void swap(WorkStealingPoolWorker& a, WorkStealingPoolWorker& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return deque of worker
+  [[nodiscard]] TURBOQ_FORCE_INLINE Detail::DequeHeader* dequeAt(std::size_t index) const noexcept {
+    return std::bit_cast<Detail::DequeHeader*>(
+        storage_.data() + Detail::kDequesStartPos + index * Detail::dequeSize(header_->capacity));
+  }
+
+  /// Return task slot for deque index
+  [[nodiscard]] TURBOQ_FORCE_INLINE WorkStealingTask* slot(Detail::DequeHeader* deque, std::int64_t i) const noexcept {
+    return std::bit_cast<WorkStealingTask*>(deque + 1) + (std::size_t(i) & (header_->capacity - 1));
+  }
+
+  /// Steal the oldest task of victim's deque
+  [[nodiscard]] TURBOQ_FORCE_INLINE bool stealFrom(std::size_t victim, WorkStealingTask& task) noexcept {
+    auto deque = dequeAt(victim);
+    auto top = std::atomic_ref(deque->top).load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto const bottom = std::atomic_ref(deque->bottom).load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    // slot is not reused by owner until top moves past it
+    task = load(slot(deque, top));
+    return std::atomic_ref(deque->top).compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  /// Store task, thieves could read the slot concurrently
+  static TURBOQ_FORCE_INLINE void store(WorkStealingTask* slot, WorkStealingTask const& task) noexcept {
+    std::atomic_ref(slot->kind).store(task.kind, std::memory_order_relaxed);
+    std::atomic_ref(slot->offset).store(task.offset, std::memory_order_relaxed);
+    std::atomic_ref(slot->size).store(task.size, std::memory_order_relaxed);
+    std::atomic_ref(slot->arg).store(task.arg, std::memory_order_relaxed);
+  }
+
+  /// Load task, owner could write the slot concurrently in case of lost race
+  [[nodiscard]] static TURBOQ_FORCE_INLINE WorkStealingTask load(WorkStealingTask* slot) noexcept {
+    WorkStealingTask task;
+    task.kind = std::atomic_ref(slot->kind).load(std::memory_order_relaxed);
+    task.offset = std::atomic_ref(slot->offset).load(std::memory_order_relaxed);
+    task.size = std::atomic_ref(slot->size).load(std::memory_order_relaxed);
+    task.arg = std::atomic_ref(slot->arg).load(std::memory_order_relaxed);
+    return task;
+  }
+};
+
+} // namespace detail
+
+/// Shared memory work-stealing pool without central dispatcher.
+/// Each worker (thread or process) owns a bounded Chase-Lev deque: it pushes
+/// and pops tasks at the bottom, idle workers steal the oldest tasks from
+/// the top of the others' deques. Task descriptors refer to payloads in the
+/// shared arena, arena allocation is up to the application.
+///
+/// Worker slots are claimed with one byte file range lock per index, so a slot
+/// of a crashed process could be claimed again and its deque drained by the
+/// new owner.
+///
+/// Layout:
+/// +--------------+---+-----------------------+-----+-----------------------+-------+
+/// | MemoryHeader |xxx| DequeHeader | tasks   | ... | DequeHeader | tasks   | arena |
+/// +--------------+---+-----------------------+-----+-----------------------+-------+
+class WorkStealingPool {
+private:
+  using Detail = detail::WorkStealingPoolDetail;
+
+  File file_;
+
+public:
+  using Worker = detail::WorkStealingPoolWorker;
+
+  struct CreationOptions {
+    /// Max workers count
+    std::size_t workers;
+    /// Deque capacity (tasks per worker), rounded up to power of two
+    std::size_t capacityHint;
+    /// Shared payload arena size (bytes)
+    std::size_t arenaSize = 0;
+  };
+
+  WorkStealingPool(WorkStealingPool const&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool const&) = delete;
+  WorkStealingPool() = default;
+
+  WorkStealingPool(WorkStealingPool&& that) noexcept {
+    swap(that);
+  }
+
+  WorkStealingPool& operator=(WorkStealingPool&& that) noexcept {
+    swap(that);
+    return *this;
+  }
+
+  /// Open only pool. Throws on error.
+  explicit WorkStealingPool(std::string_view name, MemorySource const& memorySource = DefaultMemorySource())
+      : WorkStealingPool(valueOrThrow(open(name, memorySource))) {}
+
+  /// Open or create pool. Throws on error.
+  WorkStealingPool(
+      std::string_view name, CreationOptions const& options, MemorySource const& memorySource = DefaultMemorySource())
+      : WorkStealingPool(valueOrThrow(create(name, options, memorySource), invalidOption(options))) {}
+
+  /// Open only pool.
+  [[nodiscard]] static Result<WorkStealingPool> open(
+      std::string_view name, MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Open or create pool.
+  [[nodiscard]] static Result<WorkStealingPool> create(std::string_view name, CreationOptions const& options,
+      MemorySource const& memorySource = DefaultMemorySource()) noexcept;
+
+  /// Return true on pool intialized.
+  [[nodiscard]] TURBOQ_FORCE_INLINE explicit operator bool() const noexcept {
+    return static_cast<bool>(file_);
+  }
+
+  /// Create worker owning deque index. Throws on error.
+  [[nodiscard]] Worker createWorker(std::size_t index) {
+    return valueOrThrow(tryCreateWorker(index), "index");
+  }
+
+  /// Create worker owning deque index.
+  [[nodiscard]] Result<Worker> tryCreateWorker(std::size_t index) noexcept;
+
+  /// Swap resources with other pool.
+  void swap(WorkStealingPool& that) noexcept {
+    using std::swap;
+    swap(file_, that.file_);
+  }
+
+  /// \see WorkStealingPool::swap
+  friend void swap(WorkStealingPool& a, WorkStealingPool& b) noexcept {
+    a.swap(b);
+  }
+
+private:
+  /// Return name of invalid creation option or nullptr
+  [[nodiscard]] static char const* invalidOption(CreationOptions const& options) noexcept {
+    if (options.workers == 0) {
+      return "workers";
+    }
+    if (options.capacityHint == 0) {
+      return "capacity";
+    }
+    return nullptr;
+  }
+};
+
+} // namespace turboq
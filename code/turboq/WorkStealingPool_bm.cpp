@@ -0,0 +1,113 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "WorkStealingPool.h"
+
+namespace turboq {
+namespace {
+
+/// Depth of task tree, 2^(depth + 1) - 1 tasks per iteration
+constexpr std::uint64_t kDepth = 14;
+/// Payload size of each task
+constexpr std::size_t kPayloadSize = 64;
+/// Payloads in arena
+constexpr std::size_t kPayloads = 1024;
+
+/// Simulated task work over its payload in the arena
+TURBOQ_FORCE_INLINE std::uint64_t execute(std::span<std::byte const> arena, WorkStealingTask const& task) noexcept {
+  std::uint64_t sum = 0;
+  for (std::size_t round = 0; round < 4; ++round) {
+    for (std::size_t i = 0; i < task.size; i += sizeof(std::uint64_t)) {
+      std::uint64_t value;
+      std::memcpy(&value, arena.data() + task.offset + i, sizeof(value));
+      sum = sum * 31 + value;
+    }
+  }
+  return sum;
+}
+
+} // namespace
+
+/// Fork-join tree seeded into the first worker only, others have to steal.
+/// Workers are threads here, state is in the shared mapping exactly as for
+/// processes.
+static void BM_WorkStealingPool_Tree(::benchmark::State& state) {
+  std::size_t const workers = state.range(0);
+
+  WorkStealingPool pool(
+      "bm", WorkStealingPool::CreationOptions{workers, 1024, kPayloads * kPayloadSize}, AnonymousMemorySource());
+  std::vector<WorkStealingPool::Worker> handles;
+  for (std::size_t i = 0; i < workers; ++i) {
+    handles.push_back(pool.createWorker(i));
+  }
+  auto arena = handles.front().arena();
+  for (std::size_t i = 0; i < arena.size(); ++i) {
+    arena[i] = std::byte(i);
+  }
+
+  std::vector<std::uint64_t> executed(workers, 0);
+  std::uint64_t stolen = 0;
+
+  for (auto _ : state) {
+    std::atomic<std::uint64_t> pending = 1;
+    (void)handles.front().push(WorkStealingTask{.offset = 0, .size = kPayloadSize, .arg = kDepth});
+
+    std::vector<std::thread> threads;
+    std::vector<std::uint64_t> steals(workers, 0);
+    for (std::size_t i = 0; i < workers; ++i) {
+      threads.emplace_back([&, i] {
+        auto& worker = handles[i];
+        WorkStealingTask task;
+        while (pending.load(std::memory_order_acquire) != 0) {
+          if (!worker.pop(task)) {
+            if (!worker.steal(task)) {
+              std::this_thread::yield();
+              continue;
+            }
+            ++steals[i];
+          }
+          ::benchmark::DoNotOptimize(execute(arena, task));
+          if (task.arg != 0) {
+            pending.fetch_add(2, std::memory_order_relaxed);
+            for (std::uint64_t child = 0; child < 2; ++child) {
+              std::uint64_t const offset = ((task.offset / kPayloadSize * 2 + child + 1) % kPayloads) * kPayloadSize;
+              WorkStealingTask next{.offset = offset, .size = kPayloadSize, .arg = task.arg - 1};
+              if (!worker.push(next)) [[unlikely]] {
+                // deque is full, run inline without spawning
+                ::benchmark::DoNotOptimize(execute(arena, next));
+                pending.fetch_sub(1, std::memory_order_relaxed);
+              }
+            }
+          }
+          ++executed[i];
+          pending.fetch_sub(1, std::memory_order_release);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto count : steals) {
+      stolen += count;
+    }
+  }
+
+  std::uint64_t total = 0;
+  for (auto count : executed) {
+    total += count;
+  }
+  state.SetItemsProcessed(std::int64_t(total));
+  state.counters["steals"] = ::benchmark::Counter(double(stolen), ::benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_WorkStealingPool_Tree)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+} // namespace turboq
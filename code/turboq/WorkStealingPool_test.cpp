@@ -0,0 +1,123 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "WorkStealingPool.h"
+
+namespace turboq::testing {
+
+TEST_CASE("WorkStealingPool: basic") {
+  WorkStealingPool pool("test", WorkStealingPool::CreationOptions{2, 3, 4096}, AnonymousMemorySource());
+
+  auto owner = pool.createWorker(0);
+  auto thief = pool.createWorker(1);
+  REQUIRE_THROWS(pool.createWorker(2));
+  REQUIRE(owner.index() == 0);
+  REQUIRE(thief.index() == 1);
+
+  // arena is shared between workers
+  REQUIRE(owner.arena().size() == 4096);
+  std::memcpy(owner.arena().data(), "payload", 7);
+  REQUIRE(std::memcmp(thief.arena().data(), "payload", 7) == 0);
+
+  WorkStealingTask task;
+  REQUIRE(!owner.next(task));
+  REQUIRE(!thief.steal(task));
+
+  // capacity rounded up to power of two
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    REQUIRE(owner.push(WorkStealingTask{.kind = 1, .offset = 0, .size = 7, .arg = i}));
+  }
+  REQUIRE(!owner.push(WorkStealingTask{}));
+  REQUIRE(owner.size() == 4);
+
+  // owner pops the newest, thief steals the oldest
+  REQUIRE(owner.pop(task));
+  REQUIRE(task.arg == 3);
+  REQUIRE(thief.steal(task));
+  REQUIRE(task.arg == 0);
+  REQUIRE(task.kind == 1);
+  REQUIRE(task.size == 7);
+  REQUIRE(thief.steal(task));
+  REQUIRE(task.arg == 1);
+  REQUIRE(owner.pop(task));
+  REQUIRE(task.arg == 2);
+  REQUIRE(!owner.pop(task));
+  REQUIRE(!thief.steal(task));
+  REQUIRE(owner.size() == 0);
+
+  // indices wrap around the ring
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    REQUIRE(owner.push(WorkStealingTask{.arg = i}));
+    REQUIRE(thief.next(task));
+    REQUIRE(task.arg == i);
+  }
+}
+
+TEST_CASE("WorkStealingPool: reopen") {
+  WorkStealingPool pool("test", WorkStealingPool::CreationOptions{1, 16}, AnonymousMemorySource());
+  {
+    auto worker = pool.createWorker(0);
+    REQUIRE(worker.push(WorkStealingTask{.arg = 42}));
+  }
+
+  // deque survives its owner
+  auto worker = pool.createWorker(0);
+  WorkStealingTask task;
+  REQUIRE(worker.pop(task));
+  REQUIRE(task.arg == 42);
+}
+
+TEST_CASE("WorkStealingPool: balance") {
+  constexpr std::size_t kWorkers = 4;
+  constexpr std::uint64_t kDepth = 14;
+
+  WorkStealingPool pool("test", WorkStealingPool::CreationOptions{kWorkers, 256}, AnonymousMemorySource());
+
+  // binary tree of tasks seeded into the first worker only
+  std::atomic<std::uint64_t> pending = 1;
+  std::vector<std::uint64_t> executed(kWorkers, 0);
+  {
+    auto seed = pool.createWorker(0);
+    REQUIRE(seed.push(WorkStealingTask{.arg = kDepth}));
+  }
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kWorkers; ++i) {
+    threads.emplace_back([&, i] {
+      auto worker = pool.createWorker(i);
+      WorkStealingTask task;
+      while (pending.load(std::memory_order_acquire) != 0) {
+        if (!worker.next(task)) {
+          std::this_thread::yield();
+          continue;
+        }
+        if (task.arg != 0) {
+          pending.fetch_add(2, std::memory_order_relaxed);
+          REQUIRE(worker.push(WorkStealingTask{.arg = task.arg - 1}));
+          REQUIRE(worker.push(WorkStealingTask{.arg = task.arg - 1}));
+        }
+        ++executed[i];
+        pending.fetch_sub(1, std::memory_order_release);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::uint64_t total = 0;
+  for (auto count : executed) {
+    total += count;
+  }
+  REQUIRE(total == (std::uint64_t(1) << (kDepth + 1)) - 1);
+}
+
+} // namespace turboq::testing
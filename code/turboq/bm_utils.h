@@ -0,0 +1,21 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace turboq {
+
+/// Return p-th percentile of sorted samples
+inline double percentile(std::vector<std::int64_t> const& samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  return double(samples[std::min(samples.size() - 1, std::size_t(double(samples.size()) * p))]);
+}
+
+} // namespace turboq
@@ -0,0 +1,319 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "capi.h"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <new>
+#include <string>
+#include <system_error>
+
+#include <turboq/BoundedMPSCRawQueue.h>
+#include <turboq/BoundedSPMCRawQueue.h>
+#include <turboq/BoundedSPSCRawQueue.h>
+
+struct turboq_spsc_queue {
+  turboq::BoundedSPSCRawQueue queue;
+};
+
+struct turboq_spsc_producer {
+  turboq::BoundedSPSCRawQueue::Producer producer;
+};
+
+struct turboq_spsc_consumer {
+  turboq::BoundedSPSCRawQueue::Consumer consumer;
+};
+
+struct turboq_mpsc_queue {
+  turboq::BoundedMPSCRawQueue queue;
+};
+
+struct turboq_mpsc_producer {
+  turboq::BoundedMPSCRawQueue::Producer producer;
+};
+
+struct turboq_mpsc_consumer {
+  turboq::BoundedMPSCRawQueue::Consumer consumer;
+};
+
+struct turboq_spmc_queue {
+  turboq::BoundedSPMCRawQueue queue;
+};
+
+struct turboq_spmc_producer {
+  turboq::BoundedSPMCRawQueue::Producer producer;
+};
+
+struct turboq_spmc_consumer {
+  turboq::BoundedSPMCRawQueue::Consumer consumer;
+};
+
+namespace {
+
+/// ABI version
+constexpr unsigned kAbiVersion = 1;
+
+static_assert(TURBOQ_SPSC_EPOCH_MASK ==
+              turboq::detail::BoundedSPSCRawQueueDetail<turboq::BoundedSPSCRawQueueDefaultTraits>::kEpochMask);
+
+thread_local std::string lastError;
+
+/// Return memory source for directory path, /dev/shm in case of nullptr
+turboq::Result<turboq::DefaultMemorySource> memorySource(char const* path) noexcept {
+  if (path == nullptr) {
+    return turboq::DefaultMemorySource();
+  }
+  // checked here, so the constructor doesn't fail
+  std::error_code ec;
+  if (!std::filesystem::is_directory(path, ec)) {
+    return turboq::makePosixErrorCode(ec ? ec.value() : ENOENT);
+  }
+  return turboq::DefaultMemorySource(path, std::size_t(::sysconf(_SC_PAGESIZE)));
+}
+
+/// Return new handle holding result value, error is stored as the last error
+/// and reported as nullptr
+template <typename Handle, typename T>
+Handle* makeHandle(turboq::Result<T>&& result) noexcept {
+  if (!result) {
+    lastError = result.error().message();
+    return nullptr;
+  }
+  auto handle = new (std::nothrow) Handle{std::move(result).value()};
+  if (handle == nullptr) {
+    lastError = "out of memory";
+  }
+  return handle;
+}
+
+/// Return new queue handle, fn(memorySource) returns the queue result
+template <typename Handle, typename Fn>
+Handle* makeQueue(char const* path, Fn&& fn) noexcept {
+  auto source = memorySource(path);
+  if (!source) {
+    lastError = source.error().message();
+    return nullptr;
+  }
+  return makeHandle<Handle>(fn(source.value()));
+}
+
+/// Return message payload pointer and size or nullptr in case of no data
+template <typename Consumer>
+TURBOQ_FORCE_INLINE void const* fetch(Consumer& consumer, std::size_t* size) noexcept {
+  auto buffer = consumer.fetch();
+  if (buffer.empty()) {
+    return nullptr;
+  }
+  *size = buffer.size();
+  return buffer.data();
+}
+
+} // namespace
+
+extern "C" {
+
+unsigned turboq_abi_version(void) {
+  return kAbiVersion;
+}
+
+char const* turboq_last_error(void) {
+  return lastError.c_str();
+}
+
+/* SPSC queue */
+
+turboq_spsc_queue* turboq_spsc_create(char const* name, size_t capacity_hint, char const* path) {
+  return makeQueue<turboq_spsc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedSPSCRawQueue::create(name, {capacity_hint}, source);
+  });
+}
+
+turboq_spsc_queue* turboq_spsc_open(char const* name, char const* path) {
+  return makeQueue<turboq_spsc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedSPSCRawQueue::open(name, source);
+  });
+}
+
+void turboq_spsc_close(turboq_spsc_queue* queue) {
+  delete queue;
+}
+
+turboq_spsc_producer* turboq_spsc_create_producer(turboq_spsc_queue* queue) {
+  return makeHandle<turboq_spsc_producer>(queue->queue.tryCreateProducer());
+}
+
+void turboq_spsc_destroy_producer(turboq_spsc_producer* producer) {
+  delete producer;
+}
+
+void* turboq_spsc_prepare(turboq_spsc_producer* producer, size_t size) {
+  auto buffer = producer->producer.prepare(size);
+  return buffer.empty() ? nullptr : buffer.data();
+}
+
+void turboq_spsc_commit(turboq_spsc_producer* producer) {
+  producer->producer.commit();
+}
+
+int turboq_spsc_commit_size(turboq_spsc_producer* producer, size_t size) {
+  if (auto const result = producer->producer.tryCommit(size); !result) {
+    lastError = result.error().message();
+    return -1;
+  }
+  return 0;
+}
+
+void turboq_spsc_abort(turboq_spsc_producer* producer) {
+  producer->producer.abort();
+}
+
+turboq_spsc_consumer* turboq_spsc_create_consumer(turboq_spsc_queue* queue) {
+  return makeHandle<turboq_spsc_consumer>(queue->queue.tryCreateConsumer());
+}
+
+void turboq_spsc_destroy_consumer(turboq_spsc_consumer* consumer) {
+  delete consumer;
+}
+
+turboq_positions turboq_spsc_consumer_positions(turboq_spsc_consumer const* consumer) {
+  return {consumer->consumer.producerPosition(), consumer->consumer.consumerPosition()};
+}
+
+void const* turboq_spsc_fetch(turboq_spsc_consumer* consumer, size_t* size) {
+  return fetch(consumer->consumer, size);
+}
+
+void turboq_spsc_consume(turboq_spsc_consumer* consumer) {
+  consumer->consumer.consume();
+}
+
+/* MPSC queue */
+
+turboq_mpsc_queue* turboq_mpsc_create(
+    char const* name, size_t max_message_size_hint, size_t length_hint, char const* path) {
+  return makeQueue<turboq_mpsc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedMPSCRawQueue::create(name, {max_message_size_hint, length_hint}, source);
+  });
+}
+
+turboq_mpsc_queue* turboq_mpsc_open(char const* name, char const* path) {
+  return makeQueue<turboq_mpsc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedMPSCRawQueue::open(name, source);
+  });
+}
+
+void turboq_mpsc_close(turboq_mpsc_queue* queue) {
+  delete queue;
+}
+
+turboq_mpsc_producer* turboq_mpsc_create_producer(turboq_mpsc_queue* queue) {
+  return makeHandle<turboq_mpsc_producer>(queue->queue.tryCreateProducer());
+}
+
+void turboq_mpsc_destroy_producer(turboq_mpsc_producer* producer) {
+  delete producer;
+}
+
+void* turboq_mpsc_prepare(turboq_mpsc_producer* producer, size_t size) {
+  auto const result = producer->producer.tryPrepare(size);
+  if (!result) [[unlikely]] {
+    lastError = result.error().message();
+    return nullptr;
+  }
+  return result.value().empty() ? nullptr : result.value().data();
+}
+
+void turboq_mpsc_commit(turboq_mpsc_producer* producer) {
+  producer->producer.commit();
+}
+
+void turboq_mpsc_abort(turboq_mpsc_producer* producer) {
+  producer->producer.abort();
+}
+
+turboq_mpsc_consumer* turboq_mpsc_create_consumer(turboq_mpsc_queue* queue) {
+  return makeHandle<turboq_mpsc_consumer>(queue->queue.tryCreateConsumer());
+}
+
+void turboq_mpsc_destroy_consumer(turboq_mpsc_consumer* consumer) {
+  delete consumer;
+}
+
+turboq_positions turboq_mpsc_consumer_positions(turboq_mpsc_consumer const* consumer) {
+  return {consumer->consumer.producerPosition(), consumer->consumer.consumerPosition()};
+}
+
+void const* turboq_mpsc_fetch(turboq_mpsc_consumer* consumer, size_t* size) {
+  return fetch(consumer->consumer, size);
+}
+
+void turboq_mpsc_consume(turboq_mpsc_consumer* consumer) {
+  consumer->consumer.consume();
+}
+
+/* SPMC queue */
+
+turboq_spmc_queue* turboq_spmc_create(char const* name, size_t capacity_hint, char const* path) {
+  return makeQueue<turboq_spmc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedSPMCRawQueue::create(name, {capacity_hint}, source);
+  });
+}
+
+turboq_spmc_queue* turboq_spmc_open(char const* name, char const* path) {
+  return makeQueue<turboq_spmc_queue>(path, [&](auto const& source) {
+    return turboq::BoundedSPMCRawQueue::open(name, source);
+  });
+}
+
+void turboq_spmc_close(turboq_spmc_queue* queue) {
+  delete queue;
+}
+
+turboq_spmc_producer* turboq_spmc_create_producer(turboq_spmc_queue* queue) {
+  return makeHandle<turboq_spmc_producer>(queue->queue.tryCreateProducer());
+}
+
+void turboq_spmc_destroy_producer(turboq_spmc_producer* producer) {
+  delete producer;
+}
+
+void* turboq_spmc_prepare(turboq_spmc_producer* producer, size_t size) {
+  auto buffer = producer->producer.prepare(size);
+  return buffer.empty() ? nullptr : buffer.data();
+}
+
+void turboq_spmc_commit(turboq_spmc_producer* producer) {
+  producer->producer.commit();
+}
+
+turboq_spmc_consumer* turboq_spmc_create_consumer(turboq_spmc_queue* queue) {
+  return makeHandle<turboq_spmc_consumer>(queue->queue.tryCreateConsumer());
+}
+
+void turboq_spmc_destroy_consumer(turboq_spmc_consumer* consumer) {
+  delete consumer;
+}
+
+turboq_positions turboq_spmc_consumer_positions(turboq_spmc_consumer const* consumer) {
+  return {consumer->consumer.producerPosition(), nullptr};
+}
+
+void const* turboq_spmc_fetch(turboq_spmc_consumer* consumer, size_t* size) {
+  return fetch(consumer->consumer, size);
+}
+
+void turboq_spmc_consume(turboq_spmc_consumer* consumer) {
+  consumer->consumer.consume();
+}
+
+int turboq_spmc_lapped(turboq_spmc_consumer const* consumer) {
+  return consumer->consumer.lapped() ? 1 : 0;
+}
+
+void turboq_spmc_reset(turboq_spmc_consumer* consumer) {
+  consumer->consumer.reset();
+}
+
+} // extern "C"
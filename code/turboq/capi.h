@@ -0,0 +1,137 @@
+/* Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+ * SPDX-License-Identifier: AGPL-3.0
+ */
+
+#ifndef TURBOQ_CAPI_H
+#define TURBOQ_CAPI_H
+
+/* Stable C ABI over queues with default traits for non-C++ clients.
+ *
+ * - Handles are opaque and allocated once on create/open, hot path calls
+ *   (prepare/commit/fetch/consume) never allocate and never throw.
+ * - Functions returning handle return NULL on error, turboq_last_error()
+ *   describes the error of the last failed call on the calling thread.
+ * - Memory source: path is a directory for queue files, NULL for /dev/shm.
+ * - Queues created through the ABI are binary compatible with C++ queues
+ *   using default traits (BoundedSPSCRawQueue, BoundedMPSCRawQueue,
+ *   BoundedSPMCRawQueue).
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct turboq_spsc_queue turboq_spsc_queue;
+typedef struct turboq_spsc_producer turboq_spsc_producer;
+typedef struct turboq_spsc_consumer turboq_spsc_consumer;
+
+typedef struct turboq_mpsc_queue turboq_mpsc_queue;
+typedef struct turboq_mpsc_producer turboq_mpsc_producer;
+typedef struct turboq_mpsc_consumer turboq_mpsc_consumer;
+
+typedef struct turboq_spmc_queue turboq_spmc_queue;
+typedef struct turboq_spmc_producer turboq_spmc_producer;
+typedef struct turboq_spmc_consumer turboq_spmc_consumer;
+
+/* Shared position words of a queue. Producer position changes whenever new
+ * messages could be fetched, so clients poll it inline and call fetch only
+ * after it moved. consumer is NULL for queues without shared consumer position.
+ */
+typedef struct turboq_positions {
+  size_t const* producer;
+  size_t const* consumer;
+} turboq_positions;
+
+/* Load position word with acquire semantics */
+static inline size_t turboq_load_position(size_t const* position) {
+  return __atomic_load_n(position, __ATOMIC_ACQUIRE);
+}
+
+/* SPSC consumer position word keeps the consumer ownership epoch (changed on
+ * takeover) in the low bits, positions are multiple of 128 bytes.
+ */
+#define TURBOQ_SPSC_EPOCH_MASK ((size_t)127)
+
+/* Load SPSC consumer position word with acquire semantics, epoch cleared */
+static inline size_t turboq_spsc_load_consumer_position(size_t const* position) {
+  return turboq_load_position(position) & ~TURBOQ_SPSC_EPOCH_MASK;
+}
+
+/* Return ABI version, incremented on incompatible changes */
+unsigned turboq_abi_version(void);
+
+/* Return description of the last error on the calling thread */
+char const* turboq_last_error(void);
+
+/* SPSC queue */
+
+turboq_spsc_queue* turboq_spsc_create(char const* name, size_t capacity_hint, char const* path);
+turboq_spsc_queue* turboq_spsc_open(char const* name, char const* path);
+void turboq_spsc_close(turboq_spsc_queue* queue);
+
+turboq_spsc_producer* turboq_spsc_create_producer(turboq_spsc_queue* queue);
+void turboq_spsc_destroy_producer(turboq_spsc_producer* producer);
+/* Return buffer of size bytes or NULL in case of queue is full */
+void* turboq_spsc_prepare(turboq_spsc_producer* producer, size_t size);
+void turboq_spsc_commit(turboq_spsc_producer* producer);
+/* Commit with size not greater than reserved one. Return 0 on success, -1 on error */
+int turboq_spsc_commit_size(turboq_spsc_producer* producer, size_t size);
+void turboq_spsc_abort(turboq_spsc_producer* producer);
+
+turboq_spsc_consumer* turboq_spsc_create_consumer(turboq_spsc_queue* queue);
+void turboq_spsc_destroy_consumer(turboq_spsc_consumer* consumer);
+/* Use turboq_spsc_load_consumer_position() for the consumer position */
+turboq_positions turboq_spsc_consumer_positions(turboq_spsc_consumer const* consumer);
+/* Return next message and its size or NULL in case of no data */
+void const* turboq_spsc_fetch(turboq_spsc_consumer* consumer, size_t* size);
+void turboq_spsc_consume(turboq_spsc_consumer* consumer);
+
+/* MPSC queue */
+
+turboq_mpsc_queue* turboq_mpsc_create(
+    char const* name, size_t max_message_size_hint, size_t length_hint, char const* path);
+turboq_mpsc_queue* turboq_mpsc_open(char const* name, char const* path);
+void turboq_mpsc_close(turboq_mpsc_queue* queue);
+
+turboq_mpsc_producer* turboq_mpsc_create_producer(turboq_mpsc_queue* queue);
+void turboq_mpsc_destroy_producer(turboq_mpsc_producer* producer);
+/* Return buffer of size bytes or NULL in case of queue is full or size
+ * exceeds max message size */
+void* turboq_mpsc_prepare(turboq_mpsc_producer* producer, size_t size);
+void turboq_mpsc_commit(turboq_mpsc_producer* producer);
+void turboq_mpsc_abort(turboq_mpsc_producer* producer);
+
+turboq_mpsc_consumer* turboq_mpsc_create_consumer(turboq_mpsc_queue* queue);
+void turboq_mpsc_destroy_consumer(turboq_mpsc_consumer* consumer);
+turboq_positions turboq_mpsc_consumer_positions(turboq_mpsc_consumer const* consumer);
+void const* turboq_mpsc_fetch(turboq_mpsc_consumer* consumer, size_t* size);
+void turboq_mpsc_consume(turboq_mpsc_consumer* consumer);
+
+/* SPMC queue */
+
+turboq_spmc_queue* turboq_spmc_create(char const* name, size_t capacity_hint, char const* path);
+turboq_spmc_queue* turboq_spmc_open(char const* name, char const* path);
+void turboq_spmc_close(turboq_spmc_queue* queue);
+
+turboq_spmc_producer* turboq_spmc_create_producer(turboq_spmc_queue* queue);
+void turboq_spmc_destroy_producer(turboq_spmc_producer* producer);
+void* turboq_spmc_prepare(turboq_spmc_producer* producer, size_t size);
+void turboq_spmc_commit(turboq_spmc_producer* producer);
+
+turboq_spmc_consumer* turboq_spmc_create_consumer(turboq_spmc_queue* queue);
+void turboq_spmc_destroy_consumer(turboq_spmc_consumer* consumer);
+turboq_positions turboq_spmc_consumer_positions(turboq_spmc_consumer const* consumer);
+void const* turboq_spmc_fetch(turboq_spmc_consumer* consumer, size_t* size);
+void turboq_spmc_consume(turboq_spmc_consumer* consumer);
+/* Return non zero in case of producer overwrote the fetched message, consumer
+ * must reset then */
+int turboq_spmc_lapped(turboq_spmc_consumer const* consumer);
+void turboq_spmc_reset(turboq_spmc_consumer* consumer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURBOQ_CAPI_H */
@@ -0,0 +1,110 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include <benchmark/benchmark.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "capi.h"
+#include "utils.h"
+
+namespace turboq {
+namespace {
+
+/// SPSC queue with producer and consumer opened through C ABI
+struct CQueue {
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  turboq_spsc_queue* queue = nullptr;
+  turboq_spsc_producer* producer = nullptr;
+  turboq_spsc_consumer* consumer = nullptr;
+
+  CQueue() {
+    std::filesystem::remove(path / "turboq-capi-bm");
+    queue = turboq_spsc_create("turboq-capi-bm", 1 << 20, path.c_str());
+    producer = turboq_spsc_create_producer(queue);
+    consumer = turboq_spsc_create_consumer(queue);
+  }
+
+  ~CQueue() {
+    turboq_spsc_destroy_consumer(consumer);
+    turboq_spsc_destroy_producer(producer);
+    turboq_spsc_close(queue);
+    std::filesystem::remove(path / "turboq-capi-bm");
+  }
+};
+
+} // namespace
+
+/// Enqueue and dequeue through C++ API (baseline)
+static void BM_CApi_EnqueueDequeue_Cxx(::benchmark::State& state) {
+  auto queue = BoundedSPSCRawQueue("bm", {std::size_t(1) << 20}, AnonymousMemorySource());
+  auto producer = queue.createProducer();
+  auto consumer = queue.createConsumer();
+
+  std::uint64_t counter = 0;
+  std::uint64_t value = 0;
+
+  for (auto _ : state) {
+    while (!enqueue(producer, counter++)) {}
+    while (!dequeue(consumer, value)) {}
+    ::benchmark::DoNotOptimize(value);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Enqueue and dequeue through C ABI (four calls per message)
+static void BM_CApi_EnqueueDequeue_C(::benchmark::State& state) {
+  CQueue queue;
+
+  std::uint64_t counter = 0;
+  std::uint64_t value = 0;
+  std::size_t size = 0;
+
+  for (auto _ : state) {
+    void* buffer;
+    while ((buffer = turboq_spsc_prepare(queue.producer, sizeof(counter))) == nullptr) {}
+    std::memcpy(buffer, &counter, sizeof(counter));
+    turboq_spsc_commit(queue.producer);
+    ++counter;
+
+    void const* data;
+    while ((data = turboq_spsc_fetch(queue.consumer, &size)) == nullptr) {}
+    std::memcpy(&value, data, sizeof(value));
+    turboq_spsc_consume(queue.consumer);
+    ::benchmark::DoNotOptimize(value);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Poll empty queue with fetch() call
+static void BM_CApi_PollEmpty_Fetch(::benchmark::State& state) {
+  CQueue queue;
+  std::size_t size = 0;
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(turboq_spsc_fetch(queue.consumer, &size));
+  }
+}
+
+/// Poll empty queue with inline load of the shared producer position
+static void BM_CApi_PollEmpty_Position(::benchmark::State& state) {
+  CQueue queue;
+  auto const positions = turboq_spsc_consumer_positions(queue.consumer);
+  std::size_t const seen = turboq_load_position(positions.producer);
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(turboq_load_position(positions.producer) != seen);
+  }
+}
+
+BENCHMARK(BM_CApi_EnqueueDequeue_Cxx);
+BENCHMARK(BM_CApi_EnqueueDequeue_C);
+BENCHMARK(BM_CApi_PollEmpty_Fetch);
+BENCHMARK(BM_CApi_PollEmpty_Position);
+
+} // namespace turboq
@@ -0,0 +1,242 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <boost/scope_exit.hpp>
+#include <doctest/doctest.h>
+
+#include "BoundedSPSCRawQueue.h"
+#include "capi.h"
+#include "utils.h"
+
+namespace turboq::testing {
+
+TEST_CASE("capi: spsc") {
+  auto const path = std::filesystem::temp_directory_path();
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-capi");
+  };
+
+  REQUIRE(turboq_abi_version() == 1);
+  REQUIRE(turboq_spsc_open("turboq-capi", path.c_str()) == nullptr);
+  REQUIRE(std::string_view(turboq_last_error()) == "failed to open memory source");
+
+  auto queue = turboq_spsc_create("turboq-capi", 4096, path.c_str());
+  REQUIRE(queue != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_close(queue);
+  };
+
+  auto producer = turboq_spsc_create_producer(queue);
+  REQUIRE(producer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_destroy_producer(producer);
+  };
+
+  auto other = turboq_spsc_open("turboq-capi", path.c_str());
+  REQUIRE(other != nullptr);
+  turboq_spsc_close(other);
+
+  auto consumer = turboq_spsc_create_consumer(queue);
+  REQUIRE(consumer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_destroy_consumer(consumer);
+  };
+
+  // tap follows the producer, create it before the first message
+  BoundedSPSCRawQueue cxxQueue("turboq-capi", DefaultMemorySource(path, 4096));
+  auto cxxTap = cxxQueue.createTap();
+
+  auto const positions = turboq_spsc_consumer_positions(consumer);
+  REQUIRE(turboq_load_position(positions.producer) == turboq_spsc_load_consumer_position(positions.consumer));
+
+  std::size_t size = 0;
+  REQUIRE(turboq_spsc_fetch(consumer, &size) == nullptr);
+
+  auto buffer = turboq_spsc_prepare(producer, 16);
+  REQUIRE(buffer != nullptr);
+  std::memcpy(buffer, "hello", 5);
+  REQUIRE(turboq_spsc_commit_size(producer, 1000) == -1);
+  REQUIRE(turboq_spsc_commit_size(producer, 5) == 0);
+  REQUIRE(turboq_load_position(positions.producer) != turboq_spsc_load_consumer_position(positions.consumer));
+
+  REQUIRE(turboq_spsc_prepare(producer, 8) != nullptr);
+  turboq_spsc_abort(producer);
+
+  // C++ tap of the same queue sees the same message
+  auto cxxBuffer = cxxTap.fetch();
+  REQUIRE(std::string_view(std::bit_cast<char const*>(cxxBuffer.data()), cxxBuffer.size()) == "hello");
+
+  auto data = turboq_spsc_fetch(consumer, &size);
+  REQUIRE(data != nullptr);
+  REQUIRE(std::string_view(static_cast<char const*>(data), size) == "hello");
+  turboq_spsc_consume(consumer);
+  REQUIRE(turboq_spsc_fetch(consumer, &size) == nullptr);
+  REQUIRE(turboq_load_position(positions.producer) == turboq_spsc_load_consumer_position(positions.consumer));
+
+  // fill the queue
+  std::size_t count = 0;
+  while (turboq_spsc_prepare(producer, 64) != nullptr) {
+    turboq_spsc_commit(producer);
+    ++count;
+  }
+  REQUIRE(count > 0);
+  while (turboq_spsc_fetch(consumer, &size) != nullptr) {
+    REQUIRE(size == 64);
+    turboq_spsc_consume(consumer);
+    --count;
+  }
+  REQUIRE(count == 0);
+}
+
+TEST_CASE("capi: spsc takeover") {
+  auto const path = std::filesystem::temp_directory_path();
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-capi");
+  };
+
+  auto queue = turboq_spsc_create("turboq-capi", 4096, path.c_str());
+  REQUIRE(queue != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_close(queue);
+  };
+
+  auto producer = turboq_spsc_create_producer(queue);
+  REQUIRE(producer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_destroy_producer(producer);
+  };
+
+  // standby consumer in C++ takes over the vacant consumer role
+  BoundedSPSCRawQueue cxxQueue("turboq-capi", DefaultMemorySource(path, 4096));
+  auto cxxConsumer = cxxQueue.tryTakeOverConsumer(std::chrono::milliseconds(1));
+  REQUIRE(cxxConsumer);
+
+  REQUIRE(turboq_spsc_prepare(producer, 16) != nullptr);
+  turboq_spsc_commit(producer);
+  REQUIRE(!cxxConsumer.fetch().empty());
+  cxxConsumer.consume();
+
+  auto consumer = turboq_spsc_create_consumer(queue);
+  REQUIRE(consumer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spsc_destroy_consumer(consumer);
+  };
+
+  auto const positions = turboq_spsc_consumer_positions(consumer);
+  auto const producerPosition = turboq_load_position(positions.producer);
+  REQUIRE(producerPosition != 0);
+  REQUIRE(turboq_load_position(positions.consumer) != producerPosition);
+  REQUIRE(turboq_spsc_load_consumer_position(positions.consumer) == producerPosition);
+}
+
+TEST_CASE("capi: mpsc") {
+  auto const path = std::filesystem::temp_directory_path();
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-capi");
+  };
+
+  auto queue = turboq_mpsc_create("turboq-capi", 64, 16, path.c_str());
+  REQUIRE(queue != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_mpsc_close(queue);
+  };
+
+  auto producer1 = turboq_mpsc_create_producer(queue);
+  auto producer2 = turboq_mpsc_create_producer(queue);
+  auto consumer = turboq_mpsc_create_consumer(queue);
+  REQUIRE(producer1 != nullptr);
+  REQUIRE(producer2 != nullptr);
+  REQUIRE(consumer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_mpsc_destroy_producer(producer1);
+    turboq_mpsc_destroy_producer(producer2);
+    turboq_mpsc_destroy_consumer(consumer);
+  };
+
+  REQUIRE(turboq_mpsc_prepare(producer1, 1000) == nullptr);
+  REQUIRE(std::string_view(turboq_last_error()) == "buffer exceed max message size");
+
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    auto producer = (i % 2 == 0) ? producer1 : producer2;
+    auto buffer = turboq_mpsc_prepare(producer, sizeof(i));
+    REQUIRE(buffer != nullptr);
+    std::memcpy(buffer, &i, sizeof(i));
+    turboq_mpsc_commit(producer);
+  }
+  REQUIRE(turboq_mpsc_prepare(producer2, 8) != nullptr);
+  turboq_mpsc_abort(producer2);
+
+  auto const positions = turboq_mpsc_consumer_positions(consumer);
+  REQUIRE(turboq_load_position(positions.producer) - turboq_load_position(positions.consumer) == 5);
+
+  std::size_t size = 0;
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    auto data = turboq_mpsc_fetch(consumer, &size);
+    REQUIRE(data != nullptr);
+    REQUIRE(size == sizeof(i));
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    REQUIRE(value == i);
+    turboq_mpsc_consume(consumer);
+  }
+  REQUIRE(turboq_mpsc_fetch(consumer, &size) == nullptr);
+}
+
+TEST_CASE("capi: spmc") {
+  auto const path = std::filesystem::temp_directory_path();
+  BOOST_SCOPE_EXIT_ALL(&) {
+    std::filesystem::remove(path / "turboq-capi");
+  };
+
+  auto queue = turboq_spmc_create("turboq-capi", 4096, path.c_str());
+  REQUIRE(queue != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spmc_close(queue);
+  };
+
+  auto producer = turboq_spmc_create_producer(queue);
+  auto consumer = turboq_spmc_create_consumer(queue);
+  REQUIRE(producer != nullptr);
+  REQUIRE(consumer != nullptr);
+  BOOST_SCOPE_EXIT_ALL(&) {
+    turboq_spmc_destroy_producer(producer);
+    turboq_spmc_destroy_consumer(consumer);
+  };
+
+  auto const positions = turboq_spmc_consumer_positions(consumer);
+  REQUIRE(positions.consumer == nullptr);
+  auto const start = turboq_load_position(positions.producer);
+
+  auto buffer = turboq_spmc_prepare(producer, 3);
+  REQUIRE(buffer != nullptr);
+  std::memcpy(buffer, "abc", 3);
+  turboq_spmc_commit(producer);
+  REQUIRE(turboq_load_position(positions.producer) != start);
+
+  std::size_t size = 0;
+  auto data = turboq_spmc_fetch(consumer, &size);
+  REQUIRE(data != nullptr);
+  REQUIRE(std::string_view(static_cast<char const*>(data), size) == "abc");
+  REQUIRE(turboq_spmc_lapped(consumer) == 0);
+  turboq_spmc_consume(consumer);
+  REQUIRE(turboq_spmc_fetch(consumer, &size) == nullptr);
+
+  // producer never waits, slow consumer is lapped
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(turboq_spmc_prepare(producer, 64) != nullptr);
+    turboq_spmc_commit(producer);
+  }
+  REQUIRE(turboq_spmc_lapped(consumer) != 0);
+  turboq_spmc_reset(consumer);
+  REQUIRE(turboq_spmc_lapped(consumer) == 0);
+  REQUIRE(turboq_spmc_fetch(consumer, &size) == nullptr);
+}
+
+} // namespace turboq::testing
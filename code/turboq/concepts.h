@@ -17,6 +17,21 @@ concept Producer = requires(T obj, std::size_t size) {
   { obj.commit(size) } -> std::same_as<void>;
 };
 
+/// Checks T is Producer type able to grow reserved buffer
+template <typename T>
+concept GrowableProducer = Producer<T> && requires(T obj, std::size_t size) {
+  { obj.extend(size) } -> std::same_as<std::span<std::byte>>;
+};
+
+/// Checks T is Producer type able to reserve and commit buffers in batches
+template <typename T>
+concept BatchProducer =
+    Producer<T> && requires(T obj, std::size_t size, std::span<std::span<std::byte>> buffers,
+                       std::span<std::size_t const> sizes) {
+      { obj.prepareBatch(size, buffers) } -> std::same_as<std::size_t>;
+      { obj.commitBatch(sizes) } -> std::same_as<void>;
+    };
+
 /// Checks T is Consumer type
 template <typename T>
 concept Consumer = requires(T obj) {
@@ -25,4 +40,12 @@ concept Consumer = requires(T obj) {
   { obj.reset() } -> std::same_as<void>;
 };
 
+/// Checks T is Consumer type able to fetch and consume buffers in batches
+template <typename T>
+concept BatchConsumer =
+    Consumer<T> && requires(T obj, std::size_t count, std::span<std::span<std::byte const>> buffers) {
+      { obj.fetchBatch(buffers) } -> std::same_as<std::size_t>;
+      { obj.consumeBatch(count) } -> std::same_as<void>;
+    };
+
 } // namespace turboq
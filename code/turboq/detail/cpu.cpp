@@ -0,0 +1,44 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "cpu.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <boost/scope_exit.hpp>
+
+namespace turboq::detail {
+namespace {
+
+std::size_t readCacheLineSize() noexcept {
+  if (auto handle = ::fopen("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", "r")) {
+    BOOST_SCOPE_EXIT_ALL(&) {
+      ::fclose(handle);
+    };
+    if (unsigned long value = 0; ::fscanf(handle, "%lu", &value) == 1 && value != 0) {
+      return value;
+    }
+  }
+#ifdef _SC_LEVEL1_DCACHE_LINESIZE
+  if (long const value = ::sysconf(_SC_LEVEL1_DCACHE_LINESIZE); value > 0) {
+    return static_cast<std::size_t>(value);
+  }
+#endif
+  return 0;
+}
+
+} // namespace
+
+std::size_t cacheLineSize() noexcept {
+  static std::size_t const size = readCacheLineSize();
+  return size;
+}
+
+bool isCacheLineAligned(std::size_t align) noexcept {
+  std::size_t const size = cacheLineSize();
+  return size == 0 || align % size == 0;
+}
+
+} // namespace turboq::detail
@@ -0,0 +1,39 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <turboq/platform.h>
+
+namespace turboq::detail {
+
+/// Return L1 data cache line size of the running CPU (sysfs, then sysconf).
+/// Return 0 in case of size is unknown.
+[[nodiscard]] std::size_t cacheLineSize() noexcept;
+
+/// Return true in case of align keeps hot fields of the running CPU on separate cache lines
+[[nodiscard]] bool isCacheLineAligned(std::size_t align) noexcept;
+
+/// Return time stamp counter (TSC on x86, virtual counter on ARM64,
+/// steady clock nanoseconds elsewhere). Not serializing.
+[[nodiscard]] TURBOQ_FORCE_INLINE std::uint64_t readTsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace turboq::detail
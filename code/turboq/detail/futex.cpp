@@ -0,0 +1,33 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#include "futex.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+
+namespace turboq::detail {
+
+bool futexWait(std::uint32_t* addr, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept {
+  ::timespec ts;
+  ::timespec* tsp = nullptr;
+  if (timeout != std::chrono::nanoseconds::max()) {
+    auto const secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    ts.tv_sec = secs.count();
+    ts.tv_nsec = (timeout - secs).count();
+    tsp = &ts;
+  }
+  // not FUTEX_PRIVATE_FLAG: the word lives in memory shared between processes
+  long const rc = ::syscall(SYS_futex, addr, FUTEX_WAIT, expected, tsp, nullptr, 0);
+  return rc == 0 || errno != ETIMEDOUT;
+}
+
+void futexWake(std::uint32_t* addr, int count) noexcept {
+  ::syscall(SYS_futex, addr, FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+} // namespace turboq::detail
@@ -0,0 +1,18 @@
+// Copyright (c) Sergey Kovalevich <inndie@gmail.com>
+// SPDX-License-Identifier: AGPL-3.0
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace turboq::detail {
+
+/// Sleep while *addr equals expected (process-shared futex).
+/// Return false on timeout.
+bool futexWait(std::uint32_t* addr, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept;
+
+/// Wake up to count waiters sleeping on addr
+void futexWake(std::uint32_t* addr, int count) noexcept;
+
+} // namespace turboq::detail
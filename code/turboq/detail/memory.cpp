@@ -5,20 +5,101 @@
 
 #include <sys/mman.h>
 
+#include <bit>
+#include <cstdint>
 #include <system_error>
+#include <utility>
+
+#include <turboq/detail/math.h>
 
 namespace turboq::detail {
 
-MappedRegion mapFile(File const& file, std::size_t fileSize) {
+Result<MappedRegion> tryMapFile(File const& file, std::size_t fileSize) noexcept {
   auto region = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file.get(), 0);
   if (region == MAP_FAILED) {
-    throw std::system_error(errno, getPosixErrorCategory(), "mmap(...)");
+    return makePosixErrorCode(errno);
   }
   return MappedRegion(static_cast<std::byte*>(region), fileSize);
 }
 
+Result<MappedRegion> tryMapFile(File const& file) noexcept {
+  auto const fileSize = file.tryGetFileSize();
+  if (!fileSize) {
+    return failure(fileSize.error());
+  }
+  return tryMapFile(file, fileSize.value());
+}
+
+Result<MappedRegion> tryMapFileReadOnly(File const& file) noexcept {
+  auto const fileSize = file.tryGetFileSize();
+  if (!fileSize) {
+    return failure(fileSize.error());
+  }
+  auto region = ::mmap(nullptr, fileSize.value(), PROT_READ, MAP_SHARED | MAP_POPULATE, file.get(), 0);
+  if (region == MAP_FAILED) {
+    return makePosixErrorCode(errno);
+  }
+  return MappedRegion(static_cast<std::byte*>(region), fileSize.value());
+}
+
+Result<MappedRegion> tryMapFileMirrored(File const& file, std::size_t headerSize, std::size_t dataSize) noexcept {
+  std::size_t const size = headerSize + 2 * dataSize;
+
+  // reserve address space, fixed mappings must be aligned to the file page size
+  auto reserved = ::mmap(nullptr, size + headerSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserved == MAP_FAILED) {
+    return makePosixErrorCode(errno);
+  }
+  auto const start = std::bit_cast<std::uintptr_t>(reserved);
+  auto const aligned = align_up(start, std::uintptr_t(headerSize));
+  if (aligned != start) {
+    ::munmap(reserved, aligned - start);
+  }
+  if (auto const tail = start + headerSize - aligned; tail != 0) {
+    ::munmap(std::bit_cast<void*>(aligned + size), tail);
+  }
+
+  // unmaps the whole range on error
+  MappedRegion region(std::bit_cast<std::byte*>(aligned), size);
+
+  auto const flags = MAP_SHARED | MAP_FIXED | MAP_POPULATE;
+  if (::mmap(region.data(), headerSize + dataSize, PROT_READ | PROT_WRITE, flags, file.get(), 0) == MAP_FAILED) {
+    return makePosixErrorCode(errno);
+  }
+  if (::mmap(region.data() + headerSize + dataSize, dataSize, PROT_READ | PROT_WRITE, flags, file.get(),
+          off_t(headerSize)) == MAP_FAILED) {
+    return makePosixErrorCode(errno);
+  }
+
+  return region;
+}
+
+MappedRegion mapFile(File const& file, std::size_t fileSize) {
+  auto region = tryMapFile(file, fileSize);
+  if (!region) {
+    throwError(region.error(), "mmap(...)");
+  }
+  return std::move(region).value();
+}
+
 MappedRegion mapFile(File const& file) {
   return mapFile(file, file.getFileSize());
 }
 
+MappedRegion mapFileReadOnly(File const& file) {
+  auto region = tryMapFileReadOnly(file);
+  if (!region) {
+    throwError(region.error(), "mmap(...)");
+  }
+  return std::move(region).value();
+}
+
+MappedRegion mapFileMirrored(File const& file, std::size_t headerSize, std::size_t dataSize) {
+  auto region = tryMapFileMirrored(file, headerSize, dataSize);
+  if (!region) {
+    throwError(region.error(), "mmap(...)");
+  }
+  return std::move(region).value();
+}
+
 } // namespace turboq::detail
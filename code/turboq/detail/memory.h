@@ -5,13 +5,34 @@
 
 #include <turboq/File.h>
 #include <turboq/MappedRegion.h>
+#include <turboq/Result.h>
 
 namespace turboq::detail {
 
 /// Map file to memory
+Result<MappedRegion> tryMapFile(File const& file, std::size_t fileSize) noexcept;
+
+/// \overload
+Result<MappedRegion> tryMapFile(File const& file) noexcept;
+
+/// Map file to memory for reading only (any store faults)
+Result<MappedRegion> tryMapFileReadOnly(File const& file) noexcept;
+
+/// Map file header and data, then map data once more right after it, so ring
+/// data wrapping at the end is contiguous in memory. Header size is the page
+/// size of the file, data size is multiple of it.
+Result<MappedRegion> tryMapFileMirrored(File const& file, std::size_t headerSize, std::size_t dataSize) noexcept;
+
+/// \see tryMapFile. Throws on error.
 MappedRegion mapFile(File const& file, std::size_t fileSize);
 
 /// \overload
 MappedRegion mapFile(File const& file);
 
+/// \see tryMapFileReadOnly. Throws on error.
+MappedRegion mapFileReadOnly(File const& file);
+
+/// \see tryMapFileMirrored. Throws on error.
+MappedRegion mapFileMirrored(File const& file, std::size_t headerSize, std::size_t dataSize);
+
 } // namespace turboq::detail
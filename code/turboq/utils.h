@@ -33,6 +33,12 @@ TURBOQ_FORCE_INLINE bool dequeue(ConsumerT& consumer, DataT& data) {
     return false;
   }
   data = *std::bit_cast<DataT const*>(buffer.data());
+  if constexpr (requires { consumer.verify(); }) {
+    // data was overwritten while reading
+    if (!consumer.verify()) [[unlikely]] {
+      return false;
+    }
+  }
   consumer.consume();
   return true;
 }
@@ -45,6 +51,12 @@ TURBOQ_FORCE_INLINE bool fetch(ConsumerT& consumer, DataT& data) {
     return false;
   }
   data = *std::bit_cast<DataT const*>(buffer.data());
+  if constexpr (requires { consumer.verify(); }) {
+    // data was overwritten while reading
+    if (!consumer.verify()) [[unlikely]] {
+      return false;
+    }
+  }
   return true;
 }
 
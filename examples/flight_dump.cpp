@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include <turboq/FlightRecorder.h>
+
+namespace {
+
+char const* eventName(turboq::FlightEvent event) noexcept {
+  switch (event) {
+  case turboq::FlightEvent::Commit:
+    return "commit";
+  case turboq::FlightEvent::Consume:
+    return "consume";
+  case turboq::FlightEvent::Full:
+    return "full";
+  case turboq::FlightEvent::Empty:
+    return "empty";
+  case turboq::FlightEvent::Wrap:
+    return "wrap";
+  case turboq::FlightEvent::Trigger:
+    return "trigger";
+  }
+  return "unknown";
+}
+
+} // namespace
+
+/// Dump flight recorder: flight_dump <name> [--wait-trigger]
+int main(int argc, char* argv[]) {
+  try {
+    char const* recorderName = "turboq.flight";
+    bool waitTrigger = false;
+    for (int i = 1; i < argc; ++i) {
+      if (std::strcmp(argv[i], "--wait-trigger") == 0) {
+        waitTrigger = true;
+      } else {
+        recorderName = argv[i];
+      }
+    }
+
+    turboq::FlightRecorderReader reader(recorderName);
+
+    if (waitTrigger) {
+      auto const triggerCount = reader.triggerCount();
+      while (reader.triggerCount() == triggerCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+    auto const records = reader.snapshot();
+    auto const baseTsc = records.empty() ? 0 : records.back().tsc;
+    for (auto const& record : records) {
+      fmt::print("{:>16} {:<8} pos={} peer={}\n", std::int64_t(record.tsc - baseTsc), eventName(record.event),
+          record.position, record.peerPosition);
+    }
+  } catch (std::exception const& e) {
+    fmt::print(stderr, "ERROR: {}\n", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}